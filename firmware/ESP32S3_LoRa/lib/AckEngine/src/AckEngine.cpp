@@ -0,0 +1,197 @@
+#include "AckEngine.h"
+#include "SnipsRadio.h"
+#include "DutyCycle.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct AckNeighbor {
+  bool used;
+  uint8_t addr;
+  uint8_t frame[ACK_ENGINE_FRAME_LEN];
+};
+
+static AckNeighbor neighbors[ACK_ENGINE_MAX_NEIGHBORS];
+static uint8_t selfAddress = 0;
+
+static SemaphoreHandle_t ackSignal = nullptr;
+static volatile uint8_t expectedNeighbor = SNIPS_ADDR_BROADCAST;
+static volatile uint8_t expectedSeq = 0;
+static volatile bool expecting = false;
+
+static AckEngineStats stats;
+
+// ============================================================================
+// FAST PATH (radio task, radio lock held)
+// ============================================================================
+
+// Built from the current config on every use: configureLora may change it.
+static void ackPktParams(sx126x_pkt_params_lora_t* pkt) {
+  *pkt = SnipsRadio_loraConfig()->pkt;
+  pkt->header_type = SX126X_LORA_PKT_EXPLICIT;
+  pkt->pld_len_in_bytes = ACK_ENGINE_FRAME_LEN;
+  pkt->crc_is_on = true;
+}
+
+static AckNeighbor* findNeighbor(uint8_t addr) {
+  for (uint8_t i = 0; i < ACK_ENGINE_MAX_NEIGHBORS; i++) {
+    if (neighbors[i].used && neighbors[i].addr == addr) {
+      return &neighbors[i];
+    }
+  }
+  return nullptr;
+}
+
+static void sendAck(const SnipsRxPacket* pkt) {
+  AckNeighbor* neighbor = findNeighbor(pkt->data[SNIPS_FRAME_OFFSET_PREV_HOP]);
+  if (neighbor == nullptr) {
+    stats.acksUnknownNeighbor++;
+    return;
+  }
+
+  neighbor->frame[SNIPS_FRAME_OFFSET_SEQ] = pkt->data[SNIPS_FRAME_OFFSET_SEQ];
+  neighbor->frame[SNIPS_FRAME_HEADER_LEN] = (uint8_t) pkt->status.rssi_pkt_in_dbm;
+  neighbor->frame[SNIPS_FRAME_HEADER_LEN + 1] = (uint8_t) pkt->status.snr_pkt_in_db;
+
+  sx126x_pkt_params_lora_t params;
+  ackPktParams(&params);
+  const void* ctx = SnipsRadio_context();
+  bool ok = sx126x_write_buffer(ctx, SNIPS_RADIO_TX_BASE, neighbor->frame, ACK_ENGINE_FRAME_LEN) ==
+            SX126X_STATUS_OK;
+  ok = ok && sx126x_set_lora_pkt_params(ctx, &params) == SX126X_STATUS_OK;
+  SnipsRadio_notePktParams();
+  ok = ok && sx126x_set_tx(ctx, 0) == SX126X_STATUS_OK;
+  if (!ok) {
+    stats.acksFailed++;
+    return;
+  }
+
+  // ACKs are never held back, only accounted
+  DutyCycle_charge(SnipsRadio_frequencyHz(), DutyCycle_loraAirUs(&params, &SnipsRadio_loraConfig()->mod));
+
+  uint32_t turnaround = micros() - pkt->dio1Us;
+  stats.lastTurnaroundUs = turnaround;
+  if (turnaround > stats.maxTurnaroundUs) {
+    stats.maxTurnaroundUs = turnaround;
+  }
+  stats.acksSent++;
+}
+
+static bool onRxDone(const SnipsRxPacket* pkt) {
+  if (pkt->len < SNIPS_FRAME_HEADER_LEN || pkt->data[0] != SNIPS_NETWORK_ID ||
+      pkt->data[SNIPS_FRAME_OFFSET_NEXT_HOP] != selfAddress) {
+    return false;
+  }
+
+  uint8_t type = SnipsFrame_type(pkt->data);
+
+  if (type == SNIPS_FRAME_DATA && (pkt->data[SNIPS_FRAME_OFFSET_FLAGS] & SNIPS_FLAG_ACK_REQ)) {
+    sendAck(pkt);
+    return false;
+  }
+
+  if (type == SNIPS_FRAME_ACK) {
+    if (expecting && pkt->data[SNIPS_FRAME_OFFSET_PREV_HOP] == expectedNeighbor &&
+        pkt->data[SNIPS_FRAME_OFFSET_SEQ] == expectedSeq) {
+      expecting = false;
+      stats.acksReceived++;
+      xSemaphoreGive(ackSignal);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool AckEngine_begin(uint8_t selfAddr) {
+  selfAddress = selfAddr;
+  memset(neighbors, 0, sizeof(neighbors));
+  memset(&stats, 0, sizeof(stats));
+
+  ackSignal = xSemaphoreCreateBinary();
+  if (ackSignal == nullptr) {
+    return false;
+  }
+
+  // Keep the synthesizer running between RX_DONE and the ACK TX (and between
+  // TX_DONE and the next RX). Costs a few mA over STDBY_RC while idle.
+  SnipsRadio_lock();
+  bool ok = sx126x_set_rx_tx_fallback_mode(SnipsRadio_context(), SX126X_FALLBACK_FS) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+
+  return ok && SnipsRadio_addRxHook(onRxDone);
+}
+
+bool AckEngine_addNeighbor(uint8_t addr) {
+  AckNeighbor* slot = findNeighbor(addr);
+  for (uint8_t i = 0; i < ACK_ENGINE_MAX_NEIGHBORS && slot == nullptr; i++) {
+    if (!neighbors[i].used) {
+      slot = &neighbors[i];
+    }
+  }
+  if (slot == nullptr) {
+    return false;
+  }
+
+  SnipsFrameHeader header;
+  header.netId = SNIPS_NETWORK_ID;
+  header.type = SNIPS_FRAME_ACK;
+  header.trafficClass = SNIPS_CLASS_MANAGEMENT;
+  header.flags = 0;
+  header.src = selfAddress;
+  header.dst = addr;
+  header.prevHop = selfAddress;
+  header.nextHop = addr;
+  header.seq = 0;
+  header.hops = 0;
+
+  SnipsRadio_lock();
+  SnipsFrame_encodeHeader(&header, slot->frame);
+  slot->frame[SNIPS_FRAME_HEADER_LEN] = 0;
+  slot->frame[SNIPS_FRAME_HEADER_LEN + 1] = 0;
+  slot->addr = addr;
+  slot->used = true;
+  SnipsRadio_unlock();
+
+  return true;
+}
+
+void AckEngine_removeNeighbor(uint8_t addr) {
+  SnipsRadio_lock();
+  AckNeighbor* slot = findNeighbor(addr);
+  if (slot != nullptr) {
+    slot->used = false;
+  }
+  SnipsRadio_unlock();
+}
+
+void AckEngine_expect(uint8_t neighbor, uint8_t seq) {
+  xSemaphoreTake(ackSignal, 0);
+  expectedNeighbor = neighbor;
+  expectedSeq = seq;
+  expecting = true;
+}
+
+bool AckEngine_waitAck(uint32_t timeoutMs) {
+  bool acked = xSemaphoreTake(ackSignal, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+  expecting = false;
+  return acked;
+}
+
+uint32_t AckEngine_ackTimeoutMs() {
+  sx126x_pkt_params_lora_t pkt;
+  ackPktParams(&pkt);
+  return sx126x_get_lora_time_on_air_in_ms(&pkt, &SnipsRadio_loraConfig()->mod) +
+         ACK_ENGINE_TURNAROUND_GUARD_MS;
+}
+
+void AckEngine_getStats(AckEngineStats* out) {
+  SnipsRadio_lock();
+  *out = stats;
+  SnipsRadio_unlock();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <Arduino.h>
+#include "SnipsFrame.h"
+
+// ============================================================================
+// HARDWARE-TIMED ACK ENGINE
+// ============================================================================
+//
+// ACK frames are built once per neighbor. When a DATA frame with
+// SNIPS_FLAG_ACK_REQ arrives for this node, the radio task patches the
+// sequence number and link feedback into the prebuilt frame and starts the
+// transmission straight from the DIO1 handler, before the packet is even
+// queued for the application. The radio falls back to FS after RX/TX so the
+// PLL is still locked when the ACK goes out.
+//
+// ACK payload: RSSI (int8, dBm) and SNR (int8, dB) of the acknowledged frame.
+//
+
+#ifndef ACK_ENGINE_MAX_NEIGHBORS
+#define ACK_ENGINE_MAX_NEIGHBORS 16
+#endif
+
+#define ACK_ENGINE_FRAME_LEN     (SNIPS_FRAME_HEADER_LEN + 2)
+
+// Margin for the receiver's harvest + SPI writes + PA ramp before the ACK's
+// first preamble symbol leaves the antenna.
+#define ACK_ENGINE_TURNAROUND_GUARD_MS 2
+
+struct AckEngineStats {
+  uint32_t acksSent;
+  uint32_t acksReceived;
+  uint32_t acksUnknownNeighbor;
+  uint32_t acksFailed;         // ACK TX could not be started
+  uint32_t lastTurnaroundUs;
+  uint32_t maxTurnaroundUs;
+};
+
+bool AckEngine_begin(uint8_t selfAddr);
+
+bool AckEngine_addNeighbor(uint8_t addr);
+void AckEngine_removeNeighbor(uint8_t addr);
+
+// Sender side: arm the engine before transmitting a frame with ACK_REQ, then
+// wait for the matching ACK.
+void AckEngine_expect(uint8_t neighbor, uint8_t seq);
+bool AckEngine_waitAck(uint32_t timeoutMs);
+
+// Time on air of an ACK plus the receiver turnaround guard.
+uint32_t AckEngine_ackTimeoutMs();
+
+void AckEngine_getStats(AckEngineStats* stats);
@@ -0,0 +1,176 @@
+#include "Aggregator.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct HopBuffer {
+  bool used;
+  uint8_t nextHop;
+  uint8_t frames;
+  uint8_t len;               // bytes after the outer header
+  uint32_t oldestMs;
+  uint8_t data[SNIPS_FRAME_MAX_PAYLOAD];
+};
+
+static HopBuffer buffers[AGGREGATOR_MAX_HOPS];
+static uint8_t selfAddr = 0;
+static uint8_t aggregateSeq = 0;
+static AggregatorStats stats;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static HopBuffer* bufferFor(uint8_t nextHop) {
+  HopBuffer* free = nullptr;
+  for (uint8_t i = 0; i < AGGREGATOR_MAX_HOPS; i++) {
+    if (buffers[i].used && buffers[i].nextHop == nextHop) {
+      return &buffers[i];
+    }
+    if (!buffers[i].used && free == nullptr) {
+      free = &buffers[i];
+    }
+  }
+  return free;
+}
+
+static uint8_t emit(HopBuffer* b, uint8_t* out, uint32_t nowMs) {
+  uint8_t len;
+  if (b->frames == 1) {
+    // Single frame: drop the wrapper and its record length
+    len = b->data[0];
+    memcpy(out, &b->data[1], len);
+  } else {
+    SnipsFrameHeader header = {};
+    header.netId = SNIPS_NETWORK_ID;
+    header.type = SNIPS_FRAME_AGGREGATE;
+    header.trafficClass = SNIPS_CLASS_DATA;
+    header.src = selfAddr;
+    header.dst = b->nextHop;
+    header.prevHop = selfAddr;
+    header.nextHop = b->nextHop;
+    header.seq = aggregateSeq++;
+    SnipsFrame_encodeHeader(&header, out);
+    memcpy(out + SNIPS_FRAME_HEADER_LEN, b->data, b->len);
+    len = SNIPS_FRAME_HEADER_LEN + b->len;
+    stats.aggregatesOut++;
+  }
+
+  uint32_t held = nowMs - b->oldestMs;
+  if (held > stats.maxHoldMs) {
+    stats.maxHoldMs = held;
+  }
+  stats.packetsOut++;
+  b->used = false;
+  return len;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void Aggregator_begin(uint8_t selfAddress) {
+  memset(buffers, 0, sizeof(buffers));
+  memset(&stats, 0, sizeof(stats));
+  selfAddr = selfAddress;
+}
+
+bool Aggregator_add(uint8_t nextHop, const uint8_t* frame, uint8_t len, uint32_t nowMs) {
+  if (len < SNIPS_FRAME_HEADER_LEN || len + 1 > SNIPS_FRAME_MAX_PAYLOAD) {
+    return false;
+  }
+
+  HopBuffer* b = bufferFor(nextHop);
+  if (b == nullptr || (b->used && (b->len + 1 + len > SNIPS_FRAME_MAX_PAYLOAD || b->frames >= AGGREGATOR_MAX_FRAMES))) {
+    return false;
+  }
+
+  if (!b->used) {
+    b->used = true;
+    b->nextHop = nextHop;
+    b->frames = 0;
+    b->len = 0;
+    b->oldestMs = nowMs;
+  }
+
+  b->data[b->len] = len;
+  memcpy(&b->data[b->len + 1], frame, len);
+  b->len += 1 + len;
+  b->frames++;
+  stats.framesIn++;
+  return true;
+}
+
+uint8_t Aggregator_poll(uint32_t nowMs, uint8_t* out) {
+  for (uint8_t i = 0; i < AGGREGATOR_MAX_HOPS; i++) {
+    HopBuffer* b = &buffers[i];
+    if (!b->used) {
+      continue;
+    }
+    // Due: latency bound reached, or no room for another minimal frame
+    bool full = b->frames >= AGGREGATOR_MAX_FRAMES ||
+                b->len + 1 + SNIPS_FRAME_HEADER_LEN > SNIPS_FRAME_MAX_PAYLOAD;
+    if (full || nowMs - b->oldestMs >= AGGREGATOR_MAX_HOLD_MS) {
+      return emit(b, out, nowMs);
+    }
+  }
+  return 0;
+}
+
+uint8_t Aggregator_flush(uint32_t nowMs, uint8_t* out) {
+  HopBuffer* fullest = nullptr;
+  for (uint8_t i = 0; i < AGGREGATOR_MAX_HOPS; i++) {
+    if (buffers[i].used && (fullest == nullptr || buffers[i].len > fullest->len)) {
+      fullest = &buffers[i];
+    }
+  }
+  return fullest != nullptr ? emit(fullest, out, nowMs) : 0;
+}
+
+uint8_t Aggregator_flushHop(uint8_t nextHop, uint32_t nowMs, uint8_t* out) {
+  for (uint8_t i = 0; i < AGGREGATOR_MAX_HOPS; i++) {
+    if (buffers[i].used && buffers[i].nextHop == nextHop) {
+      return emit(&buffers[i], out, nowMs);
+    }
+  }
+  return 0;
+}
+
+uint32_t Aggregator_nextDueMs(uint32_t nowMs) {
+  uint32_t due = 0xFFFFFFFF;
+  for (uint8_t i = 0; i < AGGREGATOR_MAX_HOPS; i++) {
+    if (!buffers[i].used) {
+      continue;
+    }
+    uint32_t age = nowMs - buffers[i].oldestMs;
+    uint32_t left = age >= AGGREGATOR_MAX_HOLD_MS ? 0 : AGGREGATOR_MAX_HOLD_MS - age;
+    if (left < due) {
+      due = left;
+    }
+  }
+  return due;
+}
+
+bool Aggregator_next(const uint8_t* packet, uint8_t len, uint8_t* offset, const uint8_t** frame,
+                     uint8_t* frameLen) {
+  uint16_t pos = *offset < SNIPS_FRAME_HEADER_LEN ? SNIPS_FRAME_HEADER_LEN : *offset;
+  if (pos >= len) {
+    return false;
+  }
+
+  uint8_t recordLen = packet[pos];
+  if (recordLen < SNIPS_FRAME_HEADER_LEN || pos + 1 + recordLen > len) {
+    return false;
+  }
+
+  *frame = &packet[pos + 1];
+  *frameLen = recordLen;
+  *offset = pos + 1 + recordLen;
+  return true;
+}
+
+void Aggregator_getStats(AggregatorStats* out) {
+  *out = stats;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include "SnipsFrame.h"
+
+// ============================================================================
+// RELAY PACKET AGGREGATION
+// ============================================================================
+//
+// Small frames bound for the same next hop are packed into one LoRa packet
+// so the preamble, sync and PHY header (preamble_len_in_symb + 12 symbols
+// in the ToA numerator) are paid once:
+//
+//  SNIPS header (type AGGREGATE, prevHop = relay, nextHop = next hop)
+//  { len, frame[len] } x n        (each frame keeps its own SNIPS header)
+//
+// A frame is held at most AGGREGATOR_MAX_HOLD_MS. A buffer is flushed when
+// its oldest frame reaches that bound, when the next frame would not fit in
+// 255 bytes, or when it holds AGGREGATOR_MAX_FRAMES. A buffer holding a
+// single frame is sent unwrapped. Call from the relay task only.
+//
+
+#ifndef AGGREGATOR_MAX_HOPS
+#define AGGREGATOR_MAX_HOPS     4
+#endif
+
+#ifndef AGGREGATOR_MAX_FRAMES
+#define AGGREGATOR_MAX_FRAMES   12
+#endif
+
+#ifndef AGGREGATOR_MAX_HOLD_MS
+#define AGGREGATOR_MAX_HOLD_MS  500
+#endif
+
+struct AggregatorStats {
+  uint32_t framesIn;
+  uint32_t packetsOut;
+  uint32_t aggregatesOut;    // packets carrying more than one frame
+  uint32_t maxHoldMs;
+};
+
+void Aggregator_begin(uint8_t selfAddress);
+
+// Queues a frame for nextHop. Returns false if the frame does not fit the
+// hop's buffer (flush it with Aggregator_flushHop and retry, so the hop's
+// frames stay in order), if no buffer is free for a new next hop, or if
+// the frame is malformed.
+bool Aggregator_add(uint8_t nextHop, const uint8_t* frame, uint8_t len, uint32_t nowMs);
+
+// Fills out (SNIPS_FRAME_MAX_LEN bytes) with the next packet that is due
+// at nowMs. Returns its length, or 0 if nothing is due.
+uint8_t Aggregator_poll(uint32_t nowMs, uint8_t* out);
+
+// Like poll, but flush a buffer regardless of age: the fullest one (e.g. the
+// relay's slot has come and there is time on air to spare) or nextHop's.
+uint8_t Aggregator_flush(uint32_t nowMs, uint8_t* out);
+uint8_t Aggregator_flushHop(uint8_t nextHop, uint32_t nowMs, uint8_t* out);
+
+// Milliseconds until the next buffer falls due, or 0xFFFFFFFF if empty.
+uint32_t Aggregator_nextDueMs(uint32_t nowMs);
+
+// Receiver side, zero copy: walks the frames of an AGGREGATE packet.
+// Start with *offset = 0; returns false at the end or on a malformed record.
+bool Aggregator_next(const uint8_t* packet, uint8_t len, uint8_t* offset, const uint8_t** frame,
+                     uint8_t* frameLen);
+
+void Aggregator_getStats(AggregatorStats* stats);
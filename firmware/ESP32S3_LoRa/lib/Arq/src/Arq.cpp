@@ -0,0 +1,263 @@
+#include "Arq.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct ArqLink {
+  uint8_t neighbor;
+  ArqSender sender;
+  ArqReceiver receiver;
+  bool used;
+};
+
+static ArqLink links[ARQ_MAX_LINKS];
+static ArqStats stats;
+static uint8_t self = 0;
+static uint8_t ackSeq = 0;
+
+// ============================================================================
+// SENDER
+// ============================================================================
+
+void ArqSender_init(ArqSender* sender) {
+  memset(sender, 0, sizeof(*sender));
+}
+
+bool ArqSender_queue(ArqSender* sender, const uint8_t* frame, uint8_t len, ArqStats* st) {
+  if ((uint8_t) (sender->nextSeq - sender->base) >= ARQ_WINDOW || len < SNIPS_FRAME_HEADER_LEN) {
+    return false;
+  }
+  ArqSlot& slot = sender->slots[sender->nextSeq % ARQ_WINDOW];
+  memcpy(slot.frame, frame, len);
+  slot.frame[SNIPS_FRAME_OFFSET_SEQ] = sender->nextSeq;
+  slot.len = len;
+  slot.retries = 0;
+  slot.used = true;
+  slot.sent = false;
+  sender->nextSeq++;
+  st->queued++;
+  return true;
+}
+
+static void advanceBase(ArqSender* sender) {
+  while (sender->base != sender->nextSeq && !sender->slots[sender->base % ARQ_WINDOW].used) {
+    sender->base++;
+  }
+}
+
+uint8_t ArqSender_next(ArqSender* sender, uint32_t superframe, uint8_t* out, ArqStats* st) {
+  ArqSlot* fresh = nullptr;
+  for (uint8_t seq = sender->base; seq != sender->nextSeq; seq++) {
+    ArqSlot& slot = sender->slots[seq % ARQ_WINDOW];
+    if (!slot.used) {
+      continue;
+    }
+    if (!slot.sent) {
+      if (fresh == nullptr) {
+        fresh = &slot;
+      }
+      continue;
+    }
+    if (superframe - slot.sentSuperframe < ARQ_RTO_SUPERFRAMES) {
+      continue;
+    }
+    if (slot.retries >= ARQ_MAX_RETRIES) {
+      slot.used = false;
+      st->dropped++;
+      continue;
+    }
+
+    // Oldest due retransmission goes first
+    slot.retries++;
+    slot.sentSuperframe = superframe;
+    st->retransmitted++;
+    memcpy(out, slot.frame, slot.len);
+    advanceBase(sender);
+    return slot.len;
+  }
+  advanceBase(sender);
+
+  if (fresh == nullptr) {
+    return 0;
+  }
+  fresh->sent = true;
+  fresh->sentSuperframe = superframe;
+  st->sent++;
+  memcpy(out, fresh->frame, fresh->len);
+  return fresh->len;
+}
+
+void ArqSender_onAck(ArqSender* sender, const uint8_t* ack, ArqStats* st) {
+  uint8_t base = ack[0];
+  uint16_t bitmap = ack[1] | (ack[2] << 8);
+
+  for (uint8_t seq = sender->base; seq != sender->nextSeq; seq++) {
+    ArqSlot& slot = sender->slots[seq % ARQ_WINDOW];
+    if (!slot.used || !slot.sent) {
+      continue;
+    }
+    uint8_t d = (uint8_t) (seq - base);
+    if (d >= 0x80 || (d >= 1 && d <= ARQ_WINDOW && (bitmap & (1u << (d - 1))))) {
+      slot.used = false;
+      st->acked++;
+    }
+  }
+  advanceBase(sender);
+}
+
+uint8_t ArqSender_inFlight(const ArqSender* sender) {
+  return (uint8_t) (sender->nextSeq - sender->base);
+}
+
+// ============================================================================
+// RECEIVER
+// ============================================================================
+
+void ArqReceiver_init(ArqReceiver* receiver) {
+  memset(receiver, 0, sizeof(*receiver));
+}
+
+bool ArqReceiver_accept(ArqReceiver* receiver, uint8_t seq, ArqStats* st) {
+  receiver->ackPending = true;
+  uint8_t offset = (uint8_t) (seq - receiver->base);
+  if (offset >= 0x80) {
+    st->duplicates++;
+    return false;
+  }
+
+  // The sender never runs ARQ_WINDOW ahead of its own base, so a frame that
+  // far ahead means it gave up on our base: slide past the gap.
+  if (offset >= ARQ_WINDOW) {
+    uint8_t shift = offset - (ARQ_WINDOW - 1);
+    receiver->received = shift < 32 ? receiver->received >> shift : 0;
+    receiver->base += shift;
+    offset = ARQ_WINDOW - 1;
+  }
+
+  if (receiver->received & (1u << offset)) {
+    st->duplicates++;
+    return false;
+  }
+  receiver->received |= 1u << offset;
+  while (receiver->received & 1) {
+    receiver->received >>= 1;
+    receiver->base++;
+  }
+  st->delivered++;
+  return true;
+}
+
+void ArqReceiver_encodeAck(ArqReceiver* receiver, uint8_t* ack) {
+  uint16_t bitmap = (uint16_t) (receiver->received >> 1);
+  ack[0] = receiver->base;
+  ack[1] = bitmap & 0xFF;
+  ack[2] = bitmap >> 8;
+  receiver->ackPending = false;
+}
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static ArqLink* findLink(uint8_t neighbor) {
+  for (uint8_t i = 0; i < ARQ_MAX_LINKS; i++) {
+    if (links[i].used && links[i].neighbor == neighbor) {
+      return &links[i];
+    }
+  }
+  return nullptr;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void Arq_begin(uint8_t selfAddress) {
+  memset(links, 0, sizeof(links));
+  memset(&stats, 0, sizeof(stats));
+  self = selfAddress;
+}
+
+bool Arq_addLink(uint8_t neighbor) {
+  if (findLink(neighbor) != nullptr) {
+    return true;
+  }
+  for (uint8_t i = 0; i < ARQ_MAX_LINKS; i++) {
+    if (!links[i].used) {
+      links[i].used = true;
+      links[i].neighbor = neighbor;
+      ArqSender_init(&links[i].sender);
+      ArqReceiver_init(&links[i].receiver);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Arq_send(uint8_t neighbor, const uint8_t* frame, uint8_t len) {
+  ArqLink* link = findLink(neighbor);
+  return link != nullptr && ArqSender_queue(&link->sender, frame, len, &stats);
+}
+
+uint8_t Arq_nextFrame(uint8_t neighbor, uint32_t superframe, uint8_t* out) {
+  ArqLink* link = findLink(neighbor);
+  if (link == nullptr) {
+    return 0;
+  }
+  uint8_t len = ArqSender_next(&link->sender, superframe, out, &stats);
+  if (len != 0 && link->receiver.ackPending && len + ARQ_ACK_LEN <= SNIPS_FRAME_MAX_LEN) {
+    ArqReceiver_encodeAck(&link->receiver, out + len);
+    out[SNIPS_FRAME_OFFSET_FLAGS] |= SNIPS_FLAG_BLOCK_ACK;
+    len += ARQ_ACK_LEN;
+    stats.acksPiggybacked++;
+  }
+  return len;
+}
+
+uint8_t Arq_buildAck(uint8_t neighbor, uint8_t* out) {
+  ArqLink* link = findLink(neighbor);
+  if (link == nullptr || !link->receiver.ackPending) {
+    return 0;
+  }
+
+  SnipsFrameHeader header = {};
+  header.netId = SNIPS_NETWORK_ID;
+  header.type = SNIPS_FRAME_BLOCK_ACK;
+  header.trafficClass = SNIPS_CLASS_MANAGEMENT;
+  header.flags = SNIPS_FLAG_BLOCK_ACK;
+  header.src = self;
+  header.dst = neighbor;
+  header.prevHop = self;
+  header.nextHop = neighbor;
+  header.seq = ackSeq++;
+  SnipsFrame_encodeHeader(&header, out);
+  ArqReceiver_encodeAck(&link->receiver, out + SNIPS_FRAME_HEADER_LEN);
+  stats.acksStandalone++;
+  return SNIPS_FRAME_HEADER_LEN + ARQ_ACK_LEN;
+}
+
+bool Arq_onFrame(uint8_t* frame, uint8_t* len) {
+  if (*len < SNIPS_FRAME_HEADER_LEN || frame[SNIPS_FRAME_OFFSET_NEXT_HOP] != self) {
+    return false;
+  }
+  ArqLink* link = findLink(frame[SNIPS_FRAME_OFFSET_PREV_HOP]);
+  if (link == nullptr) {
+    return false;
+  }
+
+  if ((frame[SNIPS_FRAME_OFFSET_FLAGS] & SNIPS_FLAG_BLOCK_ACK) && *len >= SNIPS_FRAME_HEADER_LEN + ARQ_ACK_LEN) {
+    *len -= ARQ_ACK_LEN;
+    ArqSender_onAck(&link->sender, frame + *len, &stats);
+    frame[SNIPS_FRAME_OFFSET_FLAGS] &= ~SNIPS_FLAG_BLOCK_ACK;
+  }
+  if (SnipsFrame_type(frame) != SNIPS_FRAME_DATA) {
+    return false;
+  }
+  return ArqReceiver_accept(&link->receiver, frame[SNIPS_FRAME_OFFSET_SEQ], &stats);
+}
+
+void Arq_getStats(ArqStats* out) {
+  *out = stats;
+}
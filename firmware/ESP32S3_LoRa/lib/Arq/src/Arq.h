@@ -0,0 +1,122 @@
+#pragma once
+#include <stdint.h>
+#include "SnipsFrame.h"
+
+// ============================================================================
+// SELECTIVE-REPEAT ARQ WITH BLOCK ACKS
+// ============================================================================
+//
+// Data-phase frames to a neighbor are numbered per link (the SNIPS sequence
+// byte) and kept in a window of ARQ_WINDOW frames until acknowledged. The
+// receiver does not ACK each frame; once per superframe it answers with a
+// 3-byte block ACK:
+//
+//  byte 0    base: lowest sequence not yet received (all before it were)
+//  byte 1-2  bitmap, bit i = base + 1 + i received (little endian)
+//
+// The block ACK rides as a trailer on any frame going back to the sender
+// (SNIPS_FLAG_BLOCK_ACK), or as a standalone SNIPS_FRAME_BLOCK_ACK frame
+// when there is none. Time is counted in superframes, not milliseconds: the
+// peer's slot comes round within one superframe, so a frame still unacked
+// ARQ_RTO_SUPERFRAMES after it was sent is resent in the next slot. Only the
+// missing frames are resent; after ARQ_MAX_RETRIES a frame is dropped and
+// the receiver's window slides past it.
+//
+// Frames are delivered as they arrive (duplicates filtered), not
+// reordered: SNIPS payloads carry their own timestamps.
+//
+
+#define ARQ_WINDOW               16     // bitmap width
+#define ARQ_ACK_LEN              3
+
+#ifndef ARQ_RTO_SUPERFRAMES
+#define ARQ_RTO_SUPERFRAMES      2
+#endif
+
+#ifndef ARQ_MAX_RETRIES
+#define ARQ_MAX_RETRIES          4
+#endif
+
+#ifndef ARQ_MAX_LINKS
+#define ARQ_MAX_LINKS            4
+#endif
+
+struct ArqStats {
+  uint32_t queued;
+  uint32_t sent;
+  uint32_t retransmitted;
+  uint32_t acked;
+  uint32_t dropped;          // retries exhausted
+  uint32_t delivered;
+  uint32_t duplicates;
+  uint32_t acksPiggybacked;
+  uint32_t acksStandalone;
+};
+
+struct ArqSlot {
+  uint8_t frame[SNIPS_FRAME_MAX_LEN];
+  uint8_t len;
+  uint8_t retries;
+  uint32_t sentSuperframe;
+  bool used;
+  bool sent;
+};
+
+struct ArqSender {
+  ArqSlot slots[ARQ_WINDOW];
+  uint8_t base;              // oldest unacknowledged sequence
+  uint8_t nextSeq;
+};
+
+struct ArqReceiver {
+  uint8_t base;              // lowest sequence not yet received
+  uint32_t received;         // bit i = base + i
+  bool ackPending;
+};
+
+// ---------------------------------------------------------------------------
+// Per-link state machines
+// ---------------------------------------------------------------------------
+
+void ArqSender_init(ArqSender* sender);
+
+// Numbers the frame (writes its sequence byte) and keeps a copy. False if
+// the window is full.
+bool ArqSender_queue(ArqSender* sender, const uint8_t* frame, uint8_t len, ArqStats* stats);
+
+// Copies the next frame to put on air in this superframe into out:
+// retransmissions that are due first, then new frames. Returns its length,
+// or 0 if nothing is due.
+uint8_t ArqSender_next(ArqSender* sender, uint32_t superframe, uint8_t* out, ArqStats* stats);
+
+void ArqSender_onAck(ArqSender* sender, const uint8_t* ack, ArqStats* stats);
+uint8_t ArqSender_inFlight(const ArqSender* sender);
+
+void ArqReceiver_init(ArqReceiver* receiver);
+
+// Records seq; true if it is new.
+bool ArqReceiver_accept(ArqReceiver* receiver, uint8_t seq, ArqStats* stats);
+void ArqReceiver_encodeAck(ArqReceiver* receiver, uint8_t* ack);
+
+// ---------------------------------------------------------------------------
+// Node links
+// ---------------------------------------------------------------------------
+
+void Arq_begin(uint8_t selfAddress);
+bool Arq_addLink(uint8_t neighbor);
+
+bool Arq_send(uint8_t neighbor, const uint8_t* frame, uint8_t len);
+
+// Next frame for neighbor in this node's slot, with the pending block ACK
+// for that neighbor piggybacked if it fits.
+uint8_t Arq_nextFrame(uint8_t neighbor, uint32_t superframe, uint8_t* out);
+
+// Standalone block ACK for neighbor if one is still owed this superframe
+// (send it at the end of the slot). Returns its length, or 0.
+uint8_t Arq_buildAck(uint8_t neighbor, uint8_t* out);
+
+// Receive path: applies any block ACK, strips its trailer from *len and
+// returns true if the frame is new data to deliver.
+bool Arq_onFrame(uint8_t* frame, uint8_t* len);
+
+void Arq_getStats(ArqStats* stats);
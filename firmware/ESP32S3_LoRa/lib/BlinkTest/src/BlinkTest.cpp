@@ -15,7 +15,7 @@ static unsigned long messageCount = 0;
 void BlinkTest_setup() {
   Serial.begin(115200);
   // Allow a short delay for Serial initialization
-  delay(5000); // reduce to 100ms; 10s is too long for normal use
+  delay(100);
   pinMode(LED_BUILTIN, OUTPUT);
   digitalWrite(LED_BUILTIN, LOW);
 
@@ -0,0 +1,231 @@
+#include "BulkLink.h"
+#include "SnipsRadio.h"
+#include "DutyCycle.h"
+#include "EntropyPool.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct BulkPacket {
+  uint8_t len;
+  uint8_t data[BULK_MAX_PACKET_LEN];
+};
+
+static uint8_t self = 0;
+static BulkLinkStats stats;
+static QueueHandle_t rxQueue = nullptr;
+static SemaphoreHandle_t txDone = nullptr;
+static BulkPacket rxPacket;
+static uint8_t txBuf[BULK_MAX_PACKET_LEN];
+
+// ============================================================================
+// RADIO TASK HOOKS
+// ============================================================================
+
+static bool onGfskRx(const SnipsRxPacket* pkt) {
+  static BulkPacket copy;
+  copy.len = pkt->len;
+  memcpy(copy.data, pkt->data, pkt->len);
+  if (xQueueSend(rxQueue, &copy, 0) != pdTRUE) {
+    stats.rxDropped++;
+  }
+  return true;
+}
+
+static void onIrq(sx126x_irq_mask_t irq, uint32_t) {
+  if (SnipsRadio_isGfsk() && (irq & SX126X_IRQ_TX_DONE)) {
+    xSemaphoreGive(txDone);
+  }
+}
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t ackTimeoutMs() {
+  return BulkLink_packetAirUs(BULK_ACK_PACKET_LEN) / 1000 + 1 + BULK_LINK_TURNAROUND_MS;
+}
+
+// Transmits txBuf and waits for TX_DONE.
+static bool transmit(uint8_t len) {
+  uint32_t airMs = BulkLink_packetAirUs(len) / 1000 + 1;
+  xSemaphoreTake(txDone, 0);
+  if (!SnipsRadio_transmitGfsk(txBuf, len, airMs + 10)) {
+    stats.dutyRefused++;
+    return false;
+  }
+  return xSemaphoreTake(txDone, pdMS_TO_TICKS(airMs + 10)) == pdTRUE;
+}
+
+// The last TX left its own length as the RX maximum; restore the config.
+static bool listen(uint32_t timeoutMs) {
+  SnipsRadio_lock();
+  bool ok = SnipsRadio_restorePktParams();
+  ok &= sx126x_set_rx_with_timeout_in_rtc_step(SnipsRadio_context(),
+                                                   timeoutMs == 0 ? SX126X_RX_CONTINUOUS
+                                                                  : timeoutMs * 64) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+  return ok;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool BulkLink_begin(uint8_t selfAddress) {
+  self = selfAddress;
+  memset(&stats, 0, sizeof(stats));
+
+  rxQueue = xQueueCreate(BULK_LINK_RX_QUEUE_LEN, sizeof(BulkPacket));
+  txDone = xSemaphoreCreateBinary();
+  if (rxQueue == nullptr || txDone == nullptr) {
+    return false;
+  }
+  SnipsRadio_setGfskRxHook(onGfskRx);
+  return SnipsRadio_addIrqHook(onIrq);
+}
+
+bool BulkLink_enter(uint32_t freqHz) {
+  SnipsGfskConfig cfg = {};
+  cfg.freqHz = freqHz != 0 ? freqHz : SnipsRadio_loraConfig()->freqHz;
+  cfg.txPowerDbm = SnipsRadio_loraConfig()->txPowerDbm;
+  const uint8_t sync[] = { 0x53, 0x4E, 0x49, 0x50 };    // "SNIP"
+  memcpy(cfg.syncWord, sync, sizeof(sync));
+  cfg.syncWordLen = sizeof(sync);
+  cfg.nodeAddr = self;
+  cfg.broadcastAddr = BULK_LINK_BROADCAST;
+
+  cfg.mod.br_in_bps = BULK_LINK_BITRATE_BPS;
+  cfg.mod.fdev_in_hz = BULK_LINK_FDEV_HZ;
+  cfg.mod.pulse_shape = SX126X_GFSK_PULSE_SHAPE_BT_05;
+  cfg.mod.bw_dsb_param = BULK_LINK_RX_BW;
+
+  cfg.pkt.preamble_len_in_bits = BULK_LINK_PREAMBLE_BITS;
+  cfg.pkt.preamble_detector = SX126X_GFSK_PREAMBLE_DETECTOR_MIN_16BITS;
+  cfg.pkt.sync_word_len_in_bits = sizeof(sync) * 8;
+  cfg.pkt.address_filtering = SX126X_GFSK_ADDRESS_FILTERING_NODE_AND_BROADCAST_ADDRESSES;
+  cfg.pkt.header_type = SX126X_GFSK_PKT_VAR_LEN;
+  cfg.pkt.pld_len_in_bytes = BULK_MAX_PACKET_LEN;
+  cfg.pkt.crc_type = SX126X_GFSK_CRC_2_BYTES_INV;
+  cfg.pkt.dc_free = SX126X_GFSK_DC_FREE_WHITENING;
+
+  xQueueReset(rxQueue);
+  return SnipsRadio_configureGfsk(&cfg);
+}
+
+bool BulkLink_leave() {
+  return SnipsRadio_configureLora(SnipsRadio_loraConfig());
+}
+
+bool BulkLink_send(uint8_t peer, const uint8_t* data, uint32_t size, uint32_t timeoutMs) {
+  if (!SnipsRadio_isGfsk() || size > BULK_MAX_SIZE) {
+    return false;
+  }
+
+  BulkSender sender;
+  BulkSender_init(&sender, (uint8_t) EntropyPool_next(), size);
+  uint32_t start = millis();
+  uint8_t retries = 0;
+
+  while (!BulkSender_done(&sender)) {
+    if (millis() - start > timeoutMs || retries > BULK_LINK_MAX_RETRIES) {
+      return false;
+    }
+
+    bool poll = false;
+    int32_t index;
+    while ((index = BulkSender_next(&sender, &poll, &stats.transfer)) >= 0) {
+      const uint8_t* chunk = data + (uint32_t) index * BULK_CHUNK_LEN;
+      uint8_t len = BulkSender_encode(&sender, peer, self, index, poll, chunk, txBuf);
+      if (!transmit(len)) {
+        return false;
+      }
+    }
+
+    uint16_t before = sender.base;
+    bool acked = false;
+    listen(ackTimeoutMs());
+    uint32_t waitStart = millis();
+    while (!acked && millis() - waitStart <= ackTimeoutMs()) {
+      if (xQueueReceive(rxQueue, &rxPacket, pdMS_TO_TICKS(ackTimeoutMs())) == pdTRUE) {
+        acked = BulkSender_onAck(&sender, rxPacket.data, rxPacket.len, &stats.transfer);
+      }
+    }
+    if (!acked) {
+      BulkSender_onTimeout(&sender, &stats.transfer);
+    }
+    retries = acked && sender.base != before ? 0 : retries + 1;
+  }
+
+  stats.lastBytes = size;
+  stats.lastTransferMs = millis() - start;
+  return true;
+}
+
+int32_t BulkLink_receive(BulkLinkSink sink, uint32_t timeoutMs) {
+  if (!SnipsRadio_isGfsk()) {
+    return -1;
+  }
+
+  BulkReceiver receiver;
+  BulkReceiver_init(&receiver);
+  uint32_t start = millis();
+  uint32_t firstAt = 0;
+  uint32_t doneAt = 0;
+
+  listen(0);
+  while (millis() - start <= timeoutMs) {
+    if (BulkReceiver_done(&receiver) && millis() - doneAt >= BULK_LINK_LINGER_MS) {
+      break;
+    }
+    if (xQueueReceive(rxQueue, &rxPacket, pdMS_TO_TICKS(10)) != pdTRUE) {
+      continue;
+    }
+
+    bool wasDone = BulkReceiver_done(&receiver);
+    uint16_t index;
+    if (BulkReceiver_accept(&receiver, rxPacket.data, rxPacket.len, &index, &stats.transfer)) {
+      if (firstAt == 0) {
+        firstAt = millis();
+      }
+      uint32_t offset = (uint32_t) index * BULK_CHUNK_LEN;
+      if (!sink(offset, rxPacket.data + BULK_HEADER_LEN, rxPacket.len - BULK_HEADER_LEN)) {
+        return -1;
+      }
+      if (!wasDone && BulkReceiver_done(&receiver)) {
+        doneAt = millis();
+      }
+    }
+
+    if ((rxPacket.data[BULK_OFFSET_TYPE] & BULK_FLAG_POLL) && receiver.active) {
+      uint8_t len = BulkReceiver_encodeAck(&receiver, rxPacket.data[BULK_OFFSET_SRC], self, txBuf);
+      if (transmit(len)) {
+        stats.transfer.acksSent++;
+      }
+      listen(0);
+    }
+  }
+
+  if (!BulkReceiver_done(&receiver)) {
+    return -1;
+  }
+  stats.lastBytes = receiver.size;
+  stats.lastTransferMs = doneAt - firstAt;
+  return (int32_t) receiver.size;
+}
+
+uint32_t BulkLink_packetAirUs(uint8_t len) {
+  const SnipsGfskConfig* cfg = SnipsRadio_gfskConfig();
+  if (cfg->mod.br_in_bps == 0) {
+    return 0;
+  }
+  sx126x_pkt_params_gfsk_t pkt = cfg->pkt;
+  pkt.pld_len_in_bytes = len;
+  return DutyCycle_gfskAirUs(&pkt, &cfg->mod);
+}
+
+void BulkLink_getStats(BulkLinkStats* out) {
+  *out = stats;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#include "BulkTransfer.h"
+
+// ============================================================================
+// GFSK BULK BACKHAUL (ANCHOR TO ANCHOR)
+// ============================================================================
+//
+// Anchors move position logs and firmware images to each other in a
+// scheduled window with the modem switched to GFSK at BULK_LINK_BITRATE_BPS
+// (whitening, CCITT CRC and hardware address filtering on the first
+// payload byte), running the windowed transfer of BulkTransfer.h over it.
+// A full 255-byte packet is about 7 ms on air against about 400 ms at
+// LoRa SF7/125 kHz.
+//
+// Both ends call BulkLink_enter at the start of the window and
+// BulkLink_leave at its end; the LoRa configuration is restored on leave.
+// While in GFSK the LoRa hooks see no traffic and SnipsRadio_transmit is
+// refused. Airtime is charged to the DutyCycle governor like any other TX.
+//
+
+#ifndef BULK_LINK_BITRATE_BPS
+#define BULK_LINK_BITRATE_BPS     300000
+#endif
+
+// Carson bandwidth 2 * (fdev + br / 2) = 425 kHz fits the 467 kHz filter
+#ifndef BULK_LINK_FDEV_HZ
+#define BULK_LINK_FDEV_HZ         62500
+#endif
+
+#define BULK_LINK_RX_BW           SX126X_GFSK_BW_467000
+#define BULK_LINK_PREAMBLE_BITS   32
+#define BULK_LINK_BROADCAST       0xFF
+
+// Poll TX_DONE -> ACK on air at the receiver (task wakeup + SPI + PA ramp)
+#ifndef BULK_LINK_TURNAROUND_MS
+#define BULK_LINK_TURNAROUND_MS   4
+#endif
+
+#ifndef BULK_LINK_MAX_RETRIES
+#define BULK_LINK_MAX_RETRIES     8         // consecutive polls without progress
+#endif
+
+// The receiver keeps answering polls this long after the last chunk, in
+// case its final ACK was lost.
+#ifndef BULK_LINK_LINGER_MS
+#define BULK_LINK_LINGER_MS       100
+#endif
+
+#define BULK_LINK_RX_QUEUE_LEN    4
+
+struct BulkLinkStats {
+  BulkStats transfer;
+  uint32_t dutyRefused;
+  uint32_t rxDropped;        // RX queue full
+  uint32_t lastBytes;
+  uint32_t lastTransferMs;
+};
+
+// Receiver side: called for every new chunk, in arrival order (not
+// necessarily in offset order). Return false to abort the transfer.
+typedef bool (*BulkLinkSink)(uint32_t offset, const uint8_t* data, uint16_t len);
+
+bool BulkLink_begin(uint8_t selfAddress);
+
+// Switches the radio to GFSK on freqHz (0 keeps the LoRa carrier).
+bool BulkLink_enter(uint32_t freqHz);
+bool BulkLink_leave();
+
+// Blocks until every chunk is acknowledged, the peer stops answering or
+// timeoutMs elapses.
+bool BulkLink_send(uint8_t peer, const uint8_t* data, uint32_t size, uint32_t timeoutMs);
+
+// Blocks until one transfer has completed or timeoutMs elapses. Returns
+// the blob size, or -1.
+int32_t BulkLink_receive(BulkLinkSink sink, uint32_t timeoutMs);
+
+uint32_t BulkLink_packetAirUs(uint8_t len);
+
+void BulkLink_getStats(BulkLinkStats* stats);
@@ -0,0 +1,215 @@
+#include "BulkTransfer.h"
+#include <string.h>
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint16_t readLe16(const uint8_t* p) {
+  return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t readLe24(const uint8_t* p) {
+  return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16);
+}
+
+static uint32_t readLe32(const uint8_t* p) {
+  return readLe24(p) | ((uint32_t) p[3] << 24);
+}
+
+uint16_t BulkTransfer_chunkCount(uint32_t size) {
+  return (uint16_t) ((size + BULK_CHUNK_LEN - 1) / BULK_CHUNK_LEN);
+}
+
+uint16_t BulkTransfer_chunkLen(uint32_t size, uint16_t index) {
+  uint32_t offset = (uint32_t) index * BULK_CHUNK_LEN;
+  if (offset >= size) {
+    return 0;
+  }
+  return size - offset < BULK_CHUNK_LEN ? (uint16_t) (size - offset) : BULK_CHUNK_LEN;
+}
+
+// ============================================================================
+// SENDER
+// ============================================================================
+
+static bool isAcked(const BulkSender* sender, uint16_t index) {
+  return (sender->acked >> (index - sender->base)) & 1;
+}
+
+void BulkSender_init(BulkSender* sender, uint8_t xfer, uint32_t size) {
+  memset(sender, 0, sizeof(*sender));
+  sender->xfer = xfer;
+  sender->size = size;
+  sender->chunks = BulkTransfer_chunkCount(size);
+}
+
+int32_t BulkSender_next(BulkSender* sender, bool* poll, BulkStats* st) {
+  if (sender->burstDone || BulkSender_done(sender)) {
+    return -1;
+  }
+
+  uint32_t end = (uint32_t) sender->base + BULK_WINDOW;
+  if (end > sender->chunks) {
+    end = sender->chunks;
+  }
+  while (sender->cursor < end && isAcked(sender, sender->cursor)) {
+    sender->cursor++;
+  }
+  if (sender->cursor >= end) {
+    sender->burstDone = true;
+    return -1;
+  }
+
+  uint16_t index = sender->cursor++;
+  uint32_t following = sender->cursor;
+  while (following < end && isAcked(sender, following)) {
+    following++;
+  }
+  *poll = following >= end;
+  if (*poll) {
+    sender->burstDone = true;
+    st->polls++;
+  }
+
+  st->chunksSent++;
+  if (index < sender->sentUpTo) {
+    st->retransmitted++;
+  } else {
+    sender->sentUpTo = index + 1;
+  }
+  return index;
+}
+
+uint8_t BulkSender_encode(const BulkSender* sender, uint8_t dst, uint8_t src, uint16_t index, bool poll,
+                          const uint8_t* chunk, uint8_t* out) {
+  uint16_t len = BulkTransfer_chunkLen(sender->size, index);
+  out[BULK_OFFSET_DST] = dst;
+  out[BULK_OFFSET_SRC] = src;
+  out[BULK_OFFSET_TYPE] = BULK_TYPE_DATA | (poll ? BULK_FLAG_POLL : 0);
+  out[BULK_OFFSET_XFER] = sender->xfer;
+  out[4] = index & 0xFF;
+  out[5] = index >> 8;
+  out[6] = sender->size & 0xFF;
+  out[7] = (sender->size >> 8) & 0xFF;
+  out[8] = (sender->size >> 16) & 0xFF;
+  memcpy(out + BULK_HEADER_LEN, chunk, len);
+  return BULK_HEADER_LEN + len;
+}
+
+bool BulkSender_onAck(BulkSender* sender, const uint8_t* packet, uint8_t len, BulkStats* st) {
+  if (len < BULK_ACK_PACKET_LEN || (packet[BULK_OFFSET_TYPE] & BULK_TYPE_MASK) != BULK_TYPE_ACK ||
+      packet[BULK_OFFSET_XFER] != sender->xfer) {
+    return false;
+  }
+  uint16_t base = readLe16(packet + 4);
+  uint32_t bitmap = readLe32(packet + 6);
+  if (base > sender->chunks) {
+    base = sender->chunks;
+  }
+
+  // The receiver's base never goes back; anything older is a stale ACK
+  if (base >= sender->base) {
+    uint16_t shift = base - sender->base;
+    uint32_t kept = shift < 32 ? sender->acked >> shift : 0;
+    sender->acked = kept | (bitmap << 1);
+    sender->base = base;
+  }
+  sender->cursor = sender->base;
+  sender->burstDone = false;
+  st->acksReceived++;
+  return true;
+}
+
+void BulkSender_onTimeout(BulkSender* sender, BulkStats* st) {
+  // Re-poll with the last outstanding chunk only; the ACK it draws tells
+  // which of the others are still missing.
+  uint32_t last = (uint32_t) sender->base + BULK_WINDOW;
+  if (last > sender->chunks) {
+    last = sender->chunks;
+  }
+  while (last > sender->base && isAcked(sender, last - 1)) {
+    last--;
+  }
+  sender->cursor = last > sender->base ? last - 1 : sender->base;
+  sender->burstDone = false;
+  st->ackTimeouts++;
+}
+
+bool BulkSender_done(const BulkSender* sender) {
+  return sender->base >= sender->chunks;
+}
+
+// ============================================================================
+// RECEIVER
+// ============================================================================
+
+void BulkReceiver_init(BulkReceiver* receiver) {
+  memset(receiver, 0, sizeof(*receiver));
+}
+
+bool BulkReceiver_accept(BulkReceiver* receiver, const uint8_t* packet, uint8_t len, uint16_t* index,
+                         BulkStats* st) {
+  if (len < BULK_HEADER_LEN || (packet[BULK_OFFSET_TYPE] & BULK_TYPE_MASK) != BULK_TYPE_DATA) {
+    return false;
+  }
+  uint16_t idx = readLe16(packet + 4);
+  uint32_t size = readLe24(packet + 6);
+
+  if (!receiver->active || packet[BULK_OFFSET_XFER] != receiver->xfer || size != receiver->size) {
+    BulkReceiver_init(receiver);
+    receiver->active = true;
+    receiver->xfer = packet[BULK_OFFSET_XFER];
+    receiver->size = size;
+    receiver->chunks = BulkTransfer_chunkCount(size);
+  }
+  if (idx >= receiver->chunks || len - BULK_HEADER_LEN != BulkTransfer_chunkLen(size, idx)) {
+    return false;
+  }
+  if (idx < receiver->base) {
+    st->duplicates++;
+    return false;
+  }
+
+  uint16_t offset = idx - receiver->base;
+  if (offset == 0) {
+    // Slide past the new chunk and every chunk already held after it
+    bool have;
+    do {
+      receiver->base++;
+      have = receiver->received & 1;
+      receiver->received >>= 1;
+    } while (have);
+  } else if (offset <= 32) {
+    uint32_t bit = (uint32_t) 1 << (offset - 1);
+    if (receiver->received & bit) {
+      st->duplicates++;
+      return false;
+    }
+    receiver->received |= bit;
+  } else {
+    st->outOfWindow++;
+    return false;
+  }
+
+  st->delivered++;
+  *index = idx;
+  return true;
+}
+
+uint8_t BulkReceiver_encodeAck(const BulkReceiver* receiver, uint8_t dst, uint8_t src, uint8_t* out) {
+  out[BULK_OFFSET_DST] = dst;
+  out[BULK_OFFSET_SRC] = src;
+  out[BULK_OFFSET_TYPE] = BULK_TYPE_ACK;
+  out[BULK_OFFSET_XFER] = receiver->xfer;
+  out[4] = receiver->base & 0xFF;
+  out[5] = receiver->base >> 8;
+  for (uint8_t i = 0; i < 4; i++) {
+    out[6 + i] = (receiver->received >> (8 * i)) & 0xFF;
+  }
+  return BULK_ACK_PACKET_LEN;
+}
+
+bool BulkReceiver_done(const BulkReceiver* receiver) {
+  return receiver->active && receiver->base >= receiver->chunks;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// WINDOWED BULK TRANSFER
+// ============================================================================
+//
+// Streams a blob (position log, firmware image) over a point-to-point link
+// as numbered chunks. The sender puts every unacknowledged chunk of a
+// BULK_WINDOW-chunk window on air back to back and sets POLL on the last
+// one; the receiver answers the poll with one ACK:
+//
+//  byte 0-1  base: lowest chunk not yet received (all before it were), LE
+//  byte 2-5  bitmap, bit i = base + 1 + i received (little endian)
+//
+// The next burst starts at the new base, so the window slides by whatever
+// arrived and only the missing chunks go out again. A lost poll or ACK
+// costs one ACK timeout, after which only the last chunk is resent as a
+// new poll.
+//
+// Packets (the first byte is the destination, matched by the GFSK address
+// filter):
+//
+//  DATA  [dst][src][type | POLL][xfer][index LE16][size LE24][chunk ...]
+//  ACK   [dst][src][type][xfer][ack, 6 bytes]
+//
+
+#define BULK_MAX_PACKET_LEN    255
+#define BULK_HEADER_LEN        9
+#define BULK_CHUNK_LEN         (BULK_MAX_PACKET_LEN - BULK_HEADER_LEN)
+#define BULK_ACK_LEN           6
+#define BULK_ACK_PACKET_LEN    (4 + BULK_ACK_LEN)
+#define BULK_WINDOW            32
+#define BULK_MAX_SIZE          ((uint32_t) 0xFFFF * BULK_CHUNK_LEN)
+
+#define BULK_TYPE_DATA         0x01
+#define BULK_TYPE_ACK          0x02
+#define BULK_TYPE_MASK         0x0F
+#define BULK_FLAG_POLL         0x80
+
+#define BULK_OFFSET_DST        0
+#define BULK_OFFSET_SRC        1
+#define BULK_OFFSET_TYPE       2
+#define BULK_OFFSET_XFER       3
+
+struct BulkStats {
+  uint32_t chunksSent;
+  uint32_t retransmitted;
+  uint32_t polls;
+  uint32_t acksSent;
+  uint32_t acksReceived;
+  uint32_t ackTimeouts;
+  uint32_t delivered;
+  uint32_t duplicates;
+  uint32_t outOfWindow;
+};
+
+struct BulkSender {
+  uint32_t size;
+  uint16_t chunks;
+  uint16_t base;             // lowest unacknowledged chunk
+  uint32_t acked;            // bit i = base + i
+  uint16_t cursor;           // next chunk of the current burst
+  uint16_t sentUpTo;         // chunks below this were sent at least once
+  uint8_t xfer;
+  bool burstDone;
+};
+
+struct BulkReceiver {
+  uint32_t size;
+  uint16_t chunks;
+  uint16_t base;             // lowest chunk not yet received
+  uint32_t received;         // bit i = base + 1 + i
+  uint8_t xfer;
+  bool active;
+};
+
+uint16_t BulkTransfer_chunkCount(uint32_t size);
+uint16_t BulkTransfer_chunkLen(uint32_t size, uint16_t index);
+
+// ---------------------------------------------------------------------------
+// Sender
+// ---------------------------------------------------------------------------
+
+void BulkSender_init(BulkSender* sender, uint8_t xfer, uint32_t size);
+
+// Next chunk of the current burst, or -1 once the burst is out. *poll is
+// set on the last chunk of the burst.
+int32_t BulkSender_next(BulkSender* sender, bool* poll, BulkStats* stats);
+
+// Encodes DATA for index; chunk points at that chunk's bytes.
+uint8_t BulkSender_encode(const BulkSender* sender, uint8_t dst, uint8_t src, uint16_t index, bool poll,
+                          const uint8_t* chunk, uint8_t* out);
+
+// Applies an ACK packet and starts the next burst. False if the packet is
+// not an ACK for this transfer.
+bool BulkSender_onAck(BulkSender* sender, const uint8_t* packet, uint8_t len, BulkStats* stats);
+
+// No ACK for the poll: the next burst is the last outstanding chunk alone.
+void BulkSender_onTimeout(BulkSender* sender, BulkStats* stats);
+
+bool BulkSender_done(const BulkSender* sender);
+
+// ---------------------------------------------------------------------------
+// Receiver
+// ---------------------------------------------------------------------------
+
+void BulkReceiver_init(BulkReceiver* receiver);
+
+// Records a DATA packet; true (with *index) if its chunk is new. A packet
+// of another transfer restarts the receiver.
+bool BulkReceiver_accept(BulkReceiver* receiver, const uint8_t* packet, uint8_t len, uint16_t* index,
+                         BulkStats* stats);
+
+uint8_t BulkReceiver_encodeAck(const BulkReceiver* receiver, uint8_t dst, uint8_t src, uint8_t* out);
+
+bool BulkReceiver_done(const BulkReceiver* receiver);
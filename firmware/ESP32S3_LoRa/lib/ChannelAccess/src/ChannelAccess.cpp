@@ -0,0 +1,163 @@
+#include "ChannelAccess.h"
+#include "SnipsRadio.h"
+#include "EntropyPool.h"
+#include "DutyCycle.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static SemaphoreHandle_t cadSignal = nullptr;
+static volatile bool cadDetected = false;
+
+static int32_t busyEwma = 0;   // busy percent << 4
+static ChannelAccessStats stats;
+
+// ============================================================================
+// CAD PARAMETER TABLE
+// ============================================================================
+
+struct CadTuning {
+  sx126x_cad_symbs_t symbols;
+  uint8_t detectPeak;
+  uint8_t detectMin;
+};
+
+// Index: SF5..SF12
+static const CadTuning cadTuning[] = {
+  { SX126X_CAD_02_SYMB, 21, 10 },
+  { SX126X_CAD_02_SYMB, 21, 10 },
+  { SX126X_CAD_02_SYMB, 22, 10 },
+  { SX126X_CAD_02_SYMB, 22, 10 },
+  { SX126X_CAD_04_SYMB, 23, 10 },
+  { SX126X_CAD_04_SYMB, 24, 10 },
+  { SX126X_CAD_04_SYMB, 25, 10 },
+  { SX126X_CAD_08_SYMB, 28, 10 },
+};
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t symbolTimeUs(const sx126x_mod_params_lora_t* mod) {
+  return (uint32_t) (((uint64_t) 1000000 << mod->sf) / sx126x_get_lora_bw_in_hz(mod->bw));
+}
+
+static void onIrq(sx126x_irq_mask_t irq, uint32_t) {
+  if (irq & SX126X_IRQ_CAD_DONE) {
+    cadDetected = (irq & SX126X_IRQ_CAD_DETECTED) != 0;
+    xSemaphoreGive(cadSignal);
+  }
+}
+
+static void recordCad(bool busy) {
+  stats.cadRuns++;
+  if (busy) {
+    stats.cadBusy++;
+  }
+  busyEwma += ((busy ? (100 << 4) : 0) - busyEwma) >> 3;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool ChannelAccess_begin(uint8_t selfAddress) {
+  memset(&stats, 0, sizeof(stats));
+  busyEwma = 0;
+
+  EntropyPool_mixSeed(selfAddress);
+  if (!EntropyPool_seeded() && !EntropyPool_refill()) {
+    return false;
+  }
+
+  cadSignal = xSemaphoreCreateBinary();
+  return cadSignal != nullptr && SnipsRadio_addIrqHook(onIrq);
+}
+
+void ChannelAccess_cadParamsForSf(sx126x_lora_sf_t sf, sx126x_cad_params_t* params) {
+  const CadTuning& tuning = cadTuning[sf - SX126X_LORA_SF5];
+
+  params->cad_symb_nb = tuning.symbols;
+  params->cad_detect_peak = tuning.detectPeak;
+  params->cad_detect_min = tuning.detectMin;
+  params->cad_exit_mode = SX126X_CAD_ONLY;
+  params->cad_timeout = 0;
+}
+
+bool ChannelAccess_channelBusy(bool* ok) {
+  const sx126x_mod_params_lora_t* mod = &SnipsRadio_loraConfig()->mod;
+  sx126x_cad_params_t params;
+  ChannelAccess_cadParamsForSf(mod->sf, &params);
+
+  uint32_t cadUs = symbolTimeUs(mod) << params.cad_symb_nb;
+
+  xSemaphoreTake(cadSignal, 0);
+
+  SnipsRadio_lock();
+  *ok = sx126x_set_cad_params(SnipsRadio_context(), &params) == SX126X_STATUS_OK &&
+        sx126x_set_cad(SnipsRadio_context()) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+
+  if (!*ok || xSemaphoreTake(cadSignal, pdMS_TO_TICKS(cadUs / 1000 + 2)) != pdTRUE) {
+    *ok = false;
+    return true;
+  }
+
+  recordCad(cadDetected);
+  return cadDetected;
+}
+
+ChannelAccessResult ChannelAccess_transmit(const uint8_t* data, uint8_t len, uint32_t windowEndMs) {
+  const SnipsLoraConfig* cfg = SnipsRadio_loraConfig();
+  sx126x_pkt_params_lora_t pkt = cfg->pkt;
+  pkt.pld_len_in_bytes = len;
+  uint32_t airtimeMs = sx126x_get_lora_time_on_air_in_ms(&pkt, &cfg->mod);
+
+  // Checked up front so a refused frame does not burn CAD attempts
+  if (!DutyCycle_allows(SnipsRadio_frequencyHz(), DutyCycle_loraAirUs(&pkt, &cfg->mod))) {
+    return CHANNEL_ACCESS_DUTY_CYCLE;
+  }
+
+  sx126x_cad_params_t params;
+  ChannelAccess_cadParamsForSf(cfg->mod.sf, &params);
+  uint32_t backoffSlotMs = ((symbolTimeUs(&cfg->mod) << params.cad_symb_nb) / 1000) + 1;
+
+  for (uint8_t attempt = 0; attempt < CHANNEL_ACCESS_MAX_ATTEMPTS; attempt++) {
+    if ((int32_t) (windowEndMs - millis()) < (int32_t) airtimeMs) {
+      stats.framesNoTime++;
+      return CHANNEL_ACCESS_NO_TIME;
+    }
+
+    bool ok;
+    bool busy = ChannelAccess_channelBusy(&ok);
+    if (!ok) {
+      return CHANNEL_ACCESS_RADIO_ERROR;
+    }
+
+    if (!busy) {
+      if (!SnipsRadio_transmit(data, len, airtimeMs * 2)) {
+        return CHANNEL_ACCESS_RADIO_ERROR;
+      }
+      stats.framesSent++;
+      return CHANNEL_ACCESS_SENT;
+    }
+
+    uint8_t exponent = attempt + 1 < CHANNEL_ACCESS_MAX_BACKOFF_EXP ? attempt + 1 : CHANNEL_ACCESS_MAX_BACKOFF_EXP;
+    uint32_t backoffMs = EntropyPool_uniform(1u << exponent) * backoffSlotMs + backoffSlotMs;
+    stats.backoffMsTotal += backoffMs;
+    vTaskDelay(pdMS_TO_TICKS(backoffMs));
+  }
+
+  stats.framesBusy++;
+  return CHANNEL_ACCESS_BUSY;
+}
+
+void ChannelAccess_getStats(ChannelAccessStats* out) {
+  *out = stats;
+  out->busyPercent = ChannelAccess_busyPercent();
+}
+
+uint8_t ChannelAccess_busyPercent() {
+  return (uint8_t) (busyEwma >> 4);
+}
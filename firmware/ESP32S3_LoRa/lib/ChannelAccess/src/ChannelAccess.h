@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include "sx126x.h"
+
+// ============================================================================
+// CAD LISTEN-BEFORE-TALK CHANNEL ACCESS
+// ============================================================================
+//
+// Used for store-and-forward traffic outside the assigned TDMA slots. Each
+// attempt runs a CAD tuned for the current spreading factor; a busy channel
+// triggers a randomized binary exponential backoff drawn from the
+// EntropyPool. A frame is only sent if its airtime fits before the caller's
+// window end, so opportunistic traffic never spills into the next scheduled
+// slot.
+//
+
+#ifndef CHANNEL_ACCESS_MAX_ATTEMPTS
+#define CHANNEL_ACCESS_MAX_ATTEMPTS  6
+#endif
+
+#ifndef CHANNEL_ACCESS_MAX_BACKOFF_EXP
+#define CHANNEL_ACCESS_MAX_BACKOFF_EXP 5
+#endif
+
+enum ChannelAccessResult : uint8_t {
+  CHANNEL_ACCESS_SENT = 0,
+  CHANNEL_ACCESS_BUSY,         // every attempt found the channel busy
+  CHANNEL_ACCESS_NO_TIME,      // the frame no longer fits in the window
+  CHANNEL_ACCESS_RADIO_ERROR,
+  CHANNEL_ACCESS_DUTY_CYCLE,   // sub-band duty-cycle budget exhausted
+};
+
+struct ChannelAccessStats {
+  uint32_t cadRuns;
+  uint32_t cadBusy;
+  uint32_t framesSent;
+  uint32_t framesBusy;
+  uint32_t framesNoTime;
+  uint32_t backoffMsTotal;
+  uint8_t busyPercent;         // moving average of CAD busy results, 0-100
+};
+
+// Backoff needs per-node randomness: mixes selfAddress into the EntropyPool
+// and, if the pool holds no radio entropy yet, refills it (radio idle).
+// Fails when no entropy source is available.
+bool ChannelAccess_begin(uint8_t selfAddress);
+
+// CAD parameters recommended for the given SF (BW 125 kHz).
+void ChannelAccess_cadParamsForSf(sx126x_lora_sf_t sf, sx126x_cad_params_t* params);
+
+// Runs one CAD with the current modulation. Returns true if activity was
+// detected; *ok reports radio errors.
+bool ChannelAccess_channelBusy(bool* ok);
+
+// Listen-before-talk transmission. windowEndMs is a millis() timestamp the
+// whole frame must be on air before.
+ChannelAccessResult ChannelAccess_transmit(const uint8_t* data, uint8_t len, uint32_t windowEndMs);
+
+void ChannelAccess_getStats(ChannelAccessStats* stats);
+uint8_t ChannelAccess_busyPercent();
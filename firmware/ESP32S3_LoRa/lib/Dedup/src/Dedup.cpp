@@ -0,0 +1,109 @@
+#include "Dedup.h"
+#include <string.h>
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t hashKey(uint8_t src, uint8_t seq) {
+  uint32_t h = ((uint32_t) src << 8 | seq) * 2654435761u;
+  return h ^ (h >> 15);
+}
+
+static bool expired(uint32_t stampMs, uint32_t nowMs) {
+  return nowMs - stampMs >= DEDUP_EXPIRY_MS;
+}
+
+// ============================================================================
+// HASH SET
+// ============================================================================
+
+void DedupSet_init(DedupSet* set, DedupEntry* storage, uint16_t slots) {
+  memset(storage, 0, slots * sizeof(DedupEntry));
+  memset(&set->stats, 0, sizeof(set->stats));
+  set->entries = storage;
+  set->mask = slots - 1;
+}
+
+bool DedupSet_check(DedupSet* set, uint8_t src, uint8_t seq, uint32_t nowMs) {
+  set->stats.checks++;
+  uint16_t home = hashKey(src, seq) & set->mask;
+  DedupEntry* slot = nullptr;
+  DedupEntry* oldest = nullptr;
+
+  for (uint8_t probe = 0; probe < DEDUP_MAX_PROBE && probe <= set->mask; probe++) {
+    DedupEntry* e = &set->entries[(home + probe) & set->mask];
+    bool live = e->used && !expired(e->stampMs, nowMs);
+    if (live && e->src == src && e->seq == seq) {
+      set->stats.duplicates++;
+      return true;
+    }
+    if (!live && slot == nullptr) {
+      slot = e;
+    }
+    if (live && (oldest == nullptr || nowMs - e->stampMs > nowMs - oldest->stampMs)) {
+      oldest = e;
+    }
+  }
+
+  if (slot == nullptr) {
+    slot = oldest;
+    set->stats.evictions++;
+  }
+  slot->used = true;
+  slot->src = src;
+  slot->seq = seq;
+  slot->stampMs = nowMs;
+  return false;
+}
+
+// ============================================================================
+// BLOOM FILTER
+// ============================================================================
+
+void DedupBloom_init(DedupBloom* bloom, uint8_t* storage, uint16_t bitCount, uint32_t nowMs) {
+  memset(storage, 0, bitCount / 4);
+  memset(&bloom->stats, 0, sizeof(bloom->stats));
+  bloom->bits = storage;
+  bloom->bitCount = bitCount;
+  bloom->current = 0;
+  bloom->generationStartMs = nowMs;
+}
+
+bool DedupBloom_check(DedupBloom* bloom, uint8_t src, uint8_t seq, uint32_t nowMs) {
+  uint16_t genBytes = bloom->bitCount / 8;
+  while (nowMs - bloom->generationStartMs >= DEDUP_EXPIRY_MS / 2) {
+    bloom->current ^= 1;
+    memset(bloom->bits + bloom->current * genBytes, 0, genBytes);
+    bloom->generationStartMs += DEDUP_EXPIRY_MS / 2;
+    bloom->stats.rotations++;
+    if (nowMs - bloom->generationStartMs >= DEDUP_EXPIRY_MS) {
+      // Long silence: both generations are stale
+      memset(bloom->bits, 0, 2 * genBytes);
+      bloom->generationStartMs = nowMs;
+    }
+  }
+
+  bloom->stats.checks++;
+  uint32_t h = hashKey(src, seq);
+  uint16_t h1 = h & 0xFFFF;
+  uint16_t h2 = (h >> 16) | 1;
+  uint8_t* current = bloom->bits + bloom->current * genBytes;
+  uint8_t* previous = bloom->bits + (bloom->current ^ 1) * genBytes;
+
+  bool inCurrent = true;
+  bool inPrevious = true;
+  for (uint8_t k = 0; k < DEDUP_BLOOM_HASHES; k++) {
+    uint16_t bit = (uint16_t) (h1 + k * h2) % bloom->bitCount;
+    uint8_t mask = 1 << (bit & 7);
+    inCurrent = inCurrent && (current[bit >> 3] & mask);
+    inPrevious = inPrevious && (previous[bit >> 3] & mask);
+    current[bit >> 3] |= mask;
+  }
+
+  if (inCurrent || inPrevious) {
+    bloom->stats.duplicates++;
+    return true;
+  }
+  return false;
+}
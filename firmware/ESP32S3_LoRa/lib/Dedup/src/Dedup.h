@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// DUPLICATE SUPPRESSION
+// ============================================================================
+//
+// Floods and opportunistic relaying deliver the same frame over several
+// paths. A relay asks here before forwarding: the first copy of a
+// (source, sequence) pair is new, later copies within DEDUP_EXPIRY_MS are
+// duplicates. Both structures run in bounded time and fixed memory owned by
+// the caller, so they can be queried from the RX harvest path.
+//
+// DedupSet   open-addressing hash set, at most DEDUP_MAX_PROBE probes.
+//            Exact while the table holds the live keys; when a probe window
+//            is full the oldest entry is evicted (a later copy of it may
+//            then pass as new). 8 bytes per slot.
+//
+// DedupBloom two Bloom filter generations rotated every DEDUP_EXPIRY_MS / 2,
+//            so a key is remembered for half to one expiry period after
+//            its last copy. Never misses a duplicate; a new frame can be taken
+//            for a duplicate at the false-positive rate. bits / 4 bytes
+//            in total, sized for the 2 KB-RAM Nano mobiles.
+//
+// Neither structure locks; keep each to one task.
+//
+
+#ifndef DEDUP_EXPIRY_MS
+#define DEDUP_EXPIRY_MS      30000
+#endif
+
+#define DEDUP_MAX_PROBE      8
+#define DEDUP_BLOOM_HASHES   3
+
+struct DedupStats {
+  uint32_t checks;
+  uint32_t duplicates;
+  uint32_t evictions;        // set: live entries overwritten
+  uint32_t rotations;        // bloom: generations retired
+};
+
+struct DedupEntry {
+  uint32_t stampMs;
+  uint8_t src;
+  uint8_t seq;
+  bool used;
+};
+
+struct DedupSet {
+  DedupEntry* entries;
+  uint16_t mask;             // slots - 1
+  DedupStats stats;
+};
+
+struct DedupBloom {
+  uint8_t* bits;             // two generations of bitCount bits
+  uint16_t bitCount;
+  uint8_t current;
+  uint32_t generationStartMs;
+  DedupStats stats;
+};
+
+// slots must be a power of two.
+void DedupSet_init(DedupSet* set, DedupEntry* storage, uint16_t slots);
+
+// True if (src, seq) was seen within the expiry; records it otherwise. src
+// is whichever address makes seq unique (the previous hop for SNIPS
+// per-link sequence numbers, see DedupRadio).
+bool DedupSet_check(DedupSet* set, uint8_t src, uint8_t seq, uint32_t nowMs);
+
+// storage holds bitCount / 4 bytes; bitCount must be a multiple of 8.
+void DedupBloom_init(DedupBloom* bloom, uint8_t* storage, uint16_t bitCount, uint32_t nowMs);
+bool DedupBloom_check(DedupBloom* bloom, uint8_t src, uint8_t seq, uint32_t nowMs);
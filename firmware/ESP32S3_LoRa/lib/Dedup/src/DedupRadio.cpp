@@ -0,0 +1,31 @@
+#include "DedupRadio.h"
+#include "SnipsFrame.h"
+#include "SnipsRadio.h"
+
+static DedupEntry entries[DEDUP_RADIO_SLOTS];
+static DedupSet seen;
+static uint8_t self = 0;
+
+// Radio task only, like the set itself.
+static bool onRxDone(const SnipsRxPacket* pkt) {
+  if (pkt->len < SNIPS_FRAME_HEADER_LEN || pkt->data[0] != SNIPS_NETWORK_ID ||
+      SnipsFrame_type(pkt->data) != SNIPS_FRAME_DATA) {
+    return false;
+  }
+  uint8_t nextHop = pkt->data[SNIPS_FRAME_OFFSET_NEXT_HOP];
+  if (nextHop != self && nextHop != SNIPS_ADDR_BROADCAST) {
+    return false;
+  }
+  return DedupSet_check(&seen, pkt->data[SNIPS_FRAME_OFFSET_PREV_HOP], pkt->data[SNIPS_FRAME_OFFSET_SEQ],
+                        millis());
+}
+
+bool DedupRadio_attach(uint8_t selfAddress) {
+  self = selfAddress;
+  DedupSet_init(&seen, entries, DEDUP_RADIO_SLOTS);
+  return SnipsRadio_addRxHook(onRxDone);
+}
+
+void DedupRadio_getStats(DedupStats* out) {
+  *out = seen.stats;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Dedup.h"
+
+// ============================================================================
+// DUPLICATE SUPPRESSION RADIO BINDING
+// ============================================================================
+//
+// Registers an RX hook that consumes every DATA frame for this node (or
+// broadcast) whose (previous hop, sequence) was already received, so
+// duplicates never reach the relay queues. ACK_REQ frames have been
+// acknowledged from the DIO1 handler by then, so a retransmission after a
+// lost ACK is still answered.
+//
+// The SNIPS sequence byte is numbered per link (Arq rewrites it hop by
+// hop), so only the link transmitter makes it unique: this catches link
+// retransmissions, not copies of one frame that arrive over different
+// paths, which carry unrelated per-link numbers. A link wraps its
+// sequence after 256 frames, well beyond DEDUP_EXPIRY_MS at LoRa rates.
+//
+
+#ifndef DEDUP_RADIO_SLOTS
+#define DEDUP_RADIO_SLOTS    256
+#endif
+
+bool DedupRadio_attach(uint8_t selfAddress);
+void DedupRadio_getStats(DedupStats* stats);
@@ -0,0 +1,242 @@
+#include "DutyCycle.h"
+#include "lr_fhss_mac.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define BUCKET_MS  (DUTY_CYCLE_WINDOW_MS / DUTY_CYCLE_BUCKETS)
+
+struct SubBand {
+  uint32_t lowHz;
+  uint32_t highHz;
+  uint16_t limitTenthPercent;
+};
+
+static const SubBand subBands[] = {
+  { 863000000, 865000000,   1 },
+  { 865000000, 868000000,  10 },
+  { 868000000, 868600000,  10 },
+  { 868700000, 869200000,   1 },
+  { 869400000, 869650000, 100 },
+  { 869700000, 870000000,  10 },
+};
+
+#define SUB_BAND_COUNT  (sizeof(subBands) / sizeof(subBands[0]))
+
+static DutyCycleWindow windows[SUB_BAND_COUNT];
+static portMUX_TYPE dutyMux = portMUX_INITIALIZER_UNLOCKED;
+static DutyCycleStats stats;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t budgetUs(uint8_t band) {
+  // window * limit / 1000, with the window in ms and the result in us
+  return DUTY_CYCLE_WINDOW_MS * subBands[band].limitTenthPercent;
+}
+
+// Drops buckets that have left the window: bucket b holds airtime up to
+// (b + 1) * BUCKET_MS, so it stays until DUTY_CYCLE_BUCKETS newer ones
+// have started.
+static void advance(DutyCycleWindow* w, uint32_t nowMs) {
+  uint32_t now = nowMs / BUCKET_MS;
+  uint32_t steps = now - w->bucket;
+  if (steps >= DUTY_CYCLE_RING) {
+    memset(w->usedUs, 0, sizeof(w->usedUs));
+    w->totalUs = 0;
+  } else {
+    for (uint32_t i = 1; i <= steps; i++) {
+      uint32_t& slot = w->usedUs[(w->bucket + i) % DUTY_CYCLE_RING];
+      w->totalUs -= slot;
+      slot = 0;
+    }
+  }
+  w->bucket = now;
+}
+
+static uint32_t remaining(uint8_t band) {
+  uint32_t budget = budgetUs(band);
+  return windows[band].totalUs < budget ? budget - windows[band].totalUs : 0;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void DutyCycle_begin() {
+  memset(windows, 0, sizeof(windows));
+  memset(&stats, 0, sizeof(stats));
+  for (uint8_t band = 0; band < SUB_BAND_COUNT; band++) {
+    DutyCycleWindow_init(&windows[band], millis());
+  }
+}
+
+uint8_t DutyCycle_bandOf(uint32_t freqHz) {
+  for (uint8_t band = 0; band < SUB_BAND_COUNT; band++) {
+    if (freqHz >= subBands[band].lowHz && freqHz < subBands[band].highHz) {
+      return band;
+    }
+  }
+  return DUTY_CYCLE_NO_BAND;
+}
+
+uint32_t DutyCycle_loraAirUs(const sx126x_pkt_params_lora_t* pkt, const sx126x_mod_params_lora_t* mod) {
+  uint64_t numerator = sx126x_get_lora_time_on_air_numerator(pkt, mod);
+  return (uint32_t) ((numerator * 1000000ULL) / sx126x_get_lora_bw_in_hz(mod->bw));
+}
+
+uint32_t DutyCycle_gfskAirUs(const sx126x_pkt_params_gfsk_t* pkt, const sx126x_mod_params_gfsk_t* mod) {
+  uint64_t numerator = sx126x_get_gfsk_time_on_air_numerator(pkt);
+  return (uint32_t) ((numerator * 1000000ULL) / mod->br_in_bps);
+}
+
+uint32_t DutyCycle_lrFhssAirUs(const lr_fhss_v1_params_t* params, uint16_t payloadLen) {
+  // The LR-FHSS bitrate is 488.28125 b/s = 1e6 / 2048 us per bit
+  return lr_fhss_get_time_on_air_numerator(params, payloadLen) * 2048UL;
+}
+
+void DutyCycle_charge(uint32_t freqHz, uint32_t airUs) {
+  uint8_t band = DutyCycle_bandOf(freqHz);
+  if (band == DUTY_CYCLE_NO_BAND) {
+    return;
+  }
+
+  portENTER_CRITICAL(&dutyMux);
+  uint32_t nowMs = millis();
+  advance(&windows[band], nowMs);
+  if (airUs > remaining(band)) {
+    stats.overruns++;
+  }
+  DutyCycleWindow_charge(&windows[band], airUs, nowMs);
+  stats.charged++;
+  portEXIT_CRITICAL(&dutyMux);
+}
+
+uint32_t DutyCycle_remainingUs(uint32_t freqHz) {
+  uint8_t band = DutyCycle_bandOf(freqHz);
+  if (band == DUTY_CYCLE_NO_BAND) {
+    return DUTY_CYCLE_UNLIMITED;
+  }
+
+  portENTER_CRITICAL(&dutyMux);
+  advance(&windows[band], millis());
+  uint32_t left = remaining(band);
+  portEXIT_CRITICAL(&dutyMux);
+  return left;
+}
+
+bool DutyCycle_allows(uint32_t freqHz, uint32_t airUs) {
+  if (airUs <= DutyCycle_remainingUs(freqHz)) {
+    return true;
+  }
+  portENTER_CRITICAL(&dutyMux);
+  stats.blocked++;
+  portEXIT_CRITICAL(&dutyMux);
+  return false;
+}
+
+bool DutyCycle_reserve(uint32_t freqHz, uint32_t airUs) {
+  uint8_t band = DutyCycle_bandOf(freqHz);
+  if (band == DUTY_CYCLE_NO_BAND) {
+    return true;
+  }
+
+  portENTER_CRITICAL(&dutyMux);
+  uint32_t nowMs = millis();
+  advance(&windows[band], nowMs);
+  bool fits = airUs <= remaining(band);
+  if (fits) {
+    DutyCycleWindow_charge(&windows[band], airUs, nowMs);
+    stats.charged++;
+  } else {
+    stats.blocked++;
+  }
+  portEXIT_CRITICAL(&dutyMux);
+  return fits;
+}
+
+void DutyCycle_release(uint32_t freqHz, uint32_t airUs) {
+  uint8_t band = DutyCycle_bandOf(freqHz);
+  if (band == DUTY_CYCLE_NO_BAND) {
+    return;
+  }
+
+  portENTER_CRITICAL(&dutyMux);
+  DutyCycleWindow_release(&windows[band], airUs, millis());
+  stats.charged--;
+  portEXIT_CRITICAL(&dutyMux);
+}
+
+uint32_t DutyCycle_waitMs(uint32_t freqHz, uint32_t airUs) {
+  uint8_t band = DutyCycle_bandOf(freqHz);
+  if (band == DUTY_CYCLE_NO_BAND) {
+    return 0;
+  }
+
+  portENTER_CRITICAL(&dutyMux);
+  uint32_t waitMs = DutyCycleWindow_waitMs(&windows[band], budgetUs(band), airUs, millis());
+  portEXIT_CRITICAL(&dutyMux);
+  return waitMs;
+}
+
+void DutyCycle_getStats(DutyCycleStats* out) {
+  portENTER_CRITICAL(&dutyMux);
+  *out = stats;
+  portEXIT_CRITICAL(&dutyMux);
+}
+
+// ============================================================================
+// WINDOW CORE
+// ============================================================================
+
+void DutyCycleWindow_init(DutyCycleWindow* w, uint32_t nowMs) {
+  memset(w, 0, sizeof(*w));
+  w->bucket = nowMs / BUCKET_MS;
+}
+
+uint32_t DutyCycleWindow_usedUs(DutyCycleWindow* w, uint32_t nowMs) {
+  advance(w, nowMs);
+  return w->totalUs;
+}
+
+void DutyCycleWindow_charge(DutyCycleWindow* w, uint32_t airUs, uint32_t nowMs) {
+  advance(w, nowMs);
+  w->usedUs[w->bucket % DUTY_CYCLE_RING] += airUs;
+  w->totalUs += airUs;
+}
+
+void DutyCycleWindow_release(DutyCycleWindow* w, uint32_t airUs, uint32_t nowMs) {
+  advance(w, nowMs);
+  // Newest first: the reservation is in the current bucket unless a bucket
+  // boundary passed in between
+  for (uint32_t age = 0; age < DUTY_CYCLE_RING && airUs > 0; age++) {
+    uint32_t& slot = w->usedUs[(w->bucket + DUTY_CYCLE_RING - age) % DUTY_CYCLE_RING];
+    uint32_t take = slot < airUs ? slot : airUs;
+    slot -= take;
+    w->totalUs -= take;
+    airUs -= take;
+  }
+}
+
+uint32_t DutyCycleWindow_waitMs(DutyCycleWindow* w, uint32_t budgetUs, uint32_t airUs, uint32_t nowMs) {
+  advance(w, nowMs);
+  if (airUs > budgetUs) {
+    return DUTY_CYCLE_UNLIMITED;       // never fits
+  }
+  if (w->totalUs + airUs <= budgetUs) {
+    return 0;
+  }
+
+  // Age out the oldest buckets until enough is freed: the one `age` slots
+  // after the newest in the ring is dropped when bucket + age starts
+  uint32_t used = w->totalUs;
+  for (uint32_t age = 1; age <= DUTY_CYCLE_RING; age++) {
+    used -= w->usedUs[(w->bucket + age) % DUTY_CYCLE_RING];
+    if (used + airUs <= budgetUs) {
+      return (w->bucket + age) * BUCKET_MS - nowMs;
+    }
+  }
+  return DUTY_CYCLE_UNLIMITED;
+}
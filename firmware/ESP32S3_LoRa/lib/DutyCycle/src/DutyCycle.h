@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+#include "sx126x.h"
+#include "lr_fhss_v1_base_types.h"
+
+// ============================================================================
+// REGULATORY DUTY-CYCLE GOVERNOR
+// ============================================================================
+//
+// Every transmission is charged with its exact time on air (from the driver's
+// ToA numerators, in microseconds) against the EU868 sub-band it falls in.
+// Each sub-band keeps a sliding one-hour window of one-minute buckets, so
+// the budget frees up minute by minute as old traffic ages out. A node can
+// therefore run at the legal limit instead of throttling to a static rate.
+// A bucket is only dropped once all of it is more than an hour old, so the
+// window holds one extra bucket: rounding only ever errs towards less
+// airtime, and no true sliding hour exceeds the budget.
+//
+//   863.0 - 865.0 MHz   0.1 %      868.7 - 869.2 MHz   0.1 %
+//   865.0 - 868.0 MHz   1 %        869.4 - 869.65 MHz  10 %
+//   868.0 - 868.6 MHz   1 %        869.7 - 870.0 MHz   1 %
+//
+// Frequencies outside these sub-bands are not limited.
+//
+
+#ifndef DUTY_CYCLE_WINDOW_MS
+#define DUTY_CYCLE_WINDOW_MS    3600000UL
+#endif
+
+#ifndef DUTY_CYCLE_BUCKETS
+#define DUTY_CYCLE_BUCKETS      60
+#endif
+
+#define DUTY_CYCLE_NO_BAND      0xFF
+#define DUTY_CYCLE_UNLIMITED    0xFFFFFFFFUL
+
+// One sub-band's window: the bucket being filled plus DUTY_CYCLE_BUCKETS
+// older ones.
+#define DUTY_CYCLE_RING         (DUTY_CYCLE_BUCKETS + 1)
+
+struct DutyCycleWindow {
+  uint32_t usedUs[DUTY_CYCLE_RING];
+  uint32_t totalUs;
+  uint32_t bucket;           // absolute index of the newest bucket
+};
+
+struct DutyCycleStats {
+  uint32_t charged;          // transmissions accounted
+  uint32_t blocked;          // refused by DutyCycle_allows() / _reserve()
+  uint32_t overruns;         // charged although over budget (e.g. ACKs)
+};
+
+void DutyCycle_begin();
+
+// Sub-band index of freqHz, or DUTY_CYCLE_NO_BAND.
+uint8_t DutyCycle_bandOf(uint32_t freqHz);
+
+// Exact time on air in microseconds.
+uint32_t DutyCycle_loraAirUs(const sx126x_pkt_params_lora_t* pkt, const sx126x_mod_params_lora_t* mod);
+uint32_t DutyCycle_gfskAirUs(const sx126x_pkt_params_gfsk_t* pkt, const sx126x_mod_params_gfsk_t* mod);
+uint32_t DutyCycle_lrFhssAirUs(const lr_fhss_v1_params_t* params, uint16_t payloadLen);
+
+// Records a transmission of airUs at freqHz.
+void DutyCycle_charge(uint32_t freqHz, uint32_t airUs);
+
+// Budget left in the current window, for the scheduler and ADR.
+uint32_t DutyCycle_remainingUs(uint32_t freqHz);
+
+// True if airUs fits the remaining budget; counts a block otherwise.
+bool DutyCycle_allows(uint32_t freqHz, uint32_t airUs);
+
+// Checks and charges in one critical section, so two senders cannot both
+// pass the check against the same budget. Counts a block if airUs does not
+// fit. release gives the airtime back if the transmission did not start.
+bool DutyCycle_reserve(uint32_t freqHz, uint32_t airUs);
+void DutyCycle_release(uint32_t freqHz, uint32_t airUs);
+
+// Milliseconds until airUs fits (0 if it fits now).
+uint32_t DutyCycle_waitMs(uint32_t freqHz, uint32_t airUs);
+
+void DutyCycle_getStats(DutyCycleStats* stats);
+
+// Window core on an explicit clock, for the simulator. Not locked.
+void DutyCycleWindow_init(DutyCycleWindow* w, uint32_t nowMs);
+uint32_t DutyCycleWindow_usedUs(DutyCycleWindow* w, uint32_t nowMs);
+void DutyCycleWindow_charge(DutyCycleWindow* w, uint32_t airUs, uint32_t nowMs);
+void DutyCycleWindow_release(DutyCycleWindow* w, uint32_t airUs, uint32_t nowMs);
+uint32_t DutyCycleWindow_waitMs(DutyCycleWindow* w, uint32_t budgetUs, uint32_t airUs, uint32_t nowMs);
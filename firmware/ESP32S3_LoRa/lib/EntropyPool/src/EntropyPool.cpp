@@ -0,0 +1,156 @@
+#include "EntropyPool.h"
+#include "SnipsRadio.h"
+#include "sx126x_regs.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static uint32_t pool[ENTROPY_POOL_WORDS];
+static uint8_t poolCount = 0;
+static uint8_t mixIndex = 0;
+static uint32_t stretchState = 0x9E3779B9;
+
+static portMUX_TYPE poolMux = portMUX_INITIALIZER_UNLOCKED;
+static EntropyPoolStats stats;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t mix32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x85EBCA6B;
+  x ^= x >> 13;
+  x *= 0xC2B2AE35;
+  x ^= x >> 16;
+  return x;
+}
+
+static void addWord(uint32_t raw) {
+  portENTER_CRITICAL(&poolMux);
+  uint32_t word = mix32(raw ^ stretchState);
+  stretchState ^= word;
+  if (poolCount < ENTROPY_POOL_WORDS) {
+    pool[poolCount++] = word;
+  } else {
+    // Pool full: fold new entropy into the stored words instead of dropping it
+    pool[mixIndex] ^= word;
+    mixIndex = (mixIndex + 1) % ENTROPY_POOL_WORDS;
+  }
+  stats.wordsHarvested++;
+  portEXIT_CRITICAL(&poolMux);
+}
+
+// RX-start hook (radio lock held): top the pool up in the idle window
+static void onRxStart() {
+  uint8_t missing = ENTROPY_POOL_WORDS - poolCount;
+  if (missing > 0) {
+    EntropyPool_harvest(missing < ENTROPY_POOL_HARVEST_WORDS ? missing : ENTROPY_POOL_HARVEST_WORDS);
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool EntropyPool_begin() {
+  memset(&stats, 0, sizeof(stats));
+  poolCount = 0;
+  mixIndex = 0;
+  return EntropyPool_refill();
+}
+
+bool EntropyPool_attach() {
+  SnipsRadio_setRxStartHook(onRxStart);
+  return true;
+}
+
+uint8_t EntropyPool_harvest(uint8_t maxWords) {
+  const void* ctx = SnipsRadio_context();
+  uint8_t added = 0;
+
+  SnipsRadio_lock();
+  sx126x_chip_status_t status;
+  if (sx126x_get_status(ctx, &status) == SX126X_STATUS_OK && status.chip_mode == SX126X_CHIP_MODE_RX) {
+    for (; added < maxWords; added++) {
+      uint32_t raw;
+      if (sx126x_read_register(ctx, SX126X_REG_RNGBASEADDRESS, (uint8_t*) &raw, 4) != SX126X_STATUS_OK) {
+        break;
+      }
+      addWord(raw);
+    }
+  }
+  SnipsRadio_unlock();
+
+  return added;
+}
+
+bool EntropyPool_refill() {
+  uint32_t words[ENTROPY_POOL_WORDS];
+
+  SnipsRadio_lock();
+  bool ok = sx126x_get_random_numbers(SnipsRadio_context(), words, ENTROPY_POOL_WORDS) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+
+  if (ok) {
+    for (uint8_t i = 0; i < ENTROPY_POOL_WORDS; i++) {
+      addWord(words[i]);
+    }
+    stats.bulkRefills++;
+  }
+  return ok;
+}
+
+void EntropyPool_mixSeed(uint32_t seed) {
+  portENTER_CRITICAL(&poolMux);
+  stretchState = mix32(stretchState ^ mix32(seed));
+  if (stretchState == 0) {
+    stretchState = 0x9E3779B9;   // xorshift must not start at zero
+  }
+  portEXIT_CRITICAL(&poolMux);
+}
+
+bool EntropyPool_seeded() {
+  return stats.wordsHarvested > 0;
+}
+
+uint32_t EntropyPool_next() {
+  uint32_t word;
+
+  portENTER_CRITICAL(&poolMux);
+  if (poolCount > 0) {
+    word = pool[--poolCount];
+  } else {
+    stretchState ^= stretchState << 13;
+    stretchState ^= stretchState >> 17;
+    stretchState ^= stretchState << 5;
+    word = mix32(stretchState);
+    stats.underflows++;
+  }
+  stats.wordsServed++;
+  portEXIT_CRITICAL(&poolMux);
+
+  return word;
+}
+
+uint32_t EntropyPool_uniform(uint32_t bound) {
+  return (uint32_t) (((uint64_t) EntropyPool_next() * bound) >> 32);
+}
+
+void EntropyPool_fill(uint8_t* buf, size_t len) {
+  while (len > 0) {
+    uint32_t word = EntropyPool_next();
+    size_t n = len < 4 ? len : 4;
+    memcpy(buf, &word, n);
+    buf += n;
+    len -= n;
+  }
+}
+
+void EntropyPool_getStats(EntropyPoolStats* out) {
+  portENTER_CRITICAL(&poolMux);
+  *out = stats;
+  out->available = poolCount;
+  portEXIT_CRITICAL(&poolMux);
+}
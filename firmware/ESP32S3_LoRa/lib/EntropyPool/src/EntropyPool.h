@@ -0,0 +1,65 @@
+#pragma once
+#include <Arduino.h>
+
+// ============================================================================
+// ENTROPY POOL
+// ============================================================================
+//
+// sx126x_get_random_numbers() retunes the LNA/mixer, enters RX, reads and
+// drops back to STDBY_RC on every call. The pool instead collects random
+// words in bulk while the radio is already receiving (a plain register read
+// of the RNG, no mode change) and serves backoff jitter, nonces and slot
+// randomization from RAM. Raw words are mixed through a 32-bit finalizer
+// before they enter the pool.
+//
+// After EntropyPool_attach, every SnipsRadio_startRx harvests up to
+// ENTROPY_POOL_HARVEST_WORDS words right after the chip enters RX, while
+// the window is still idle; nothing is read once the pool is full.
+//
+
+#ifndef ENTROPY_POOL_WORDS
+#define ENTROPY_POOL_WORDS     32
+#endif
+
+#ifndef ENTROPY_POOL_HARVEST_WORDS
+#define ENTROPY_POOL_HARVEST_WORDS 4
+#endif
+
+struct EntropyPoolStats {
+  uint32_t wordsHarvested;
+  uint32_t wordsServed;
+  uint32_t bulkRefills;
+  uint32_t underflows;     // served from the stretched PRNG
+  uint8_t available;
+};
+
+// Seeds the pool with one bulk sx126x_get_random_numbers() call. Must run
+// while the radio is idle; leaves it in STDBY_RC.
+bool EntropyPool_begin();
+
+// Installs the harvest as the SnipsRadio RX-start hook.
+bool EntropyPool_attach();
+
+// Reads up to maxWords from the RNG register. Only harvests while the chip
+// is in RX; returns the number of words added.
+uint8_t EntropyPool_harvest(uint8_t maxWords);
+
+// Bulk refill through sx126x_get_random_numbers(). For idle periods only.
+bool EntropyPool_refill();
+
+// Mixes a per-node value (the node address) into the stretched PRNG, so
+// nodes that run their pool dry still draw different sequences.
+void EntropyPool_mixSeed(uint32_t seed);
+
+// True once any word has come from the radio RNG.
+bool EntropyPool_seeded();
+
+// Never touches the radio. Falls back to a PRNG stretched from earlier pool
+// words if the pool has run dry.
+uint32_t EntropyPool_next();
+
+// Uniform value in [0, bound).
+uint32_t EntropyPool_uniform(uint32_t bound);
+void EntropyPool_fill(uint8_t* buf, size_t len);
+
+void EntropyPool_getStats(EntropyPoolStats* stats);
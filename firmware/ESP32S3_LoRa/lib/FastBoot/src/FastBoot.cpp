@@ -0,0 +1,88 @@
+#include "FastBoot.h"
+
+// Upper bound for any single step; calibration is the slowest at ~3.5 ms.
+#define FAST_BOOT_STEP_TIMEOUT_US 20000
+
+static const char* stepNames[FAST_BOOT_STEP_COUNT] = {
+  "Reset",
+  "Standby RC",
+  "TCXO (DIO3)",
+  "Calibrate",
+  "Image cal",
+  "Configure",
+  "Device errors",
+};
+
+// ============================================================================
+// BRING-UP STEPS
+// ============================================================================
+
+static bool runStep(uint8_t step, const SnipsLoraConfig* cfg, FastBootReport* report) {
+  const void* ctx = SnipsRadio_context();
+
+  switch (step) {
+    case FAST_BOOT_RESET:
+      return sx126x_reset(ctx) == SX126X_STATUS_OK;
+    case FAST_BOOT_STANDBY:
+      return sx126x_set_standby(ctx, SX126X_STANDBY_CFG_RC) == SX126X_STATUS_OK;
+    case FAST_BOOT_TCXO:
+      return sx126x_set_dio3_as_tcxo_ctrl(ctx, FAST_BOOT_TCXO_VOLTAGE, FAST_BOOT_TCXO_TIMEOUT) == SX126X_STATUS_OK;
+    case FAST_BOOT_CALIBRATE:
+      return sx126x_cal(ctx, FAST_BOOT_CAL_MASK) == SX126X_STATUS_OK;
+    case FAST_BOOT_CAL_IMAGE:
+      return sx126x_cal_img_in_mhz(ctx, FAST_BOOT_BAND_LOW_MHZ, FAST_BOOT_BAND_HIGH_MHZ) == SX126X_STATUS_OK;
+    case FAST_BOOT_CONFIGURE:
+      return SnipsRadio_configureLora(cfg);
+    case FAST_BOOT_CHECK_ERRORS: {
+      sx126x_errors_mask_t errors = 0;
+      if (sx126x_get_device_errors(ctx, &errors) != SX126X_STATUS_OK) {
+        return false;
+      }
+      report->deviceErrors = errors;
+      sx126x_clear_device_errors(ctx);
+      // XOSC_START is always latched when a TCXO is powered from DIO3
+      return (errors & ~SX126X_ERRORS_XOSC_START) == 0;
+    }
+  }
+  return false;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool FastBoot_run(const SnipsLoraConfig* cfg, FastBootReport* report) {
+  memset(report, 0, sizeof(*report));
+  report->failedStep = FAST_BOOT_STEP_COUNT;
+
+  uint32_t bootStart = micros();
+
+  SnipsRadio_lock();
+  for (uint8_t step = 0; step < FAST_BOOT_STEP_COUNT; step++) {
+    uint32_t stepStart = micros();
+    bool ok = runStep(step, cfg, report) && SnipsRadio_waitNotBusy(FAST_BOOT_STEP_TIMEOUT_US);
+    report->stepUs[step] = micros() - stepStart;
+
+    if (!ok) {
+      report->failedStep = step;
+      break;
+    }
+  }
+  SnipsRadio_unlock();
+
+  report->totalUs = micros() - bootStart;
+  return report->failedStep == FAST_BOOT_STEP_COUNT;
+}
+
+const char* FastBoot_stepName(uint8_t step) {
+  return step < FAST_BOOT_STEP_COUNT ? stepNames[step] : "?";
+}
+
+void FastBoot_printReport(const FastBootReport* report) {
+  for (uint8_t step = 0; step < FAST_BOOT_STEP_COUNT; step++) {
+    const char* result = step < report->failedStep ? "PASS" : (step == report->failedStep ? "FAIL" : "----");
+    Serial.printf("  %-15s %6lu us  %s\n", FastBoot_stepName(step), (unsigned long) report->stepUs[step], result);
+  }
+  Serial.printf("  Device errors:  0x%04X\n", report->deviceErrors);
+  Serial.printf("  Total bring-up: %lu us\n", (unsigned long) report->totalUs);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+#include "SnipsRadio.h"
+
+// ============================================================================
+// FAST-BOOT RADIO BRING-UP
+// ============================================================================
+//
+// Production replacement for the LoRaTest bring-up sequence: no fixed
+// sleeps, every step waits on BUSY and is timed. Instead of CAL_ALL (whose
+// image calibration defaults to 902-928 MHz) the chip runs the oscillator,
+// PLL and ADC calibrations and then an image calibration for our band only.
+// An anchor coming back from a brownout is ready to rejoin the superframe in
+// a few milliseconds.
+//
+
+#ifndef FAST_BOOT_BAND_LOW_MHZ
+#define FAST_BOOT_BAND_LOW_MHZ   863
+#endif
+
+#ifndef FAST_BOOT_BAND_HIGH_MHZ
+#define FAST_BOOT_BAND_HIGH_MHZ  870
+#endif
+
+#ifndef FAST_BOOT_TCXO_VOLTAGE
+#define FAST_BOOT_TCXO_VOLTAGE   SX126X_TCXO_CTRL_3_3V
+#endif
+
+// TCXO start-up timeout in RTC steps (15.625 us): 320 = 5 ms
+#ifndef FAST_BOOT_TCXO_TIMEOUT
+#define FAST_BOOT_TCXO_TIMEOUT   320
+#endif
+
+#define FAST_BOOT_CAL_MASK       (SX126X_CAL_ALL & ~SX126X_CAL_IMAGE)
+
+enum FastBootStep : uint8_t {
+  FAST_BOOT_RESET = 0,
+  FAST_BOOT_STANDBY,
+  FAST_BOOT_TCXO,
+  FAST_BOOT_CALIBRATE,
+  FAST_BOOT_CAL_IMAGE,
+  FAST_BOOT_CONFIGURE,
+  FAST_BOOT_CHECK_ERRORS,
+  FAST_BOOT_STEP_COUNT
+};
+
+struct FastBootReport {
+  uint32_t stepUs[FAST_BOOT_STEP_COUNT];
+  uint32_t totalUs;
+  uint16_t deviceErrors;
+  uint8_t failedStep;      // FAST_BOOT_STEP_COUNT if every step passed
+};
+
+// Requires SnipsRadio_begin(). Leaves the radio configured with cfg in
+// STDBY_RC.
+bool FastBoot_run(const SnipsLoraConfig* cfg, FastBootReport* report);
+
+const char* FastBoot_stepName(uint8_t step);
+void FastBoot_printReport(const FastBootReport* report);
@@ -0,0 +1,305 @@
+#include "Fountain.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef BOARD_HAS_PSRAM
+#include <Arduino.h>
+#endif
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t xorshift(uint32_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+static uint32_t seedOf(uint8_t blobId, uint16_t esi, uint16_t salt) {
+  uint32_t seed = (((uint32_t) blobId << 16) | esi) * 2654435761u ^ ((uint32_t) salt * 40503u);
+  return seed != 0 ? seed : 0x9E3779B9;
+}
+
+static void xorInto(uint8_t* dst, const uint8_t* src, uint16_t len) {
+  for (uint16_t i = 0; i < len; i++) {
+    dst[i] ^= src[i];
+  }
+}
+
+static void* allocate(size_t bytes) {
+#ifdef BOARD_HAS_PSRAM
+  void* p = ps_malloc(bytes);
+  if (p != nullptr) {
+    return p;
+  }
+#endif
+  return malloc(bytes);
+}
+
+// ============================================================================
+// SYMBOL FORMAT
+// ============================================================================
+
+void FountainHeader_encode(const FountainHeader* header, uint8_t* buf) {
+  buf[0] = header->blobId;
+  buf[1] = header->size & 0xFF;
+  buf[2] = (header->size >> 8) & 0xFF;
+  buf[3] = (header->size >> 16) & 0xFF;
+  buf[4] = header->esi & 0xFF;
+  buf[5] = header->esi >> 8;
+  buf[6] = header->degree & 0xFF;
+  buf[7] = header->degree >> 8;
+}
+
+void FountainHeader_decode(const uint8_t* buf, FountainHeader* header) {
+  header->blobId = buf[0];
+  header->size = buf[1] | ((uint32_t) buf[2] << 8) | ((uint32_t) buf[3] << 16);
+  header->esi = buf[4] | (buf[5] << 8);
+  header->degree = buf[6] | (buf[7] << 8);
+}
+
+void Fountain_neighbors(uint8_t blobId, uint16_t esi, uint16_t degree, uint16_t k, uint16_t* out) {
+  uint32_t state = seedOf(blobId, esi, degree);
+  for (uint16_t i = 0; i < degree; i++) {
+    bool fresh;
+    do {
+      out[i] = (uint16_t) (((uint64_t) xorshift(&state) * k) >> 32);
+      fresh = true;
+      for (uint16_t j = 0; j < i && fresh; j++) {
+        fresh = out[j] != out[i];
+      }
+    } while (!fresh);
+  }
+}
+
+// ============================================================================
+// ENCODER
+// ============================================================================
+
+bool FountainEncoder_init(FountainEncoder* enc, uint8_t blobId, const uint8_t* data, uint32_t size,
+                          uint16_t symbolLen) {
+  uint32_t k = symbolLen != 0 ? (size + symbolLen - 1) / symbolLen : 0;
+  if (k == 0 || k > 0xFFFF || size > 0xFFFFFF) {
+    return false;
+  }
+  enc->data = data;
+  enc->size = size;
+  enc->k = (uint16_t) k;
+  enc->symbolLen = symbolLen;
+  enc->blobId = blobId;
+
+  // Robust soliton: ideal soliton plus a spike at K / R
+  float r = FOUNTAIN_SOLITON_C * logf(k / FOUNTAIN_SOLITON_DELTA) * sqrtf((float) k);
+  uint32_t spike = r > 0 ? (uint32_t) lroundf(k / r) : k;
+  spike = spike < 1 ? 1 : (spike > k ? k : spike);
+
+  float total = 0;
+  memset(enc->cdf, 0, sizeof(enc->cdf));
+  for (uint32_t d = 1; d <= k; d++) {
+    float p = d == 1 ? 1.0f / k : 1.0f / ((float) d * (d - 1));
+    if (d < spike) {
+      p += r / ((float) d * k);
+    } else if (d == spike) {
+      p += r * logf(r / FOUNTAIN_SOLITON_DELTA) / k;
+    }
+    total += p;
+    uint32_t slot = (d <= FOUNTAIN_MAX_DEGREE ? d : FOUNTAIN_MAX_DEGREE) - 1;
+    enc->cdf[slot] += p;
+  }
+  float running = 0;
+  for (uint16_t i = 0; i < FOUNTAIN_MAX_DEGREE; i++) {
+    running += enc->cdf[i] / total;
+    enc->cdf[i] = running;
+  }
+  return true;
+}
+
+uint16_t FountainEncoder_symbol(FountainEncoder* enc, uint16_t esi, uint8_t* out) {
+  uint32_t state = seedOf(enc->blobId, esi, 0);
+  float u = (xorshift(&state) >> 8) / 16777216.0f;
+  uint16_t degree = 1;
+  while (degree < FOUNTAIN_MAX_DEGREE && enc->cdf[degree - 1] < u) {
+    degree++;
+  }
+  degree = degree <= enc->k ? degree : enc->k;
+
+  FountainHeader header = { enc->blobId, enc->size, esi, degree };
+  FountainHeader_encode(&header, out);
+  uint8_t* symbol = out + FOUNTAIN_HEADER_LEN;
+  memset(symbol, 0, enc->symbolLen);
+
+  uint16_t neighbors[FOUNTAIN_MAX_DEGREE];
+  Fountain_neighbors(enc->blobId, esi, degree, enc->k, neighbors);
+  for (uint16_t i = 0; i < degree; i++) {
+    uint32_t offset = (uint32_t) neighbors[i] * enc->symbolLen;
+    uint32_t len = enc->size - offset < enc->symbolLen ? enc->size - offset : enc->symbolLen;
+    xorInto(symbol, enc->data + offset, (uint16_t) len);
+  }
+  return FOUNTAIN_HEADER_LEN + enc->symbolLen;
+}
+
+// ============================================================================
+// DECODER
+// ============================================================================
+
+static void recover(FountainDecoder* dec, uint16_t index, const uint8_t* symbol, uint16_t* top) {
+  if (dec->decoded[index]) {
+    return;
+  }
+  memcpy(dec->symbols + (uint32_t) index * dec->symbolLen, symbol, dec->symbolLen);
+  dec->decoded[index] = 1;
+  dec->decodedCount++;
+  dec->ripple[(*top)++] = index;
+}
+
+// XORs every recovered symbol out of the buffered ones, recovering more as
+// buffered symbols drop to a single unknown.
+static void peel(FountainDecoder* dec, uint16_t top) {
+  uint16_t neighbors[FOUNTAIN_MAX_DEGREE];
+  while (top > 0) {
+    uint16_t s = dec->ripple[--top];
+    const uint8_t* source = dec->symbols + (uint32_t) s * dec->symbolLen;
+
+    for (uint16_t p = 0; p < dec->pendingCapacity; p++) {
+      FountainPending& meta = dec->meta[p];
+      if (!meta.used) {
+        continue;
+      }
+      Fountain_neighbors(dec->blobId, meta.esi, meta.degree, dec->k, neighbors);
+      bool covers = false;
+      for (uint16_t i = 0; i < meta.degree && !covers; i++) {
+        covers = neighbors[i] == s;
+      }
+      if (!covers) {
+        continue;
+      }
+
+      uint8_t* symbol = dec->pending + (uint32_t) p * dec->symbolLen;
+      xorInto(symbol, source, dec->symbolLen);
+      if (--meta.remaining <= 1) {
+        meta.used = false;
+        for (uint16_t i = 0; i < meta.degree && meta.remaining == 1; i++) {
+          if (!dec->decoded[neighbors[i]]) {
+            recover(dec, neighbors[i], symbol, &top);
+            meta.remaining = 0;
+          }
+        }
+      }
+    }
+  }
+}
+
+bool FountainDecoder_begin(FountainDecoder* dec, const uint8_t* payload, uint16_t len, uint16_t pendingPercent) {
+  memset(dec, 0, sizeof(*dec));
+  if (len <= FOUNTAIN_HEADER_LEN) {
+    return false;
+  }
+  FountainHeader header;
+  FountainHeader_decode(payload, &header);
+  dec->blobId = header.blobId;
+  dec->size = header.size;
+  dec->symbolLen = len - FOUNTAIN_HEADER_LEN;
+  uint32_t k = (header.size + dec->symbolLen - 1) / dec->symbolLen;
+  if (k == 0 || k > 0xFFFF) {
+    return false;
+  }
+  dec->k = (uint16_t) k;
+  uint32_t capacity = k * pendingPercent / 100 + 1;
+  dec->pendingCapacity = capacity < 0xFFFF ? (uint16_t) capacity : 0xFFFF;
+
+  dec->symbols = (uint8_t*) allocate((size_t) k * dec->symbolLen);
+  dec->decoded = (uint8_t*) allocate(k);
+  dec->pending = (uint8_t*) allocate((size_t) dec->pendingCapacity * dec->symbolLen);
+  dec->meta = (FountainPending*) allocate(dec->pendingCapacity * sizeof(FountainPending));
+  dec->ripple = (uint16_t*) allocate(k * sizeof(uint16_t));
+  dec->scratch = (uint8_t*) allocate(dec->symbolLen);
+  if (!dec->symbols || !dec->decoded || !dec->pending || !dec->meta || !dec->ripple || !dec->scratch) {
+    FountainDecoder_end(dec);
+    return false;
+  }
+  memset(dec->decoded, 0, k);
+  memset(dec->meta, 0, dec->pendingCapacity * sizeof(FountainPending));
+  return true;
+}
+
+void FountainDecoder_end(FountainDecoder* dec) {
+  free(dec->symbols);
+  free(dec->decoded);
+  free(dec->pending);
+  free(dec->meta);
+  free(dec->ripple);
+  free(dec->scratch);
+  dec->symbols = nullptr;
+  dec->decoded = nullptr;
+  dec->pending = nullptr;
+  dec->meta = nullptr;
+  dec->ripple = nullptr;
+  dec->scratch = nullptr;
+}
+
+bool FountainDecoder_add(FountainDecoder* dec, const uint8_t* payload, uint16_t len) {
+  if (dec->symbols == nullptr || FountainDecoder_complete(dec)) {
+    return FountainDecoder_complete(dec);
+  }
+  FountainHeader header;
+  FountainHeader_decode(payload, &header);
+  if (len != FOUNTAIN_HEADER_LEN + dec->symbolLen || header.blobId != dec->blobId || header.size != dec->size) {
+    return false;
+  }
+  dec->stats.received++;
+  if (header.degree == 0 || header.degree > FOUNTAIN_MAX_DEGREE || header.degree > dec->k) {
+    dec->stats.redundant++;
+    return false;
+  }
+
+  uint16_t neighbors[FOUNTAIN_MAX_DEGREE];
+  Fountain_neighbors(dec->blobId, header.esi, header.degree, dec->k, neighbors);
+  memcpy(dec->scratch, payload + FOUNTAIN_HEADER_LEN, dec->symbolLen);
+  uint16_t remaining = 0;
+  uint16_t unknown = 0;
+  for (uint16_t i = 0; i < header.degree; i++) {
+    if (dec->decoded[neighbors[i]]) {
+      xorInto(dec->scratch, dec->symbols + (uint32_t) neighbors[i] * dec->symbolLen, dec->symbolLen);
+    } else {
+      remaining++;
+      unknown = neighbors[i];
+    }
+  }
+
+  if (remaining == 0) {
+    dec->stats.redundant++;
+  } else if (remaining == 1) {
+    uint16_t top = 0;
+    recover(dec, unknown, dec->scratch, &top);
+    peel(dec, top);
+  } else {
+    // Stored reduced; later recoveries are XORed out as they come
+    uint16_t p = 0;
+    while (p < dec->pendingCapacity && dec->meta[p].used) {
+      p++;
+    }
+    if (p == dec->pendingCapacity) {
+      dec->stats.overflow++;
+      return false;
+    }
+    memcpy(dec->pending + (uint32_t) p * dec->symbolLen, dec->scratch, dec->symbolLen);
+    dec->meta[p] = { header.esi, header.degree, remaining, true };
+    dec->stats.buffered++;
+  }
+  return FountainDecoder_complete(dec);
+}
+
+bool FountainDecoder_complete(const FountainDecoder* dec) {
+  return dec->k != 0 && dec->decodedCount == dec->k;
+}
+
+bool FountainDecoder_copy(const FountainDecoder* dec, uint8_t* out) {
+  if (!FountainDecoder_complete(dec)) {
+    return false;
+  }
+  memcpy(out, dec->symbols, dec->size);
+  return true;
+}
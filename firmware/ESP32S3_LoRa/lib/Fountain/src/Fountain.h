@@ -0,0 +1,124 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// FOUNTAIN-CODED BULK BROADCAST (LT CODE)
+// ============================================================================
+//
+// A blob (firmware image, configuration) is cut into K source symbols. The
+// sender broadcasts an endless stream of encoded symbols, each the XOR of a
+// pseudo-random set of source symbols whose size (degree) is drawn from a
+// robust soliton distribution. Any node rebuilds the blob from any
+// K(1 + e) symbols it happens to catch, with no feedback, so one broadcast
+// stream serves every node whatever it lost.
+//
+// Encoded symbol payload (SNIPS_FRAME_FOUNTAIN):
+//
+//  byte 0    blob id
+//  byte 1-3  blob size in bytes (little endian)
+//  byte 4-5  encoded symbol id (ESI, little endian)
+//  byte 6-7  degree (little endian)
+//  byte 8+   symbol (its length is the symbol size)
+//
+// The source symbols of an encoded symbol follow from (blob id, ESI,
+// degree) through an integer PRNG, so the degree distribution lives only in
+// the encoder. The decoder peels: every symbol reduced to one unknown
+// source recovers it, and each recovery is XORed out of the buffered
+// symbols. Its buffers (K source symbols plus the pending encoded ones) are
+// allocated in PSRAM when the board has it.
+//
+
+#define FOUNTAIN_HEADER_LEN      8
+
+#ifndef FOUNTAIN_MAX_DEGREE
+#define FOUNTAIN_MAX_DEGREE      128     // robust soliton tail clamped here
+#endif
+
+#ifndef FOUNTAIN_SOLITON_C
+#define FOUNTAIN_SOLITON_C       0.05f
+#endif
+
+#ifndef FOUNTAIN_SOLITON_DELTA
+#define FOUNTAIN_SOLITON_DELTA   0.5f
+#endif
+
+struct FountainHeader {
+  uint8_t blobId;
+  uint32_t size;
+  uint16_t esi;
+  uint16_t degree;
+};
+
+void FountainHeader_encode(const FountainHeader* header, uint8_t* buf);
+void FountainHeader_decode(const uint8_t* buf, FountainHeader* header);
+
+// Source symbols an encoded symbol covers (degree distinct indices below k).
+void Fountain_neighbors(uint8_t blobId, uint16_t esi, uint16_t degree, uint16_t k, uint16_t* out);
+
+// ---------------------------------------------------------------------------
+// Encoder (anchor or host)
+// ---------------------------------------------------------------------------
+
+struct FountainEncoder {
+  const uint8_t* data;
+  uint32_t size;
+  uint16_t k;
+  uint16_t symbolLen;
+  uint8_t blobId;
+  float cdf[FOUNTAIN_MAX_DEGREE];
+};
+
+bool FountainEncoder_init(FountainEncoder* enc, uint8_t blobId, const uint8_t* data, uint32_t size,
+                          uint16_t symbolLen);
+
+// Writes the header and symbol of encoded symbol esi into out
+// (FOUNTAIN_HEADER_LEN + symbolLen bytes). Returns the length.
+uint16_t FountainEncoder_symbol(FountainEncoder* enc, uint16_t esi, uint8_t* out);
+
+// ---------------------------------------------------------------------------
+// Peeling decoder (nodes)
+// ---------------------------------------------------------------------------
+
+struct FountainStats {
+  uint32_t received;
+  uint32_t redundant;        // carried no unknown source symbol
+  uint32_t buffered;
+  uint32_t overflow;         // pending buffer full
+};
+
+struct FountainPending {
+  uint16_t esi;
+  uint16_t degree;
+  uint16_t remaining;        // source symbols not yet XORed out
+  bool used;
+};
+
+struct FountainDecoder {
+  uint8_t blobId;
+  uint32_t size;
+  uint16_t k;
+  uint16_t symbolLen;
+  uint16_t decodedCount;
+  uint16_t pendingCapacity;
+  uint8_t* symbols;          // k x symbolLen
+  uint8_t* decoded;          // k flags
+  uint8_t* pending;          // pendingCapacity x symbolLen
+  FountainPending* meta;
+  uint8_t* scratch;          // symbolLen
+  uint16_t* ripple;          // k entries
+  FountainStats stats;
+};
+
+// Takes the blob parameters from the first encoded symbol. pendingPercent
+// sizes the buffer of not-yet-useful symbols as a percentage of K.
+bool FountainDecoder_begin(FountainDecoder* dec, const uint8_t* payload, uint16_t len, uint16_t pendingPercent);
+void FountainDecoder_end(FountainDecoder* dec);
+
+// Feeds one encoded symbol payload. Returns true once the blob is complete.
+bool FountainDecoder_add(FountainDecoder* dec, const uint8_t* payload, uint16_t len);
+
+bool FountainDecoder_complete(const FountainDecoder* dec);
+
+// Copies the decoded blob (dec->size bytes) into out.
+bool FountainDecoder_copy(const FountainDecoder* dec, uint8_t* out);
@@ -0,0 +1,141 @@
+#include "FreqPlan.h"
+#include "SnipsRadio.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static FreqPlanChannel channels[FREQ_PLAN_MAX_CHANNELS];
+static uint8_t channelCount = 0;
+static FreqPlanBand bands[FREQ_PLAN_MAX_CHANNELS];
+static uint8_t bandCount = 0;
+
+static uint8_t currentChannel = 0xFF;
+static FreqPlanStats stats;
+
+// ============================================================================
+// BAND GROUPING
+// ============================================================================
+
+static void groupBands() {
+  // Sort indices by frequency (insertion sort, tiny table)
+  uint8_t order[FREQ_PLAN_MAX_CHANNELS];
+  for (uint8_t i = 0; i < channelCount; i++) {
+    uint8_t j = i;
+    while (j > 0 && channels[order[j - 1]].freqHz > channels[i].freqHz) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = i;
+  }
+
+  bandCount = 0;
+  uint32_t bandStartMhz = 0;
+  for (uint8_t k = 0; k < channelCount; k++) {
+    FreqPlanChannel& ch = channels[order[k]];
+    uint32_t lowMhz = ch.freqHz / 1000000;
+    uint32_t highMhz = (ch.freqHz + 999999) / 1000000;
+
+    if (bandCount == 0 || highMhz - bandStartMhz > FREQ_PLAN_MAX_BAND_SPAN_MHZ) {
+      bandStartMhz = lowMhz;
+      bands[bandCount].lowMhz = lowMhz;
+      bands[bandCount].highMhz = highMhz;
+      bandCount++;
+    } else if (highMhz > bands[bandCount - 1].highMhz) {
+      bands[bandCount - 1].highMhz = highMhz;
+    }
+    ch.band = bandCount - 1;
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool FreqPlan_begin(const uint32_t* freqsHz, uint8_t count) {
+  if (count == 0 || count > FREQ_PLAN_MAX_CHANNELS) {
+    return false;
+  }
+
+  channelCount = count;
+  for (uint8_t i = 0; i < count; i++) {
+    channels[i].freqHz = freqsHz[i];
+    channels[i].pllSteps = sx126x_convert_freq_in_hz_to_pll_step(freqsHz[i]);
+  }
+  groupBands();
+
+  memset(&stats, 0, sizeof(stats));
+  stats.calibratedBand = FREQ_PLAN_NO_BAND;
+  currentChannel = 0xFF;
+  return true;
+}
+
+uint8_t FreqPlan_channelCount() {
+  return channelCount;
+}
+
+const FreqPlanChannel* FreqPlan_channel(uint8_t channel) {
+  return channel < channelCount ? &channels[channel] : nullptr;
+}
+
+uint8_t FreqPlan_bandCount() {
+  return bandCount;
+}
+
+const FreqPlanBand* FreqPlan_band(uint8_t band) {
+  return band < bandCount ? &bands[band] : nullptr;
+}
+
+bool FreqPlan_switchTo(uint8_t channel) {
+  if (channel >= channelCount) {
+    return false;
+  }
+
+  const void* ctx = SnipsRadio_context();
+  const FreqPlanChannel& ch = channels[channel];
+  bool ok = true;
+  bool recalibrate = ch.band != stats.calibratedBand;
+  uint32_t start = micros();
+
+  SnipsRadio_lock();
+  if (recalibrate) {
+    // Image calibration has to run from STDBY_RC
+    ok &= sx126x_set_standby(ctx, SX126X_STANDBY_CFG_RC) == SX126X_STATUS_OK;
+    ok &= sx126x_cal_img_in_mhz(ctx, bands[ch.band].lowMhz, bands[ch.band].highMhz) == SX126X_STATUS_OK;
+    ok &= SnipsRadio_waitNotBusy(10000);
+    stats.calibratedBand = ok ? ch.band : FREQ_PLAN_NO_BAND;
+    stats.recalibrations++;
+    stats.lastRecalUs = micros() - start;
+  }
+  ok &= sx126x_set_rf_freq_in_pll_steps(ctx, ch.pllSteps) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+
+  uint32_t elapsed = micros() - start;
+  stats.switches++;
+  stats.lastSwitchUs = elapsed;
+  if (!recalibrate && elapsed > stats.maxSwitchUs) {
+    stats.maxSwitchUs = elapsed;
+  }
+
+  if (ok) {
+    currentChannel = channel;
+    SnipsRadio_noteFrequency(ch.freqHz);
+  }
+  return ok;
+}
+
+uint8_t FreqPlan_currentChannel() {
+  return currentChannel;
+}
+
+bool FreqPlan_bandValid(uint8_t band) {
+  return band != FREQ_PLAN_NO_BAND && band == stats.calibratedBand;
+}
+
+void FreqPlan_invalidate() {
+  stats.calibratedBand = FREQ_PLAN_NO_BAND;
+}
+
+void FreqPlan_getStats(FreqPlanStats* out) {
+  *out = stats;
+}
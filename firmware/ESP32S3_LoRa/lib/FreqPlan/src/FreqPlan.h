@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+
+// ============================================================================
+// FREQUENCY PLAN / IMAGE-CALIBRATION CACHE
+// ============================================================================
+//
+// PLL steps are precomputed for every channel and channels are grouped into
+// image-calibration bands. A switch inside the calibrated band is a single
+// SetRfFrequency command; sx126x_cal_img_in_mhz() only runs when a switch
+// crosses into another band.
+//
+// The SX126x holds one image calibration at a time, so at most one band is
+// valid. Call FreqPlan_invalidate() after a reset or a cold-start sleep.
+//
+
+#ifndef FREQ_PLAN_MAX_CHANNELS
+#define FREQ_PLAN_MAX_CHANNELS       16
+#endif
+
+#ifndef FREQ_PLAN_MAX_BAND_SPAN_MHZ
+#define FREQ_PLAN_MAX_BAND_SPAN_MHZ  8
+#endif
+
+#define FREQ_PLAN_NO_BAND            0xFF
+
+struct FreqPlanChannel {
+  uint32_t freqHz;
+  uint32_t pllSteps;
+  uint8_t band;
+};
+
+struct FreqPlanBand {
+  uint16_t lowMhz;
+  uint16_t highMhz;
+};
+
+struct FreqPlanStats {
+  uint32_t switches;
+  uint32_t recalibrations;
+  uint32_t lastSwitchUs;
+  uint32_t maxSwitchUs;       // excluding recalibrations
+  uint32_t lastRecalUs;
+  uint8_t calibratedBand;
+};
+
+// Loads the channel list (any order) and groups it into bands.
+bool FreqPlan_begin(const uint32_t* freqsHz, uint8_t count);
+
+uint8_t FreqPlan_channelCount();
+const FreqPlanChannel* FreqPlan_channel(uint8_t channel);
+uint8_t FreqPlan_bandCount();
+const FreqPlanBand* FreqPlan_band(uint8_t band);
+
+// Retunes the radio (STDBY or FS) to the channel, recalibrating the image
+// only on a band change.
+bool FreqPlan_switchTo(uint8_t channel);
+uint8_t FreqPlan_currentChannel();
+
+bool FreqPlan_bandValid(uint8_t band);
+void FreqPlan_invalidate();
+
+void FreqPlan_getStats(FreqPlanStats* stats);
@@ -0,0 +1,208 @@
+#include "NetCoding.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct HeldFrame {
+  bool used;
+  uint8_t len;
+  uint32_t arrivalMs;
+  uint8_t data[NETCODING_MAX_FRAME_LEN];
+};
+
+static HeldFrame held[NETCODING_RELAY_FRAMES];
+static NetCodingEndpoint endpoint;
+static uint8_t selfAddr = 0;
+static uint8_t codedSeq = 0;
+static NetCodingStats stats;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+// Rewrites a relayed frame's link fields as the relay's forward would. The
+// queue depth was the previous hop's, not the relay's.
+static void patchForward(uint8_t* frame, uint8_t relay) {
+  frame[SNIPS_FRAME_OFFSET_FLAGS] &= ~SNIPS_FLAG_QUEUE_VALID;
+  frame[SNIPS_FRAME_OFFSET_PREV_HOP] = relay;
+  frame[SNIPS_FRAME_OFFSET_NEXT_HOP] = frame[SNIPS_FRAME_OFFSET_DST];
+  frame[SNIPS_FRAME_OFFSET_HOPS]++;
+}
+
+static bool partners(const HeldFrame* a, const HeldFrame* b) {
+  return a->data[SNIPS_FRAME_OFFSET_DST] == b->data[SNIPS_FRAME_OFFSET_PREV_HOP] &&
+         b->data[SNIPS_FRAME_OFFSET_DST] == a->data[SNIPS_FRAME_OFFSET_PREV_HOP];
+}
+
+static uint8_t encodePair(HeldFrame* a, HeldFrame* b, uint8_t* out) {
+  SnipsFrameHeader header = {};
+  header.netId = SNIPS_NETWORK_ID;
+  header.type = SNIPS_FRAME_CODED;
+  header.trafficClass = SNIPS_CLASS_DATA;
+  header.src = selfAddr;
+  header.dst = SNIPS_ADDR_BROADCAST;
+  header.prevHop = selfAddr;
+  header.nextHop = SNIPS_ADDR_BROADCAST;
+  header.seq = codedSeq++;
+  SnipsFrame_encodeHeader(&header, out);
+
+  uint8_t* p = out + SNIPS_FRAME_HEADER_LEN;
+  p[0] = a->data[SNIPS_FRAME_OFFSET_PREV_HOP];
+  p[1] = a->data[SNIPS_FRAME_OFFSET_SEQ];
+  p[2] = a->len;
+  p[3] = b->data[SNIPS_FRAME_OFFSET_PREV_HOP];
+  p[4] = b->data[SNIPS_FRAME_OFFSET_SEQ];
+  p[5] = b->len;
+  p += NETCODING_CODED_HEADER_LEN;
+
+  uint8_t longest = a->len > b->len ? a->len : b->len;
+  for (uint8_t i = 0; i < longest; i++) {
+    p[i] = (i < a->len ? a->data[i] : 0) ^ (i < b->len ? b->data[i] : 0);
+  }
+
+  a->used = false;
+  b->used = false;
+  stats.codedOut++;
+  return SNIPS_FRAME_HEADER_LEN + NETCODING_CODED_HEADER_LEN + longest;
+}
+
+// ============================================================================
+// ENDPOINT
+// ============================================================================
+
+void NetCodingEndpoint_init(NetCodingEndpoint* endpoint, uint8_t selfAddress) {
+  memset(endpoint, 0, sizeof(*endpoint));
+  endpoint->self = selfAddress;
+}
+
+void NetCodingEndpoint_retain(NetCodingEndpoint* endpoint, const uint8_t* frame, uint8_t len) {
+  if (len < SNIPS_FRAME_HEADER_LEN || len > NETCODING_MAX_FRAME_LEN) {
+    return;
+  }
+  NetCodingRetained* r = &endpoint->retained[endpoint->next];
+  endpoint->next = (endpoint->next + 1) % NETCODING_RETAIN_FRAMES;
+  r->used = true;
+  r->seq = frame[SNIPS_FRAME_OFFSET_SEQ];
+  r->len = len;
+  memcpy(r->data, frame, len);
+}
+
+uint8_t NetCodingEndpoint_decode(const NetCodingEndpoint* endpoint, const uint8_t* packet, uint8_t len,
+                                 uint8_t* out, NetCodingStats* stats) {
+  if (len < SNIPS_FRAME_HEADER_LEN + NETCODING_CODED_HEADER_LEN ||
+      SnipsFrame_type(packet) != SNIPS_FRAME_CODED) {
+    return 0;
+  }
+
+  const uint8_t* p = packet + SNIPS_FRAME_HEADER_LEN;
+  const uint8_t* coded = p + NETCODING_CODED_HEADER_LEN;
+  uint8_t mine;
+  if (p[0] == endpoint->self) {
+    mine = 0;
+  } else if (p[3] == endpoint->self) {
+    mine = 3;
+  } else {
+    return 0;
+  }
+  uint8_t mySeq = p[mine + 1];
+  uint8_t myLen = p[mine + 2];
+  uint8_t otherLen = p[(mine ^ 3) + 2];
+  uint8_t longest = myLen > otherLen ? myLen : otherLen;
+  // patchForward writes into the recovered header
+  if (otherLen < SNIPS_FRAME_HEADER_LEN || longest > NETCODING_MAX_FRAME_LEN || coded + longest > packet + len) {
+    stats->malformed++;
+    return 0;
+  }
+
+  for (uint8_t i = 0; i < NETCODING_RETAIN_FRAMES; i++) {
+    const NetCodingRetained* r = &endpoint->retained[i];
+    if (!r->used || r->seq != mySeq || r->len != myLen) {
+      continue;
+    }
+    for (uint8_t k = 0; k < otherLen; k++) {
+      out[k] = coded[k] ^ (k < myLen ? r->data[k] : 0);
+    }
+    patchForward(out, packet[SNIPS_FRAME_OFFSET_PREV_HOP]);
+    stats->decoded++;
+    return otherLen;
+  }
+
+  stats->notRetained++;
+  return 0;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void NetCoding_begin(uint8_t selfAddress) {
+  memset(held, 0, sizeof(held));
+  memset(&stats, 0, sizeof(stats));
+  NetCodingEndpoint_init(&endpoint, selfAddress);
+  selfAddr = selfAddress;
+}
+
+bool NetCoding_relayAdd(const uint8_t* frame, uint8_t len, uint32_t nowMs) {
+  if (len < SNIPS_FRAME_HEADER_LEN || len > NETCODING_MAX_FRAME_LEN) {
+    return false;
+  }
+  for (uint8_t i = 0; i < NETCODING_RELAY_FRAMES; i++) {
+    if (!held[i].used) {
+      held[i].used = true;
+      held[i].len = len;
+      held[i].arrivalMs = nowMs;
+      memcpy(held[i].data, frame, len);
+      stats.relayIn++;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint8_t NetCoding_relayPoll(uint32_t nowMs, uint8_t* out) {
+  // Oldest first, so no frame is starved behind newer pairs
+  HeldFrame* oldest = nullptr;
+  for (uint8_t i = 0; i < NETCODING_RELAY_FRAMES; i++) {
+    if (held[i].used && (oldest == nullptr || (int32_t) (held[i].arrivalMs - oldest->arrivalMs) < 0)) {
+      oldest = &held[i];
+    }
+  }
+  if (oldest == nullptr) {
+    return 0;
+  }
+
+  HeldFrame* partner = nullptr;
+  for (uint8_t i = 0; i < NETCODING_RELAY_FRAMES; i++) {
+    if (held[i].used && &held[i] != oldest && partners(oldest, &held[i]) &&
+        (partner == nullptr || (int32_t) (held[i].arrivalMs - partner->arrivalMs) < 0)) {
+      partner = &held[i];
+    }
+  }
+  if (partner != nullptr) {
+    return encodePair(oldest, partner, out);
+  }
+
+  if (nowMs - oldest->arrivalMs < NETCODING_HOLD_MS) {
+    return 0;
+  }
+  uint8_t len = oldest->len;
+  memcpy(out, oldest->data, len);
+  patchForward(out, selfAddr);
+  oldest->used = false;
+  stats.plainOut++;
+  return len;
+}
+
+void NetCoding_retain(const uint8_t* frame, uint8_t len) {
+  NetCodingEndpoint_retain(&endpoint, frame, len);
+}
+
+uint8_t NetCoding_decode(const uint8_t* packet, uint8_t len, uint8_t* out) {
+  return NetCodingEndpoint_decode(&endpoint, packet, len, out, &stats);
+}
+
+void NetCoding_getStats(NetCodingStats* out) {
+  *out = stats;
+}
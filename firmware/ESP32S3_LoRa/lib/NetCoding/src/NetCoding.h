@@ -0,0 +1,99 @@
+#pragma once
+#include <stdint.h>
+#include "SnipsFrame.h"
+
+// ============================================================================
+// XOR NETWORK CODING (TWO-WAY RELAY)
+// ============================================================================
+//
+// For M1 -> R1 -> M2 and M2 -> R1 -> M1 the relay holds each frame briefly.
+// If a frame going the other way arrives (A.dst == B.prevHop and
+// B.dst == A.prevHop), it broadcasts A xor B once instead of forwarding
+// both:
+//
+//  SNIPS header (type CODED, nextHop broadcast)
+//  prevHopA, seqA, lenA, prevHopB, seqB, lenB
+//  A xor B (zero padded to the longer one)
+//
+// prevHop is the endpoint that handed the frame to the relay. Each endpoint
+// keeps copies of the frames it sent; it finds its own (prevHop, seq) in
+// the coded header, xors its copy back out and gets the other frame,
+// patched as if the relay had forwarded it. Frames with no partner within
+// NETCODING_HOLD_MS are forwarded plain. Frames are relayed as received,
+// so this only covers destinations that are the relay's direct neighbors.
+//
+
+#ifndef NETCODING_RELAY_FRAMES
+#define NETCODING_RELAY_FRAMES   8
+#endif
+
+#ifndef NETCODING_RETAIN_FRAMES
+#define NETCODING_RETAIN_FRAMES  4
+#endif
+
+#ifndef NETCODING_HOLD_MS
+#define NETCODING_HOLD_MS        200
+#endif
+
+#define NETCODING_CODED_HEADER_LEN  6
+#define NETCODING_MAX_FRAME_LEN     (SNIPS_FRAME_MAX_PAYLOAD - NETCODING_CODED_HEADER_LEN)
+
+struct NetCodingStats {
+  uint32_t relayIn;
+  uint32_t codedOut;         // coded packets (each carries two frames)
+  uint32_t plainOut;
+  uint32_t decoded;
+  uint32_t notRetained;      // our copy had already been evicted
+  uint32_t malformed;        // coded lengths that cannot hold a frame
+};
+
+struct NetCodingRetained {
+  bool used;
+  uint8_t seq;
+  uint8_t len;
+  uint8_t data[NETCODING_MAX_FRAME_LEN];
+};
+
+struct NetCodingEndpoint {
+  uint8_t self;
+  uint8_t next;
+  NetCodingRetained retained[NETCODING_RETAIN_FRAMES];
+};
+
+// ---------------------------------------------------------------------------
+// Endpoint state
+// ---------------------------------------------------------------------------
+
+void NetCodingEndpoint_init(NetCodingEndpoint* endpoint, uint8_t selfAddress);
+
+// Keeps a copy of a frame the endpoint sent, for decoding.
+void NetCodingEndpoint_retain(NetCodingEndpoint* endpoint, const uint8_t* frame, uint8_t len);
+
+// Recovers the other frame of a CODED packet into out. Returns its length,
+// or 0 if the packet does not involve the endpoint, is malformed or the
+// endpoint's copy is gone.
+uint8_t NetCodingEndpoint_decode(const NetCodingEndpoint* endpoint, const uint8_t* packet, uint8_t len,
+                                 uint8_t* out, NetCodingStats* stats);
+
+// ---------------------------------------------------------------------------
+// Node
+// ---------------------------------------------------------------------------
+
+void NetCoding_begin(uint8_t selfAddress);
+
+// Relay: holds a received frame for coding. False if the frame is too long
+// or the buffer is full; forward it normally then.
+bool NetCoding_relayAdd(const uint8_t* frame, uint8_t len, uint32_t nowMs);
+
+// Relay: next packet to send at nowMs (coded pair, or a frame whose hold
+// expired), or 0.
+uint8_t NetCoding_relayPoll(uint32_t nowMs, uint8_t* out);
+
+// Endpoint: keep a copy of a frame we sent, for decoding.
+void NetCoding_retain(const uint8_t* frame, uint8_t len);
+
+// Endpoint: recovers the other frame of a CODED packet into out. Returns
+// its length, or 0 if the packet does not involve us or our copy is gone.
+uint8_t NetCoding_decode(const uint8_t* packet, uint8_t len, uint8_t* out);
+
+void NetCoding_getStats(NetCodingStats* stats);
@@ -0,0 +1,61 @@
+#include "PositioningBeacon.h"
+
+// ============================================================================
+// BEACON FORMAT
+// ============================================================================
+
+void PositioningBeacon_encode(const PositioningBeacon* beacon, uint8_t* buf) {
+  buf[0] = beacon->mobile;
+  buf[1] = beacon->seq;
+  buf[2] = (uint8_t) beacon->txPowerDbm;
+}
+
+bool PositioningBeacon_decode(const uint8_t* buf, uint8_t len, PositioningBeacon* beacon) {
+  if (len != POSITIONING_BEACON_LEN) {
+    return false;
+  }
+  beacon->mobile = buf[0];
+  beacon->seq = buf[1];
+  beacon->txPowerDbm = (int8_t) buf[2];
+  return true;
+}
+
+// ============================================================================
+// AIRTIME AND SLOTS
+// ============================================================================
+
+void Positioning_pktParams(const sx126x_pkt_params_lora_t* base, sx126x_pkt_params_lora_t* out) {
+  *out = *base;
+  out->header_type = SX126X_LORA_PKT_IMPLICIT;
+  out->pld_len_in_bytes = POSITIONING_BEACON_LEN;
+  out->crc_is_on = true;
+}
+
+uint32_t Positioning_beaconAirUs(const sx126x_pkt_params_lora_t* base, const sx126x_mod_params_lora_t* mod,
+                                 bool implicit) {
+  sx126x_pkt_params_lora_t pkt;
+  Positioning_pktParams(base, &pkt);
+  if (!implicit) {
+    pkt.header_type = SX126X_LORA_PKT_EXPLICIT;
+  }
+  uint64_t numerator = sx126x_get_lora_time_on_air_numerator(&pkt, mod);
+  return (uint32_t) ((numerator * 1000000ULL) / sx126x_get_lora_bw_in_hz(mod->bw));
+}
+
+uint32_t Positioning_headerSavingUs(const sx126x_pkt_params_lora_t* base, const sx126x_mod_params_lora_t* mod) {
+  return Positioning_beaconAirUs(base, mod, false) - Positioning_beaconAirUs(base, mod, true);
+}
+
+uint32_t Positioning_slotUs(const sx126x_pkt_params_lora_t* base, const sx126x_mod_params_lora_t* mod,
+                            bool implicit) {
+  return Positioning_beaconAirUs(base, mod, implicit) + POSITIONING_GUARD_US;
+}
+
+uint8_t Positioning_slotCount(uint16_t controlMs, const sx126x_pkt_params_lora_t* base,
+                              const sx126x_mod_params_lora_t* mod, bool implicit) {
+  if (controlMs <= POSITIONING_MGMT_MS) {
+    return 0;
+  }
+  uint32_t slots = (uint32_t) (controlMs - POSITIONING_MGMT_MS) * 1000 / Positioning_slotUs(base, mod, implicit);
+  return slots > POSITIONING_MAX_SLOTS ? POSITIONING_MAX_SLOTS : (uint8_t) slots;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include "sx126x.h"
+
+// ============================================================================
+// FIXED-FORMAT POSITIONING BEACONS (IMPLICIT LORA HEADER)
+// ============================================================================
+//
+// Mobiles send one beacon each in their positioning slot at the start of
+// the Control phase; every anchor in range timestamps it (DIO1) for TDOA.
+// The beacon has a fixed length, so it goes with an implicit LoRa header:
+// both ends already know length, coding rate and CRC, and the explicit
+// header (20 bits coded at CR 4/8) is dropped from every beacon.
+//
+//  byte 0  mobile address
+//  byte 1  beacon sequence (matches the timestamps of one beacon across
+//          anchors)
+//  byte 2  TX power, dBm (signed)
+//
+// The window holds as many POSITIONING_GUARD_US-padded slots as fit in the
+// Control phase minus POSITIONING_MGMT_MS, which stays free for explicit
+// management frames, up to POSITIONING_MAX_SLOTS.
+//
+
+#define POSITIONING_BEACON_LEN   3
+
+#ifndef POSITIONING_GUARD_US
+#define POSITIONING_GUARD_US     2000      // sync error + TX ramp per slot
+#endif
+
+#ifndef POSITIONING_MGMT_MS
+#define POSITIONING_MGMT_MS      40
+#endif
+
+#define POSITIONING_MAX_SLOTS    32
+
+struct PositioningBeacon {
+  uint8_t mobile;
+  uint8_t seq;
+  int8_t txPowerDbm;
+};
+
+void PositioningBeacon_encode(const PositioningBeacon* beacon, uint8_t* buf);
+bool PositioningBeacon_decode(const uint8_t* buf, uint8_t len, PositioningBeacon* beacon);
+
+// Beacon packet params: base preamble and IQ, implicit header, fixed
+// length, CRC on.
+void Positioning_pktParams(const sx126x_pkt_params_lora_t* base, sx126x_pkt_params_lora_t* out);
+
+uint32_t Positioning_beaconAirUs(const sx126x_pkt_params_lora_t* base, const sx126x_mod_params_lora_t* mod,
+                                 bool implicit);
+
+// Airtime an implicit header saves on one beacon against an explicit one.
+uint32_t Positioning_headerSavingUs(const sx126x_pkt_params_lora_t* base, const sx126x_mod_params_lora_t* mod);
+
+uint32_t Positioning_slotUs(const sx126x_pkt_params_lora_t* base, const sx126x_mod_params_lora_t* mod,
+                            bool implicit);
+
+// Positioning slots (mobiles positioned per superframe) in a Control phase
+// of controlMs.
+uint8_t Positioning_slotCount(uint16_t controlMs, const sx126x_pkt_params_lora_t* base,
+                              const sx126x_mod_params_lora_t* mod, bool implicit);
@@ -0,0 +1,111 @@
+#include "PositioningRadio.h"
+#include "SnipsRadio.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static uint8_t self = 0;
+static PositioningBeaconHandler beaconHandler = nullptr;
+static PositioningRadioStats stats;
+static bool inWindow = false;
+
+// ============================================================================
+// RADIO TASK HOOKS
+// ============================================================================
+
+static bool onBeacon(const SnipsRxPacket* pkt) {
+  PositioningBeacon beacon;
+  if (!PositioningBeacon_decode(pkt->data, pkt->len, &beacon)) {
+    stats.malformed++;
+    return true;
+  }
+  stats.beaconsReceived++;
+  beaconHandler(&beacon, pkt->dio1Us, pkt->status.rssi_pkt_in_dbm);
+  return true;
+}
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool enterWindow() {
+  const SnipsLoraConfig* cfg = SnipsRadio_loraConfig();
+
+  SnipsRadio_lock();
+  bool ok = sx126x_set_lora_mod_params(SnipsRadio_context(), &cfg->mod) == SX126X_STATUS_OK;
+  if (beaconHandler != nullptr) {
+    sx126x_pkt_params_lora_t pkt;
+    Positioning_pktParams(&cfg->pkt, &pkt);
+    ok &= SnipsRadio_beginRxProfile(&pkt, onBeacon);
+  }
+  SnipsRadio_unlock();
+  return ok;
+}
+
+static bool leaveWindow() {
+  return beaconHandler == nullptr || SnipsRadio_endRxProfile();
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool PositioningRadio_begin(uint8_t selfAddress, PositioningBeaconHandler handler) {
+  self = selfAddress;
+  beaconHandler = handler;
+  inWindow = false;
+  memset(&stats, 0, sizeof(stats));
+  return true;
+}
+
+void PositioningRadio_update(const TdmaPosition* position, const TdmaLayout* layout) {
+  uint32_t windowEnd = PositioningRadio_slotStartMs(layout, PositioningRadio_slotCount(layout));
+  bool inside = position->phase == TDMA_PHASE_CONTROL && position->offsetMs < windowEnd;
+
+  if (inside && !inWindow) {
+    inWindow = enterWindow();
+    stats.windows += inWindow;
+  } else if (!inside && inWindow) {
+    inWindow = !leaveWindow();
+  }
+}
+
+bool PositioningRadio_inWindow() {
+  return inWindow;
+}
+
+uint8_t PositioningRadio_slotCount(const TdmaLayout* layout) {
+  const SnipsLoraConfig* cfg = SnipsRadio_loraConfig();
+  return Positioning_slotCount(layout->controlMs, &cfg->pkt, &cfg->mod, true);
+}
+
+uint32_t PositioningRadio_slotStartMs(const TdmaLayout* layout, uint8_t slot) {
+  const SnipsLoraConfig* cfg = SnipsRadio_loraConfig();
+  return layout->syncMs + (slot * Positioning_slotUs(&cfg->pkt, &cfg->mod, true)) / 1000;
+}
+
+bool PositioningRadio_sendBeacon(uint8_t seq) {
+  const SnipsLoraConfig* cfg = SnipsRadio_loraConfig();
+  if (!inWindow) {
+    return false;
+  }
+
+  PositioningBeacon beacon = { self, seq, cfg->txPowerDbm };
+  uint8_t buf[POSITIONING_BEACON_LEN];
+  PositioningBeacon_encode(&beacon, buf);
+
+  sx126x_pkt_params_lora_t pkt;
+  Positioning_pktParams(&cfg->pkt, &pkt);
+  uint32_t timeoutMs = Positioning_beaconAirUs(&cfg->pkt, &cfg->mod, true) / 1000 + 10;
+  if (!SnipsRadio_transmitWith(&pkt, buf, timeoutMs)) {
+    return false;
+  }
+  stats.beaconsSent++;
+  return true;
+}
+
+void PositioningRadio_getStats(PositioningRadioStats* out) {
+  *out = stats;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "PositioningBeacon.h"
+#include "TdmaTimeline.h"
+
+// ============================================================================
+// POSITIONING RADIO BINDING
+// ============================================================================
+//
+// The TDMA slot loop passes every timeline position to
+// PositioningRadio_update. On entry to the positioning window the radio
+// goes back to the base LoRa modulation (a data cell may have left another
+// SF set) and anchors switch reception to the implicit beacon profile; on
+// exit the configured packet params come back. While the profile is on,
+// every packet is treated as a beacon and no SNIPS frame is received.
+//
+// Mobiles call PositioningRadio_sendBeacon at the start of their slot
+// (slot index assigned by the master, PositioningRadio_slotStartMs).
+//
+
+// Called from the radio task with the radio lock held; dio1Us is the
+// RX_DONE timestamp of SnipsRxPacket.
+typedef void (*PositioningBeaconHandler)(const PositioningBeacon* beacon, uint32_t dio1Us, int8_t rssiDbm);
+
+struct PositioningRadioStats {
+  uint32_t beaconsSent;
+  uint32_t beaconsReceived;
+  uint32_t malformed;
+  uint32_t windows;
+};
+
+// handler is null on mobiles (no beacon reception).
+bool PositioningRadio_begin(uint8_t selfAddress, PositioningBeaconHandler handler);
+
+void PositioningRadio_update(const TdmaPosition* position, const TdmaLayout* layout);
+bool PositioningRadio_inWindow();
+
+uint8_t PositioningRadio_slotCount(const TdmaLayout* layout);
+
+// Offset of a positioning slot from the start of the superframe.
+uint32_t PositioningRadio_slotStartMs(const TdmaLayout* layout, uint8_t slot);
+
+bool PositioningRadio_sendBeacon(uint8_t seq);
+
+void PositioningRadio_getStats(PositioningRadioStats* stats);
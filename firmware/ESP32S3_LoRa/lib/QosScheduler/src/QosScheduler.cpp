@@ -0,0 +1,194 @@
+#include "QosScheduler.h"
+#include "SfDivision.h"
+#include "SnipsRadio.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct QosEntry {
+  uint8_t len;
+  uint8_t data[SNIPS_FRAME_MAX_LEN];
+};
+
+struct QosQueue {
+  QosEntry entries[QOS_QUEUE_DEPTH];
+  uint8_t head;
+  uint8_t count;
+  uint16_t quantumMs;
+  uint32_t deficitMs;
+};
+
+static QosQueue queues[QOS_CLASS_COUNT];
+static uint16_t headToaMs[QOS_CLASS_COUNT];   // at the SF of the current dequeue
+static uint8_t drrClass = SNIPS_CLASS_POSITIONING;
+static bool drrCredited = false;     // drrClass already got its quantum this turn
+
+static portMUX_TYPE qosMux = portMUX_INITIALIZER_UNLOCKED;
+static QosStats stats;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+// Time on air of every class's head frame. Call with qosMux held.
+static void measureHeads(const sx126x_mod_params_lora_t* mod) {
+  sx126x_pkt_params_lora_t pkt = SnipsRadio_loraConfig()->pkt;
+  for (uint8_t cls = 0; cls < QOS_CLASS_COUNT; cls++) {
+    const QosQueue* q = &queues[cls];
+    if (q->count > 0) {
+      pkt.pld_len_in_bytes = q->entries[q->head].len;
+      headToaMs[cls] = sx126x_get_lora_time_on_air_in_ms(&pkt, mod);
+    }
+  }
+}
+
+static bool headFits(uint8_t cls, uint16_t budgetMs) {
+  return queues[cls].count > 0 && headToaMs[cls] <= budgetMs;
+}
+
+static void pop(uint8_t cls, uint8_t* buf, uint8_t* len, uint16_t* toaMs) {
+  QosQueue* q = &queues[cls];
+  const QosEntry& entry = q->entries[q->head];
+  memcpy(buf, entry.data, entry.len);
+  *len = entry.len;
+  *toaMs = headToaMs[cls];
+  q->head = (q->head + 1) % QOS_QUEUE_DEPTH;
+  q->count--;
+  stats.sent[cls]++;
+}
+
+static void nextDrrClass() {
+  drrClass = drrClass == SNIPS_CLASS_MANAGEMENT ? SNIPS_CLASS_POSITIONING : drrClass + 1;
+  drrCredited = false;
+}
+
+// Weighted DRR over the non-Emergency classes other than owner. Deficits
+// carry over between calls.
+static bool dequeueDrr(uint8_t owner, uint16_t budgetMs, uint8_t* buf, uint8_t* len, uint16_t* toaMs) {
+  bool anyFits = false;
+  for (uint8_t cls = SNIPS_CLASS_POSITIONING; cls <= SNIPS_CLASS_MANAGEMENT; cls++) {
+    anyFits |= cls != owner && headFits(cls, budgetMs);
+  }
+  if (!anyFits) {
+    return false;
+  }
+
+  // Terminates: every visit to a class whose head fits adds a quantum, and
+  // the cap is never below that head
+  while (true) {
+    QosQueue* q = &queues[drrClass];
+    if (drrClass == owner || q->count == 0) {
+      q->deficitMs = 0;
+      nextDrrClass();
+      continue;
+    }
+
+    uint16_t toa = headToaMs[drrClass];
+    if (!drrCredited) {
+      // A head that keeps missing the budget must not bank credit for a
+      // later burst: never more than one quantum beyond it.
+      q->deficitMs += q->quantumMs;
+      if (q->deficitMs > (uint32_t) q->quantumMs + toa) {
+        q->deficitMs = (uint32_t) q->quantumMs + toa;
+      }
+      drrCredited = true;
+    }
+
+    if (toa <= q->deficitMs && toa <= budgetMs) {
+      q->deficitMs -= toa;
+      pop(drrClass, buf, len, toaMs);
+      stats.borrowedMs += toa;
+      return true;
+    }
+    nextDrrClass();
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void QosScheduler_begin() {
+  memset(queues, 0, sizeof(queues));
+  memset(&stats, 0, sizeof(stats));
+  QosScheduler_setWeight(SNIPS_CLASS_POSITIONING, 2);
+  QosScheduler_setWeight(SNIPS_CLASS_DATA, 1);
+  QosScheduler_setWeight(SNIPS_CLASS_MANAGEMENT, 1);
+  drrClass = SNIPS_CLASS_POSITIONING;
+  drrCredited = false;
+}
+
+void QosScheduler_setWeight(SnipsTrafficClass cls, uint8_t weight) {
+  if (cls < QOS_CLASS_COUNT) {
+    queues[cls].quantumMs = (weight > 0 ? weight : 1) * QOS_QUANTUM_MS;
+  }
+}
+
+bool QosScheduler_enqueue(SnipsTrafficClass cls, const uint8_t* frame, uint8_t len) {
+  if (cls >= QOS_CLASS_COUNT) {
+    return false;
+  }
+
+  portENTER_CRITICAL(&qosMux);
+  QosQueue* q = &queues[cls];
+  bool ok = q->count < QOS_QUEUE_DEPTH;
+  if (ok) {
+    QosEntry& entry = q->entries[(q->head + q->count) % QOS_QUEUE_DEPTH];
+    memcpy(entry.data, frame, len);
+    entry.len = len;
+    q->count++;
+    stats.enqueued[cls]++;
+  } else {
+    stats.dropped[cls]++;
+  }
+  portEXIT_CRITICAL(&qosMux);
+
+  return ok;
+}
+
+bool QosScheduler_dequeue(SnipsTrafficClass owner, uint16_t budgetMs, uint8_t sf, uint8_t* buf, uint8_t* len,
+                          uint16_t* toaMs) {
+  bool found = true;
+  const sx126x_mod_params_lora_t* base = &SnipsRadio_loraConfig()->mod;
+  sx126x_mod_params_lora_t mod;
+  SfDivision_modParams(base, sf == QOS_SF_CONFIGURED ? (uint8_t) base->sf : sf, &mod);
+
+  portENTER_CRITICAL(&qosMux);
+  measureHeads(&mod);
+  if (headFits(SNIPS_CLASS_EMERGENCY, budgetMs)) {
+    pop(SNIPS_CLASS_EMERGENCY, buf, len, toaMs);
+  } else if (owner != SNIPS_CLASS_EMERGENCY && headFits(owner, budgetMs)) {
+    pop(owner, buf, len, toaMs);
+  } else {
+    found = dequeueDrr(owner, budgetMs, buf, len, toaMs);
+  }
+
+  // Every frame leaving the node reports what is still queued behind it,
+  // for the master's slot reservation
+  if (found && *len >= SNIPS_FRAME_HEADER_LEN && buf[0] == SNIPS_NETWORK_ID) {
+    uint8_t flags = buf[SNIPS_FRAME_OFFSET_FLAGS];
+    buf[SNIPS_FRAME_OFFSET_FLAGS] = SnipsFrame_flagsWithQueue(flags, QosScheduler_totalDepth());
+  }
+  portEXIT_CRITICAL(&qosMux);
+
+  return found;
+}
+
+uint8_t QosScheduler_depth(SnipsTrafficClass cls) {
+  return cls < QOS_CLASS_COUNT ? queues[cls].count : 0;
+}
+
+uint8_t QosScheduler_totalDepth() {
+  uint8_t total = 0;
+  for (uint8_t cls = 0; cls < QOS_CLASS_COUNT; cls++) {
+    total += queues[cls].count;
+  }
+  return total;
+}
+
+void QosScheduler_getStats(QosStats* out) {
+  portENTER_CRITICAL(&qosMux);
+  *out = stats;
+  portEXIT_CRITICAL(&qosMux);
+}
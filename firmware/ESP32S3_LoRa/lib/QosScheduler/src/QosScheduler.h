@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include "SnipsFrame.h"
+
+// ============================================================================
+// QOS EGRESS SCHEDULER
+// ============================================================================
+//
+// One queue per traffic class. When the node gets air time (its slot, or a
+// phase owned by a class) it asks for frames that fit the time left:
+//
+//   1. Emergency, strict priority, in any phase.
+//   2. The class that owns the phase (e.g. Positioning in the positioning
+//      phase, Data in a data slot).
+//   3. Deficit round-robin over the remaining classes, weighted by their
+//      quantum, so idle owned time is borrowed instead of wasted.
+//
+// Time on air is taken from sx126x_get_lora_time_on_air_in_ms() at dequeue,
+// at the SF the frame goes out on (a TSCH / SF-division cell's own SF), so
+// frames are packed into the time left rather than one per slot and DRR is
+// charged what the frame really costs. The configured preamble is assumed,
+// which a shorter slot preamble only undercuts.
+//
+// An Emergency frame waits at most until the node's next air time of any
+// kind. A class's deficit is capped at one quantum beyond its head frame,
+// so a head that keeps missing the time left cannot bank credit for a later
+// burst.
+//
+// Every dequeued SNIPS frame gets the depth still queued behind it
+// (QosScheduler_totalDepth) in its flags, see SnipsFrame_flagsWithQueue.
+//
+
+#ifndef QOS_QUEUE_DEPTH
+#define QOS_QUEUE_DEPTH       8
+#endif
+
+#ifndef QOS_QUANTUM_MS
+#define QOS_QUANTUM_MS        20
+#endif
+
+#define QOS_CLASS_COUNT       4
+#define QOS_SF_CONFIGURED     0      // the configured modulation, as TSCH_SF_DEFAULT
+
+struct QosStats {
+  uint32_t enqueued[QOS_CLASS_COUNT];
+  uint32_t sent[QOS_CLASS_COUNT];
+  uint32_t dropped[QOS_CLASS_COUNT];   // queue full
+  uint32_t borrowedMs;                 // air time used outside the owner class
+};
+
+// Quantum weights default to Positioning 2, Data 1, Management 1.
+void QosScheduler_begin();
+void QosScheduler_setWeight(SnipsTrafficClass cls, uint8_t weight);
+
+// Copies the frame into the class queue. False if the queue is full.
+bool QosScheduler_enqueue(SnipsTrafficClass cls, const uint8_t* frame, uint8_t len);
+
+// Next frame that fits in budgetMs of the phase owned by owner, sent at sf
+// (sx126x_lora_sf_t, or QOS_SF_CONFIGURED). Copies it into buf
+// (SNIPS_FRAME_MAX_LEN bytes) and returns its length and time on air; false
+// if nothing fits.
+bool QosScheduler_dequeue(SnipsTrafficClass owner, uint16_t budgetMs, uint8_t sf, uint8_t* buf, uint8_t* len,
+                          uint16_t* toaMs);
+
+uint8_t QosScheduler_depth(SnipsTrafficClass cls);
+uint8_t QosScheduler_totalDepth();
+void QosScheduler_getStats(QosStats* stats);
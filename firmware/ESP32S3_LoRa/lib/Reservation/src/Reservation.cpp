@@ -0,0 +1,141 @@
+#include "Reservation.h"
+#include "SnipsFrame.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static uint8_t demand[256];
+static uint8_t slotCount = TDMA_DATA_SLOTS;
+static uint8_t roundStart = 0;     // rotates so ties do not favor low addresses
+static ReservationStats stats;
+
+// ============================================================================
+// MASTER
+// ============================================================================
+
+void Reservation_begin(uint8_t slots) {
+  memset(demand, 0, sizeof(demand));
+  memset(&stats, 0, sizeof(stats));
+  slotCount = slots <= TDMA_DATA_SLOTS ? slots : TDMA_DATA_SLOTS;
+  roundStart = 0;
+}
+
+void Reservation_reportDemand(uint8_t node, uint8_t queueDepth) {
+  demand[node] = queueDepth;
+  stats.reports++;
+}
+
+bool Reservation_onFrame(const uint8_t* frame, uint8_t len) {
+  if (len < SNIPS_FRAME_HEADER_LEN || frame[0] != SNIPS_NETWORK_ID) {
+    return false;
+  }
+  // An ACK or announcement says nothing about the sender's queue; taking
+  // its zero bits would take the sender's slots away
+  if (!SnipsFrame_hasQueueDepth(frame)) {
+    stats.noDepth++;
+    return false;
+  }
+  Reservation_reportDemand(frame[SNIPS_FRAME_OFFSET_PREV_HOP], SnipsFrame_queueDepth(frame));
+  return true;
+}
+
+void Reservation_compute(uint16_t superframe, ReservationMap* map) {
+  uint8_t granted[TDMA_DATA_SLOTS];
+  uint8_t nodes[TDMA_DATA_SLOTS];
+  uint8_t active = 0;
+
+  // Backlogged nodes in rotated address order; at most one per slot can win
+  for (uint16_t i = 0; i < 256 && active < slotCount; i++) {
+    uint8_t node = (uint8_t) (roundStart + i);
+    if (demand[node] > 0) {
+      nodes[active] = node;
+      granted[active] = 0;
+      active++;
+    }
+  }
+
+  // Water-filling: one slot per still-hungry node per round
+  uint8_t remaining = slotCount;
+  bool progress = true;
+  while (remaining > 0 && progress) {
+    progress = false;
+    for (uint8_t k = 0; k < active && remaining > 0; k++) {
+      if (granted[k] < demand[nodes[k]]) {
+        granted[k]++;
+        remaining--;
+        progress = true;
+      }
+    }
+  }
+
+  map->superframe = superframe;
+  map->count = 0;
+  for (uint8_t k = 0; k < active; k++) {
+    map->runs[map->count].node = nodes[k];
+    map->runs[map->count].slots = granted[k];
+    map->count++;
+    // Assume the granted frames go out; the next report corrects this
+    demand[nodes[k]] -= granted[k];
+  }
+
+  roundStart = active > 0 ? (uint8_t) (nodes[active - 1] + 1) : roundStart;
+  stats.mapsComputed++;
+  stats.lastSlotsGranted = slotCount - remaining;
+  stats.lastNodesServed = active;
+}
+
+void Reservation_getStats(ReservationStats* out) {
+  *out = stats;
+}
+
+// ============================================================================
+// MAP ENCODING
+// ============================================================================
+
+uint8_t Reservation_encodeMap(const ReservationMap* map, uint8_t* buf, uint8_t maxLen) {
+  uint16_t len = RESERVATION_MAP_HEADER_LEN + 2 * map->count;
+  if (len > maxLen) {
+    return 0;
+  }
+
+  buf[0] = map->superframe & 0xFF;
+  buf[1] = map->superframe >> 8;
+  buf[2] = map->count;
+  for (uint8_t i = 0; i < map->count; i++) {
+    buf[RESERVATION_MAP_HEADER_LEN + 2 * i] = map->runs[i].node;
+    buf[RESERVATION_MAP_HEADER_LEN + 2 * i + 1] = map->runs[i].slots;
+  }
+  return len;
+}
+
+bool Reservation_decodeMap(const uint8_t* buf, uint8_t len, ReservationMap* map) {
+  if (len < RESERVATION_MAP_HEADER_LEN || buf[2] > TDMA_DATA_SLOTS ||
+      len < RESERVATION_MAP_HEADER_LEN + 2 * buf[2]) {
+    return false;
+  }
+
+  uint16_t total = 0;
+  map->superframe = buf[0] | (buf[1] << 8);
+  map->count = buf[2];
+  for (uint8_t i = 0; i < map->count; i++) {
+    map->runs[i].node = buf[RESERVATION_MAP_HEADER_LEN + 2 * i];
+    map->runs[i].slots = buf[RESERVATION_MAP_HEADER_LEN + 2 * i + 1];
+    total += map->runs[i].slots;
+  }
+  return total <= TDMA_DATA_SLOTS;
+}
+
+bool Reservation_slotsFor(const ReservationMap* map, uint8_t node, uint8_t* firstSlot, uint8_t* count) {
+  uint8_t slot = 0;
+  for (uint8_t i = 0; i < map->count; i++) {
+    if (map->runs[i].node == node) {
+      *firstSlot = slot;
+      *count = map->runs[i].slots;
+      return map->runs[i].slots > 0;
+    }
+    slot += map->runs[i].slots;
+  }
+  return false;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include "Tdma.h"
+
+// ============================================================================
+// DEMAND-DRIVEN SLOT RESERVATION
+// ============================================================================
+//
+// Frames sent through the QosScheduler carry their sender's queue depth in
+// the flags (see SnipsFrame_flagsWithQueue). The TDMA master keeps the latest depth per
+// node and, at the start of each superframe, shares the data slots out
+// max-min fairly: one slot per backlogged node per round until the slots
+// or the demand run out. Nodes with an empty queue get no slot and report
+// new demand in the Control phase.
+//
+// The map is broadcast in the Sync beacon (ReservationRadio_buildBeacon)
+// as contiguous runs in slot order:
+//
+//  byte 0-1  superframe number (little endian)
+//  byte 2    run count n
+//  byte 3+   n x { node, slot count }
+//
+
+#define RESERVATION_MAP_HEADER_LEN  3
+#define RESERVATION_MAP_MAX_LEN     (RESERVATION_MAP_HEADER_LEN + 2 * TDMA_DATA_SLOTS)
+
+struct ReservationRun {
+  uint8_t node;
+  uint8_t slots;
+};
+
+struct ReservationMap {
+  uint16_t superframe;
+  uint8_t count;
+  ReservationRun runs[TDMA_DATA_SLOTS];
+};
+
+struct ReservationStats {
+  uint32_t reports;
+  uint32_t noDepth;            // frames without a stamped queue depth
+  uint32_t mapsComputed;
+  uint8_t lastSlotsGranted;
+  uint8_t lastNodesServed;
+};
+
+// Master side
+void Reservation_begin(uint8_t slots);
+void Reservation_reportDemand(uint8_t node, uint8_t queueDepth);
+
+// Takes the demand of a received SNIPS frame's link transmitter, if the
+// frame carries a stamped depth (SNIPS_FLAG_QUEUE_VALID). True if it did.
+bool Reservation_onFrame(const uint8_t* frame, uint8_t len);
+
+void Reservation_compute(uint16_t superframe, ReservationMap* map);
+void Reservation_getStats(ReservationStats* stats);
+
+// Both sides. encode returns the bytes written (0 if maxLen is too small);
+// decode rejects maps that overrun the data phase.
+uint8_t Reservation_encodeMap(const ReservationMap* map, uint8_t* buf, uint8_t maxLen);
+bool Reservation_decodeMap(const uint8_t* buf, uint8_t len, ReservationMap* map);
+
+// First slot and slot count of node in map. False if node has no slot.
+bool Reservation_slotsFor(const ReservationMap* map, uint8_t node, uint8_t* firstSlot, uint8_t* count);
@@ -0,0 +1,82 @@
+#include "ReservationRadio.h"
+#include "SnipsFrame.h"
+#include "SnipsRadio.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static ReservationMap currentMap;
+static bool haveMap = false;
+static portMUX_TYPE mapMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// RX HOOK
+// ============================================================================
+
+// Single-byte stores: a report racing Reservation_compute() only skews one
+// superframe's estimate.
+static bool onRxDone(const SnipsRxPacket* pkt) {
+  if (pkt->len < SNIPS_FRAME_HEADER_LEN || pkt->data[0] != SNIPS_NETWORK_ID) {
+    return false;
+  }
+
+  if (SnipsFrame_type(pkt->data) == SNIPS_FRAME_SYNC) {
+    ReservationMap map;
+    if (Reservation_decodeMap(pkt->data + SNIPS_FRAME_HEADER_LEN, pkt->len - SNIPS_FRAME_HEADER_LEN, &map)) {
+      portENTER_CRITICAL(&mapMux);
+      currentMap = map;
+      haveMap = true;
+      portEXIT_CRITICAL(&mapMux);
+    }
+    return false;
+  }
+
+  Reservation_onFrame(pkt->data, pkt->len);
+  return false;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool ReservationRadio_attach() {
+  portENTER_CRITICAL(&mapMux);
+  haveMap = false;
+  portEXIT_CRITICAL(&mapMux);
+  return SnipsRadio_addRxHook(onRxDone);
+}
+
+uint8_t ReservationRadio_buildBeacon(uint8_t self, uint16_t superframe, uint8_t* frame, uint8_t maxLen) {
+  if (maxLen < SNIPS_FRAME_HEADER_LEN) {
+    return 0;
+  }
+
+  ReservationMap map;
+  Reservation_compute(superframe, &map);
+  uint8_t mapLen = Reservation_encodeMap(&map, frame + SNIPS_FRAME_HEADER_LEN, maxLen - SNIPS_FRAME_HEADER_LEN);
+  if (mapLen == 0) {
+    return 0;
+  }
+
+  SnipsFrameHeader header = {};
+  header.netId = SNIPS_NETWORK_ID;
+  header.type = SNIPS_FRAME_SYNC;
+  header.trafficClass = SNIPS_CLASS_MANAGEMENT;
+  header.src = self;
+  header.dst = SNIPS_ADDR_BROADCAST;
+  header.prevHop = self;
+  header.nextHop = SNIPS_ADDR_BROADCAST;
+  SnipsFrame_encodeHeader(&header, frame);
+  return SNIPS_FRAME_HEADER_LEN + mapLen;
+}
+
+bool ReservationRadio_currentMap(ReservationMap* map) {
+  portENTER_CRITICAL(&mapMux);
+  bool ok = haveMap;
+  if (ok) {
+    *map = currentMap;
+  }
+  portEXIT_CRITICAL(&mapMux);
+  return ok;
+}
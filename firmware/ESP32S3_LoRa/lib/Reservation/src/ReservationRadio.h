@@ -0,0 +1,27 @@
+#pragma once
+#include "Reservation.h"
+
+// ============================================================================
+// RESERVATION RADIO BINDING
+// ============================================================================
+//
+// Registers an RX hook that, on the TDMA master, feeds the queue depth of
+// every received SNIPS frame into Reservation (Reservation_onFrame) and, on
+// the other nodes, keeps the map of the latest Sync beacon. The hook never
+// consumes the packet.
+//
+// The queue depth in the flags is written by QosScheduler_dequeue, so only
+// frames sent through the QosScheduler report demand; ACKs and other frames
+// built around it carry no depth and leave the last report in place.
+//
+
+bool ReservationRadio_attach();
+
+// Master side: computes the map for superframe and builds the Sync beacon
+// carrying it (SNIPS header + encoded map) into frame. Returns the frame
+// length, or 0 if maxLen is too small. Further Sync fields (the
+// TdmaTimeline announcement) may follow the map.
+uint8_t ReservationRadio_buildBeacon(uint8_t self, uint16_t superframe, uint8_t* frame, uint8_t maxLen);
+
+// Map of the latest Sync beacon received. False if none has been heard.
+bool ReservationRadio_currentMap(ReservationMap* map);
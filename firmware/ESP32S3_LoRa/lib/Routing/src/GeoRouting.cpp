@@ -0,0 +1,305 @@
+#include "GeoRouting.h"
+#include <math.h>
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct GeoLocation {
+  uint8_t node;
+  GeoPoint pos;
+  bool used;
+};
+
+static GeoNeighbor neighbors[GEO_MAX_NEIGHBORS];
+static uint8_t neighborCount = 0;
+static GeoLocation locations[GEO_MAX_LOCATIONS];
+static uint8_t nextLocation = 0;      // round-robin replacement
+static GeoPoint position = { 0, 0 };
+static uint8_t self = 0;
+
+// ============================================================================
+// GEOMETRY
+// ============================================================================
+
+static int64_t distSq(GeoPoint a, GeoPoint b) {
+  int64_t dx = (int64_t) a.x - b.x;
+  int64_t dy = (int64_t) a.y - b.y;
+  return dx * dx + dy * dy;
+}
+
+static float distF(float ax, float ay, GeoPoint b) {
+  return hypotf(ax - b.x, ay - b.y);
+}
+
+static float bearing(GeoPoint from, GeoPoint to) {
+  return atan2f((float) (to.y - from.y), (float) (to.x - from.x));
+}
+
+// Gabriel graph: keep u-v unless another neighbor w lies inside the circle
+// with diameter u-v. Doubled coordinates keep the test in integers.
+static bool planarEdge(GeoPoint u, GeoPoint v, const GeoNeighbor* table, uint8_t count) {
+  int64_t diameterSq = distSq(u, v);
+  for (uint8_t i = 0; i < count; i++) {
+    GeoPoint w = table[i].pos;
+    if ((w.x == v.x && w.y == v.y) || (w.x == u.x && w.y == u.y)) {
+      continue;
+    }
+    int64_t dx = 2 * (int64_t) w.x - u.x - v.x;
+    int64_t dy = 2 * (int64_t) w.y - u.y - v.y;
+    if (dx * dx + dy * dy < diameterSq) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// First planar edge counterclockwise about self from the reference bearing.
+static uint8_t rightHand(GeoPoint self, float refBearing, const GeoNeighbor* table, uint8_t count) {
+  uint8_t best = GEO_NO_ROUTE;
+  float bestAngle = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!planarEdge(self, table[i].pos, table, count)) {
+      continue;
+    }
+    float angle = bearing(self, table[i].pos) - refBearing;
+    while (angle <= 1e-4f) {
+      angle += 2 * (float) M_PI;
+    }
+    while (angle > 2 * (float) M_PI + 1e-4f) {
+      angle -= 2 * (float) M_PI;
+    }
+    if (best == GEO_NO_ROUTE || angle < bestAngle) {
+      best = i;
+      bestAngle = angle;
+    }
+  }
+  return best;
+}
+
+// Where segment a-b crosses segment c-d, if it does.
+static bool crossing(GeoPoint a, GeoPoint b, GeoPoint c, GeoPoint d, float* x, float* y) {
+  float rx = b.x - a.x;
+  float ry = b.y - a.y;
+  float sx = d.x - c.x;
+  float sy = d.y - c.y;
+  float denom = rx * sy - ry * sx;
+  if (fabsf(denom) < 1e-6f) {
+    return false;
+  }
+  float qx = c.x - a.x;
+  float qy = c.y - a.y;
+  float t = (qx * sy - qy * sx) / denom;
+  float u = (qx * ry - qy * rx) / denom;
+  if (t <= 1e-4f || t > 1.0f || u < 0.0f || u > 1.0f) {
+    return false;
+  }
+  *x = a.x + t * rx;
+  *y = a.y + t * ry;
+  return true;
+}
+
+static int8_t findNeighbor(const GeoNeighbor* table, uint8_t count, uint8_t addr) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (table[i].addr == addr) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// ============================================================================
+// FORWARDING
+// ============================================================================
+
+void GeoHeader_init(GeoHeader* header, GeoPoint dest) {
+  memset(header, 0, sizeof(*header));
+  header->dest = dest;
+  header->mode = GEO_MODE_GREEDY;
+  header->e0From = GEO_NO_ROUTE;
+  header->e0To = GEO_NO_ROUTE;
+}
+
+static void putPoint(uint8_t* buf, GeoPoint p) {
+  buf[0] = (uint16_t) p.x & 0xFF;
+  buf[1] = (uint16_t) p.x >> 8;
+  buf[2] = (uint16_t) p.y & 0xFF;
+  buf[3] = (uint16_t) p.y >> 8;
+}
+
+static GeoPoint getPoint(const uint8_t* buf) {
+  GeoPoint p;
+  p.x = (int16_t) (buf[0] | (buf[1] << 8));
+  p.y = (int16_t) (buf[2] | (buf[3] << 8));
+  return p;
+}
+
+void GeoHeader_encode(const GeoHeader* header, uint8_t* buf) {
+  putPoint(buf, header->dest);
+  buf[4] = header->mode;
+  putPoint(buf + 5, header->lp);
+  putPoint(buf + 9, header->lf);
+  buf[13] = header->e0From;
+  buf[14] = header->e0To;
+}
+
+void GeoHeader_decode(const uint8_t* buf, GeoHeader* header) {
+  header->dest = getPoint(buf);
+  header->mode = buf[4];
+  header->lp = getPoint(buf + 5);
+  header->lf = getPoint(buf + 9);
+  header->e0From = buf[13];
+  header->e0To = buf[14];
+}
+
+// Each time the candidate edge crosses Lp-D closer to D than the face was
+// entered, the walk moves onto the next face.
+static uint8_t faceChange(uint8_t selfAddr, GeoPoint self, const GeoNeighbor* table, uint8_t count,
+                          uint8_t next, GeoHeader* header) {
+  for (uint8_t guard = 0; guard < count && next != GEO_NO_ROUTE; guard++) {
+    float ix;
+    float iy;
+    if (!crossing(self, table[next].pos, header->lp, header->dest, &ix, &iy)) {
+      break;
+    }
+    GeoPoint lf = header->lf;
+    if (distF(ix, iy, header->dest) >= distF(lf.x, lf.y, header->dest) - 1.0f) {
+      break;
+    }
+    header->lf.x = (int16_t) lroundf(ix);
+    header->lf.y = (int16_t) lroundf(iy);
+    next = rightHand(self, bearing(self, table[next].pos), table, count);
+    header->e0From = selfAddr;
+    header->e0To = next != GEO_NO_ROUTE ? table[next].addr : GEO_NO_ROUTE;
+  }
+  return next;
+}
+
+uint8_t GeoRouting_choose(uint8_t selfAddr, GeoPoint self, const GeoNeighbor* table,
+                          uint8_t count, uint8_t dst, uint8_t prevHop, GeoHeader* header) {
+  int8_t direct = findNeighbor(table, count, dst);
+  if (direct >= 0) {
+    return dst;
+  }
+
+  int64_t ownDist = distSq(self, header->dest);
+  if (header->mode == GEO_MODE_PERIMETER && ownDist < distSq(header->lp, header->dest)) {
+    header->mode = GEO_MODE_GREEDY;
+  }
+
+  if (header->mode == GEO_MODE_GREEDY) {
+    uint8_t best = GEO_NO_ROUTE;
+    int64_t bestDist = ownDist;
+    for (uint8_t i = 0; i < count; i++) {
+      int64_t d = distSq(table[i].pos, header->dest);
+      if (d < bestDist) {
+        best = i;
+        bestDist = d;
+      }
+    }
+    if (best != GEO_NO_ROUTE) {
+      return table[best].addr;
+    }
+
+    // Local minimum: enter perimeter mode
+    header->mode = GEO_MODE_PERIMETER;
+    header->lp = self;
+    header->lf = self;
+    uint8_t next = rightHand(self, bearing(self, header->dest), table, count);
+    if (next == GEO_NO_ROUTE) {
+      return GEO_NO_ROUTE;
+    }
+    header->e0From = selfAddr;
+    header->e0To = table[next].addr;
+    next = faceChange(selfAddr, self, table, count, next, header);
+    return next != GEO_NO_ROUTE ? table[next].addr : GEO_NO_ROUTE;
+  }
+
+  int8_t from = findNeighbor(table, count, prevHop);
+  float ref = from >= 0 ? bearing(self, table[from].pos) : bearing(self, header->dest);
+  uint8_t next = rightHand(self, ref, table, count);
+  next = faceChange(selfAddr, self, table, count, next, header);
+  if (next == GEO_NO_ROUTE) {
+    return GEO_NO_ROUTE;
+  }
+  if (selfAddr == header->e0From && table[next].addr == header->e0To) {
+    return GEO_NO_ROUTE;      // walked the whole face: unreachable
+  }
+  return table[next].addr;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void GeoRouting_begin(uint8_t selfAddress) {
+  memset(neighbors, 0, sizeof(neighbors));
+  memset(locations, 0, sizeof(locations));
+  neighborCount = 0;
+  nextLocation = 0;
+  self = selfAddress;
+}
+
+void GeoRouting_setPosition(GeoPoint pos) {
+  position = pos;
+}
+
+void GeoRouting_encodeBeacon(uint8_t* buf) {
+  putPoint(buf, position);
+}
+
+void GeoRouting_onBeacon(uint8_t from, const uint8_t* buf, uint32_t nowMs) {
+  GeoPoint pos = getPoint(buf);
+  GeoRouting_learnLocation(from, pos);
+
+  int8_t i = findNeighbor(neighbors, neighborCount, from);
+  if (i < 0) {
+    if (neighborCount >= GEO_MAX_NEIGHBORS) {
+      return;
+    }
+    i = neighborCount++;
+    neighbors[i].addr = from;
+  }
+  neighbors[i].pos = pos;
+  neighbors[i].lastSeenMs = nowMs;
+}
+
+void GeoRouting_learnLocation(uint8_t node, GeoPoint pos) {
+  for (uint8_t i = 0; i < GEO_MAX_LOCATIONS; i++) {
+    if (locations[i].used && locations[i].node == node) {
+      locations[i].pos = pos;
+      return;
+    }
+  }
+  GeoLocation& slot = locations[nextLocation];
+  nextLocation = (nextLocation + 1) % GEO_MAX_LOCATIONS;
+  slot.used = true;
+  slot.node = node;
+  slot.pos = pos;
+}
+
+bool GeoRouting_locationOf(uint8_t node, GeoPoint* pos) {
+  for (uint8_t i = 0; i < GEO_MAX_LOCATIONS; i++) {
+    if (locations[i].used && locations[i].node == node) {
+      *pos = locations[i].pos;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint8_t GeoRouting_nextHop(uint8_t dst, uint8_t prevHop, GeoHeader* header, uint32_t nowMs) {
+  for (uint8_t i = 0; i < neighborCount;) {
+    if (nowMs - neighbors[i].lastSeenMs > GEO_NEIGHBOR_TIMEOUT_MS) {
+      neighbors[i] = neighbors[--neighborCount];
+    } else {
+      i++;
+    }
+  }
+  return GeoRouting_choose(self, position, neighbors, neighborCount, dst, prevHop, header);
+}
+
+uint8_t GeoRouting_neighborCount() {
+  return neighborCount;
+}
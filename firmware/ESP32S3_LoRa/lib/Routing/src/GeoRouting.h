@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// GEOGRAPHIC FORWARDING (GREEDY + PERIMETER)
+// ============================================================================
+//
+// GPSR over the positions the network already has: anchors know their
+// surveyed coordinates and mobiles their latest positioning fix. Every
+// node announces its position in a 4-byte hello and keeps its neighbors'
+// positions plus a small cache of destinations, so routing state is
+// O(neighbors) and no per-route path is discovered. A destination that is
+// neither a neighbor nor cached still needs its position looked up (by the
+// application; GeoSim counts a flooded request and a geographic reply).
+//
+// A frame carrying SNIPS_FLAG_GEO starts its payload with a GeoHeader
+// holding the destination's position. Each hop forwards greedily to the
+// neighbor closest to it. At a local minimum the frame switches to
+// perimeter mode and walks the face of the Gabriel-planarized neighbor
+// graph by the right-hand rule until it reaches a node closer to the
+// destination than where it got stuck, then resumes greedy forwarding.
+//
+// Coordinates are signed meters in the site frame.
+//
+
+#ifndef GEO_MAX_NEIGHBORS
+#define GEO_MAX_NEIGHBORS       16
+#endif
+
+#ifndef GEO_MAX_LOCATIONS
+#define GEO_MAX_LOCATIONS       32       // destination position cache
+#endif
+
+#ifndef GEO_NEIGHBOR_TIMEOUT_MS
+#define GEO_NEIGHBOR_TIMEOUT_MS 30000    // a few hello periods
+#endif
+
+#define GEO_HEADER_LEN          15
+#define GEO_BEACON_LEN          4
+#define GEO_NO_ROUTE            0xFF
+
+struct GeoPoint {
+  int16_t x;
+  int16_t y;
+};
+
+struct GeoNeighbor {
+  uint8_t addr;
+  GeoPoint pos;
+  uint32_t lastSeenMs;
+};
+
+enum GeoMode : uint8_t {
+  GEO_MODE_GREEDY = 0,
+  GEO_MODE_PERIMETER,
+};
+
+struct GeoHeader {
+  GeoPoint dest;
+  uint8_t mode;
+  GeoPoint lp;               // where perimeter mode was entered
+  GeoPoint lf;               // where the current face was entered
+  uint8_t e0From;            // first perimeter edge on the current face
+  uint8_t e0To;
+};
+
+void GeoHeader_init(GeoHeader* header, GeoPoint dest);
+void GeoHeader_encode(const GeoHeader* header, uint8_t* buf);
+void GeoHeader_decode(const uint8_t* buf, GeoHeader* header);
+
+// Forwarding decision at node self (address selfAddr) for a frame to dst
+// that arrived from prevHop, updating the header's mode state. Returns
+// the next hop, or GEO_NO_ROUTE if the destination is unreachable (the
+// perimeter walk came back to its first edge).
+uint8_t GeoRouting_choose(uint8_t selfAddr, GeoPoint self, const GeoNeighbor* neighbors,
+                          uint8_t count, uint8_t dst, uint8_t prevHop, GeoHeader* header);
+
+// ---------------------------------------------------------------------------
+// Node state
+// ---------------------------------------------------------------------------
+
+void GeoRouting_begin(uint8_t selfAddress);
+
+// Surveyed coordinates (anchors) or the latest fix (mobiles).
+void GeoRouting_setPosition(GeoPoint pos);
+
+void GeoRouting_encodeBeacon(uint8_t* buf);
+void GeoRouting_onBeacon(uint8_t from, const uint8_t* buf, uint32_t nowMs);
+
+// Position of a possible destination (heard in a beacon or a fix report).
+void GeoRouting_learnLocation(uint8_t node, GeoPoint pos);
+bool GeoRouting_locationOf(uint8_t node, GeoPoint* pos);
+
+// Next hop for a frame, dropping neighbors not heard within the timeout.
+uint8_t GeoRouting_nextHop(uint8_t dst, uint8_t prevHop, GeoHeader* header, uint32_t nowMs);
+
+uint8_t GeoRouting_neighborCount();
@@ -0,0 +1,319 @@
+#include "Routing.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct RoutingLink {
+  uint8_t neighbor;
+  int8_t snrDb;
+  uint16_t distanceM;
+  uint16_t cost;
+};
+
+struct RoutingNode {
+  RoutingLink links[ROUTING_MAX_LINKS];
+  uint8_t linkCount;
+  uint8_t energy;
+  int8_t observedSnr;        // EWMA, local links only
+  bool observed;
+};
+
+static RoutingNode nodes[ROUTING_MAX_NODES];
+static uint16_t dist[ROUTING_MAX_NODES];
+static uint8_t parent[ROUTING_MAX_NODES];
+static bool queued[ROUTING_MAX_NODES];
+static uint8_t self = 0;
+static RoutingStats stats;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static RoutingLink* findLink(uint8_t a, uint8_t b) {
+  for (uint8_t i = 0; i < nodes[a].linkCount; i++) {
+    if (nodes[a].links[i].neighbor == b) {
+      return &nodes[a].links[i];
+    }
+  }
+  return nullptr;
+}
+
+static uint16_t linkCost(uint8_t a, uint8_t b, int8_t snrDb, uint16_t distanceM) {
+  uint16_t cost = ROUTING_W_HOP;
+  if (snrDb < ROUTING_SNR_GOOD_DB) {
+    cost += ROUTING_W_QUALITY * (ROUTING_SNR_GOOD_DB - snrDb);
+  }
+  cost += ROUTING_W_ENERGY * ((200 - nodes[a].energy - nodes[b].energy) / 10);
+  cost += ROUTING_W_DISTANCE * (distanceM / 100);
+  return cost;
+}
+
+static void setCost(uint8_t a, uint8_t b, uint16_t cost) {
+  findLink(a, b)->cost = cost;
+  findLink(b, a)->cost = cost;
+}
+
+// Settles queued nodes in cost order, relaxing their links.
+static void runDijkstra() {
+  while (true) {
+    uint8_t u = ROUTING_NO_ROUTE;
+    for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+      if (queued[n] && (u == ROUTING_NO_ROUTE || dist[n] < dist[u])) {
+        u = n;
+      }
+    }
+    if (u == ROUTING_NO_ROUTE) {
+      return;
+    }
+    queued[u] = false;
+    stats.nodesSettled++;
+
+    for (uint8_t i = 0; i < nodes[u].linkCount; i++) {
+      const RoutingLink& link = nodes[u].links[i];
+      uint32_t candidate = (uint32_t) dist[u] + link.cost;
+      if (candidate < dist[link.neighbor]) {
+        dist[link.neighbor] = candidate;
+        parent[link.neighbor] = u;
+        queued[link.neighbor] = true;
+      }
+    }
+  }
+}
+
+static void decreased(uint8_t a, uint8_t b, uint16_t cost) {
+  for (uint8_t k = 0; k < 2; k++) {
+    uint8_t u = k == 0 ? a : b;
+    uint8_t v = k == 0 ? b : a;
+    if (dist[u] != ROUTING_INFINITY && (uint32_t) dist[u] + cost < dist[v]) {
+      dist[v] = dist[u] + cost;
+      parent[v] = u;
+      queued[v] = true;
+    }
+  }
+  runDijkstra();
+}
+
+// The tree link above `root` got dearer or vanished: detach root's subtree
+// and let each of its nodes re-attach through its best outside neighbor.
+static void increased(uint8_t root) {
+  static bool affected[ROUTING_MAX_NODES];
+  memset(affected, 0, sizeof(affected));
+  affected[root] = true;
+
+  bool grew = true;
+  while (grew) {
+    grew = false;
+    for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+      if (!affected[n] && parent[n] != ROUTING_NO_ROUTE && affected[parent[n]]) {
+        affected[n] = true;
+        grew = true;
+      }
+    }
+  }
+
+  for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+    if (affected[n]) {
+      dist[n] = ROUTING_INFINITY;
+      parent[n] = ROUTING_NO_ROUTE;
+    }
+  }
+
+  for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+    if (!affected[n]) {
+      continue;
+    }
+    for (uint8_t i = 0; i < nodes[n].linkCount; i++) {
+      const RoutingLink& link = nodes[n].links[i];
+      if (affected[link.neighbor] || dist[link.neighbor] == ROUTING_INFINITY) {
+        continue;
+      }
+      uint32_t candidate = (uint32_t) dist[link.neighbor] + link.cost;
+      if (candidate < dist[n]) {
+        dist[n] = candidate;
+        parent[n] = link.neighbor;
+        queued[n] = true;
+      }
+    }
+  }
+  runDijkstra();
+}
+
+static void applyCost(uint8_t a, uint8_t b, uint16_t oldCost, uint16_t newCost) {
+  setCost(a, b, newCost);
+  stats.incrementalUpdates++;
+  if (newCost < oldCost) {
+    decreased(a, b, newCost);
+  } else if (parent[b] == a) {
+    increased(b);
+  } else if (parent[a] == b) {
+    increased(a);
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void Routing_begin(uint8_t selfAddress) {
+  memset(nodes, 0, sizeof(nodes));
+  memset(queued, 0, sizeof(queued));
+  memset(&stats, 0, sizeof(stats));
+  for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+    nodes[n].energy = 100;
+    dist[n] = ROUTING_INFINITY;
+    parent[n] = ROUTING_NO_ROUTE;
+  }
+  self = selfAddress;
+  dist[self] = 0;
+}
+
+void Routing_updateLink(uint8_t a, uint8_t b, int8_t snrDb, uint16_t distanceM) {
+  if (a >= ROUTING_MAX_NODES || b >= ROUTING_MAX_NODES || a == b) {
+    return;
+  }
+
+  uint16_t cost = linkCost(a, b, snrDb, distanceM);
+  RoutingLink* ab = findLink(a, b);
+  if (ab == nullptr) {
+    if (nodes[a].linkCount >= ROUTING_MAX_LINKS || nodes[b].linkCount >= ROUTING_MAX_LINKS) {
+      return;
+    }
+    nodes[a].links[nodes[a].linkCount++] = { b, snrDb, distanceM, ROUTING_INFINITY };
+    nodes[b].links[nodes[b].linkCount++] = { a, snrDb, distanceM, ROUTING_INFINITY };
+    applyCost(a, b, ROUTING_INFINITY, cost);
+    return;
+  }
+
+  ab->snrDb = snrDb;
+  ab->distanceM = distanceM;
+  RoutingLink* ba = findLink(b, a);
+  ba->snrDb = snrDb;
+  ba->distanceM = distanceM;
+
+  uint16_t old = ab->cost;
+  if ((cost > old ? cost - old : old - cost) < ROUTING_HYSTERESIS) {
+    stats.ignoredChanges++;
+    return;
+  }
+  applyCost(a, b, old, cost);
+}
+
+void Routing_removeLink(uint8_t a, uint8_t b) {
+  if (a >= ROUTING_MAX_NODES || b >= ROUTING_MAX_NODES || findLink(a, b) == nullptr) {
+    return;
+  }
+
+  for (uint8_t k = 0; k < 2; k++) {
+    RoutingNode& node = nodes[k == 0 ? a : b];
+    uint8_t other = k == 0 ? b : a;
+    for (uint8_t i = 0; i < node.linkCount; i++) {
+      if (node.links[i].neighbor == other) {
+        node.links[i] = node.links[--node.linkCount];
+        break;
+      }
+    }
+  }
+
+  stats.incrementalUpdates++;
+  if (parent[b] == a) {
+    increased(b);
+  } else if (parent[a] == b) {
+    increased(a);
+  }
+}
+
+void Routing_observe(uint8_t neighbor, int8_t snrDb) {
+  if (neighbor >= ROUTING_MAX_NODES) {
+    return;
+  }
+  RoutingNode& node = nodes[neighbor];
+  node.observedSnr = node.observed ? (int8_t) ((3 * (int16_t) node.observedSnr + snrDb) / 4) : snrDb;
+  node.observed = true;
+
+  RoutingLink* link = findLink(self, neighbor);
+  Routing_updateLink(self, neighbor, node.observedSnr, link != nullptr ? link->distanceM : 0);
+}
+
+void Routing_setEnergy(uint8_t node, uint8_t percent) {
+  if (node >= ROUTING_MAX_NODES) {
+    return;
+  }
+  nodes[node].energy = percent <= 100 ? percent : 100;
+  for (uint8_t i = 0; i < nodes[node].linkCount; i++) {
+    const RoutingLink link = nodes[node].links[i];
+    Routing_updateLink(node, link.neighbor, link.snrDb, link.distanceM);
+  }
+}
+
+uint8_t Routing_nextHop(uint8_t dest) {
+  if (dest >= ROUTING_MAX_NODES || dist[dest] == ROUTING_INFINITY || dest == self) {
+    return ROUTING_NO_ROUTE;
+  }
+  while (parent[dest] != self) {
+    dest = parent[dest];
+  }
+  return dest;
+}
+
+uint16_t Routing_cost(uint8_t dest) {
+  return dest < ROUTING_MAX_NODES ? dist[dest] : ROUTING_INFINITY;
+}
+
+uint8_t Routing_hops(uint8_t dest) {
+  if (dest >= ROUTING_MAX_NODES || dist[dest] == ROUTING_INFINITY) {
+    return ROUTING_NO_ROUTE;
+  }
+  uint8_t hops = 0;
+  while (dest != self) {
+    dest = parent[dest];
+    hops++;
+  }
+  return hops;
+}
+
+void Routing_recomputeAll() {
+  for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+    dist[n] = ROUTING_INFINITY;
+    parent[n] = ROUTING_NO_ROUTE;
+    queued[n] = false;
+  }
+  dist[self] = 0;
+  queued[self] = true;
+  stats.fullRecomputes++;
+  runDijkstra();
+}
+
+void Routing_referenceCosts(uint16_t* costs) {
+  static bool settled[ROUTING_MAX_NODES];
+  for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+    costs[n] = ROUTING_INFINITY;
+    settled[n] = false;
+  }
+  costs[self] = 0;
+
+  while (true) {
+    uint8_t u = ROUTING_NO_ROUTE;
+    for (uint8_t n = 0; n < ROUTING_MAX_NODES; n++) {
+      if (!settled[n] && costs[n] != ROUTING_INFINITY && (u == ROUTING_NO_ROUTE || costs[n] < costs[u])) {
+        u = n;
+      }
+    }
+    if (u == ROUTING_NO_ROUTE) {
+      return;
+    }
+    settled[u] = true;
+    for (uint8_t i = 0; i < nodes[u].linkCount; i++) {
+      const RoutingLink& link = nodes[u].links[i];
+      uint32_t candidate = (uint32_t) costs[u] + link.cost;
+      if (candidate < costs[link.neighbor]) {
+        costs[link.neighbor] = candidate;
+      }
+    }
+  }
+}
+
+void Routing_getStats(RoutingStats* out) {
+  *out = stats;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// MULTI-METRIC ROUTING (DYNAMIC SHORTEST-PATH TREE)
+// ============================================================================
+//
+// Link-state routing for anchors and the relay. Every router holds the
+// network graph and a shortest-path tree rooted at itself. Local links are
+// measured from packet status (RoutingRadio); this library has no
+// link-state advert of its own, so links between other nodes only enter
+// the graph through Routing_updateLink / Routing_removeLink from whatever
+// distributes them. A link's cost combines:
+//
+//   hop        ROUTING_W_HOP per link
+//   quality    ROUTING_W_QUALITY per dB of SNR below ROUTING_SNR_GOOD_DB
+//   energy     ROUTING_W_ENERGY per 10 % of battery used at either end
+//   distance   ROUTING_W_DISTANCE per 100 m, when known
+//
+// A link change only touches the part of the tree it can affect: a cheaper
+// link relaxes outward from its far end, and a dearer or lost tree link
+// re-roots just the subtree below it (Ramalingam-Reps style). That subtree
+// then attaches to its cheapest surviving neighbors, which is also how
+// routes heal. Node addresses index the tables directly, so they must be
+// below ROUTING_MAX_NODES.
+//
+// The tables are not locked: make every call from one task (the
+// application task, see RoutingRadio_poll).
+//
+
+#ifndef ROUTING_MAX_NODES
+#define ROUTING_MAX_NODES        64
+#endif
+
+#ifndef ROUTING_MAX_LINKS
+#define ROUTING_MAX_LINKS        8       // per node
+#endif
+
+#define ROUTING_W_HOP            16
+#define ROUTING_W_QUALITY        4
+#define ROUTING_W_ENERGY         2
+#define ROUTING_W_DISTANCE       1
+
+#define ROUTING_SNR_GOOD_DB      5
+#define ROUTING_HYSTERESIS       4       // cost change that triggers an update
+
+#define ROUTING_INFINITY         0xFFFF
+#define ROUTING_NO_ROUTE         0xFF
+
+struct RoutingStats {
+  uint32_t incrementalUpdates;
+  uint32_t fullRecomputes;
+  uint32_t nodesSettled;       // Dijkstra pops, summed over all updates
+  uint32_t ignoredChanges;     // below the hysteresis
+};
+
+void Routing_begin(uint8_t selfAddress);
+
+// Link a <-> b seen with snrDb (distance 0 if unknown). Adds the link if new.
+void Routing_updateLink(uint8_t a, uint8_t b, int8_t snrDb, uint16_t distanceM);
+void Routing_removeLink(uint8_t a, uint8_t b);
+
+// Local link measurement from sx126x_get_lora_pkt_status(); smoothed
+// before it reaches the graph.
+void Routing_observe(uint8_t neighbor, int8_t snrDb);
+
+// Battery level 0-100 % of node (defaults to 100).
+void Routing_setEnergy(uint8_t node, uint8_t percent);
+
+uint8_t Routing_nextHop(uint8_t dest);
+uint16_t Routing_cost(uint8_t dest);
+uint8_t Routing_hops(uint8_t dest);
+
+// Full Dijkstra from scratch, replacing the incrementally kept tree.
+void Routing_recomputeAll();
+
+// Full Dijkstra over the current graph into costs[ROUTING_MAX_NODES],
+// leaving the tree alone: the reference to check the incremental updates
+// against.
+void Routing_referenceCosts(uint16_t* costs);
+
+void Routing_getStats(RoutingStats* stats);
@@ -0,0 +1,80 @@
+#include "RoutingRadio.h"
+#include "SnipsFrame.h"
+#include "SnipsRadio.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct RoutingObservation {
+  uint8_t neighbor;
+  int8_t snrDb;
+};
+
+static RoutingObservation pending[ROUTING_RADIO_PENDING];
+static uint8_t pendingHead = 0;
+static uint8_t pendingCount = 0;
+static uint32_t dropped = 0;
+static portMUX_TYPE pendingMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// RX HOOK
+// ============================================================================
+
+static bool onRxDone(const SnipsRxPacket* pkt) {
+  if (pkt->len < SNIPS_FRAME_HEADER_LEN || pkt->data[0] != SNIPS_NETWORK_ID) {
+    return false;
+  }
+
+  portENTER_CRITICAL(&pendingMux);
+  if (pendingCount < ROUTING_RADIO_PENDING) {
+    RoutingObservation& obs = pending[(pendingHead + pendingCount) % ROUTING_RADIO_PENDING];
+    obs.neighbor = pkt->data[SNIPS_FRAME_OFFSET_PREV_HOP];
+    obs.snrDb = pkt->status.snr_pkt_in_db;
+    pendingCount++;
+  } else {
+    dropped++;
+  }
+  portEXIT_CRITICAL(&pendingMux);
+  return false;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool RoutingRadio_attach() {
+  portENTER_CRITICAL(&pendingMux);
+  pendingHead = 0;
+  pendingCount = 0;
+  dropped = 0;
+  portEXIT_CRITICAL(&pendingMux);
+  return SnipsRadio_addRxHook(onRxDone);
+}
+
+uint8_t RoutingRadio_poll() {
+  uint8_t applied = 0;
+  while (true) {
+    portENTER_CRITICAL(&pendingMux);
+    bool any = pendingCount > 0;
+    RoutingObservation obs = pending[pendingHead];
+    if (any) {
+      pendingHead = (pendingHead + 1) % ROUTING_RADIO_PENDING;
+      pendingCount--;
+    }
+    portEXIT_CRITICAL(&pendingMux);
+
+    if (!any) {
+      return applied;
+    }
+    Routing_observe(obs.neighbor, obs.snrDb);
+    applied++;
+  }
+}
+
+uint32_t RoutingRadio_dropped() {
+  portENTER_CRITICAL(&pendingMux);
+  uint32_t count = dropped;
+  portEXIT_CRITICAL(&pendingMux);
+  return count;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "Routing.h"
+
+// ============================================================================
+// ROUTING RADIO BINDING
+// ============================================================================
+//
+// Registers an RX hook that records the packet SNR of every received SNIPS
+// frame as a measurement of the link to its previous hop. The hook never
+// consumes the packet and never touches the routing tables: an update can
+// run Dijkstra over the whole graph, which must not happen in the radio
+// task with the radio lock held. The application task applies the recorded
+// measurements through RoutingRadio_poll(), and makes every other Routing_
+// call from that same task.
+//
+
+#ifndef ROUTING_RADIO_PENDING
+#define ROUTING_RADIO_PENDING  16
+#endif
+
+bool RoutingRadio_attach();
+
+// Feeds the measurements recorded since the last call into Routing_observe.
+// Returns how many were applied.
+uint8_t RoutingRadio_poll();
+
+// Measurements lost because the application did not poll in time.
+uint32_t RoutingRadio_dropped();
@@ -0,0 +1,156 @@
+#include "SfDivision.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define SF_COUNT  (SX126X_LORA_SF12 - SX126X_LORA_SF5 + 1)
+
+// Required SIR (dB), row = wanted SF5..SF12, column = interferer SF5..SF12
+static const int8_t isolation[SF_COUNT][SF_COUNT] = {
+  {   1,  -6,  -6,  -6,  -6,  -6,  -6,  -6 },
+  {  -7,   1,  -7,  -7,  -7,  -7,  -7,  -7 },
+  {  -8,  -8,   1,  -8,  -9,  -9,  -9,  -9 },
+  { -11, -11, -11,   1, -11, -12, -13, -13 },
+  { -15, -15, -15, -13,   1, -13, -14, -15 },
+  { -19, -19, -19, -18, -17,   1, -17, -18 },
+  { -22, -22, -22, -22, -21, -20,   1, -20 },
+  { -25, -25, -25, -25, -25, -24, -23,   1 },
+};
+
+static SfDivisionRssiFn rssiOf = nullptr;
+static uint8_t sfMin = SX126X_LORA_SF7;
+static uint8_t sfMax = SX126X_LORA_SF12;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool sfValid(uint8_t sf) {
+  return sf >= SX126X_LORA_SF5 && sf <= SX126X_LORA_SF12;
+}
+
+static bool sirOk(const TschCell* victim, const TschCell* other) {
+  int16_t signal = rssiOf(victim->tx, victim->rx);
+  int16_t interference = rssiOf(other->tx, victim->rx);
+  return signal - interference >= SfDivision_isolationDb(victim->sf, other->sf) + SF_DIVISION_SIR_MARGIN_DB;
+}
+
+static bool fitsWith(const TschSchedule* schedule, const TschCell* candidate) {
+  for (uint16_t i = 0; i < schedule->cellCount; i++) {
+    const TschCell& cell = schedule->cells[i];
+    if (cell.slot == candidate->slot && cell.channelOffset == candidate->channelOffset &&
+        !SfDivision_canShare(candidate, &cell)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void SfDivision_begin(SfDivisionRssiFn rssi, uint8_t minSf, uint8_t maxSf) {
+  rssiOf = rssi;
+  sfMin = sfValid(minSf) ? minSf : (uint8_t) SX126X_LORA_SF5;
+  sfMax = sfValid(maxSf) && maxSf >= sfMin ? maxSf : (uint8_t) SX126X_LORA_SF12;
+}
+
+int16_t SfDivision_snrFloorTenthDb(uint8_t sf) {
+  // -2.5 dB at SF5, 2.5 dB lower per SF step
+  return -25 * (int16_t) (sf - SX126X_LORA_SF5 + 1);
+}
+
+int8_t SfDivision_isolationDb(uint8_t wanted, uint8_t interferer) {
+  if (!sfValid(wanted) || !sfValid(interferer)) {
+    return isolation[0][0];
+  }
+  return isolation[wanted - SX126X_LORA_SF5][interferer - SX126X_LORA_SF5];
+}
+
+uint8_t SfDivision_sfForLink(uint8_t tx, uint8_t rx) {
+  int16_t snrTenths = (rssiOf(tx, rx) - SF_DIVISION_NOISE_FLOOR_DBM) * 10;
+  for (uint8_t sf = sfMin; sf <= sfMax; sf++) {
+    if (snrTenths >= SfDivision_snrFloorTenthDb(sf) + SF_DIVISION_MARGIN_DB * 10) {
+      return sf;
+    }
+  }
+  return SF_DIVISION_NO_SF;
+}
+
+bool SfDivision_canShare(const TschCell* a, const TschCell* b) {
+  if (a->sf == b->sf || !sfValid(a->sf) || !sfValid(b->sf)) {
+    return false;
+  }
+  return sirOk(a, b) && sirOk(b, a);
+}
+
+uint8_t SfDivision_assign(TschSchedule* schedule, uint8_t tx, uint8_t rx, uint8_t cellsWanted) {
+  uint8_t budgetSf = SfDivision_sfForLink(tx, rx);
+  if (budgetSf == SF_DIVISION_NO_SF) {
+    return 0;
+  }
+
+  uint8_t granted = 0;
+  for (uint8_t c = 0; c < cellsWanted && schedule->cellCount < TSCH_MAX_CELLS; c++) {
+    uint8_t preferred = (uint16_t) c * schedule->slots / cellsWanted;
+    bool placed = false;
+
+    // Pass 0 takes free cell positions; pass 1 shares one on a distinct SF
+    for (uint8_t pass = 0; pass < 2 && !placed; pass++) {
+      for (uint8_t probe = 0; probe < schedule->slots && !placed; probe++) {
+        uint8_t slot = (preferred + probe) % schedule->slots;
+        if (TschSchedule_cellFor(schedule, slot, tx) != TSCH_NO_CELL ||
+            TschSchedule_cellFor(schedule, slot, rx) != TSCH_NO_CELL) {
+          continue;
+        }
+
+        for (uint8_t offset = 0; offset < schedule->channels && !placed; offset++) {
+          bool used = schedule->channelUse[slot] & (1 << offset);
+          if (used != (pass == 1)) {
+            continue;
+          }
+
+          for (uint8_t sf = budgetSf; sf <= sfMax; sf++) {
+            TschCell candidate = { slot, offset, tx, rx, sf };
+            if (used && !fitsWith(schedule, &candidate)) {
+              continue;
+            }
+            schedule->cells[schedule->cellCount++] = candidate;
+            schedule->channelUse[slot] |= 1 << offset;
+            placed = true;
+            break;
+          }
+        }
+      }
+    }
+
+    if (placed) {
+      granted++;
+    }
+  }
+
+  return granted;
+}
+
+void SfDivision_modParams(const sx126x_mod_params_lora_t* base, uint8_t sf, sx126x_mod_params_lora_t* out) {
+  *out = *base;
+  out->sf = (sx126x_lora_sf_t) sf;
+
+  // LDRO is mandatory once a symbol lasts 16.38 ms or more
+  uint32_t symbolUs = (uint32_t) ((1000000ULL << sf) / sx126x_get_lora_bw_in_hz(base->bw));
+  out->ldro = symbolUs >= 16380 ? 1 : 0;
+}
+
+uint8_t SfDivision_maxSfForSlot(const sx126x_mod_params_lora_t* mod, const sx126x_pkt_params_lora_t* pkt,
+                                uint32_t slotMs) {
+  for (uint8_t sf = SX126X_LORA_SF12; sf >= SX126X_LORA_SF5; sf--) {
+    sx126x_mod_params_lora_t candidate;
+    SfDivision_modParams(mod, sf, &candidate);
+    if (sx126x_get_lora_time_on_air_in_ms(pkt, &candidate) <= slotMs) {
+      return sf;
+    }
+  }
+  return SF_DIVISION_NO_SF;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include "sx126x.h"
+#include "Tsch.h"
+
+// ============================================================================
+// QUASI-ORTHOGONAL SPREADING-FACTOR DIVISION
+// ============================================================================
+//
+// Frames at different spreading factors mostly survive each other, so the
+// TDMA master may put several links on one slot and channel offset as long
+// as their SFs differ and the signal-to-interference ratio at each receiver
+// beats the inter-SF isolation threshold. Each link starts at the lowest SF
+// its budget closes, and is moved up only to get a distinct SF.
+//
+// Isolation thresholds for SF7-SF12 follow Croce et al. (2018); the SF5 and
+// SF6 entries are extrapolated. A higher SF must still fit the data slot:
+// see SfDivision_maxSfForSlot().
+//
+
+#ifndef SF_DIVISION_NOISE_FLOOR_DBM
+#define SF_DIVISION_NOISE_FLOOR_DBM  -117    // BW125, 6 dB noise figure
+#endif
+
+#ifndef SF_DIVISION_MARGIN_DB
+#define SF_DIVISION_MARGIN_DB        5       // fade margin over the SNR floor
+#endif
+
+#ifndef SF_DIVISION_SIR_MARGIN_DB
+#define SF_DIVISION_SIR_MARGIN_DB    3       // margin over the isolation threshold
+#endif
+
+#define SF_DIVISION_NO_SF            0
+
+// Mean RSSI (dBm) of `from` at `at`; the master's neighbor table.
+typedef int16_t (*SfDivisionRssiFn)(uint8_t from, uint8_t at);
+
+void SfDivision_begin(SfDivisionRssiFn rssi, uint8_t minSf, uint8_t maxSf);
+
+// Demodulation SNR floor of sf in tenths of a dB (SX1262 datasheet).
+int16_t SfDivision_snrFloorTenthDb(uint8_t sf);
+
+// Minimum SIR (dB) for a frame at `wanted` to survive one at `interferer`.
+int8_t SfDivision_isolationDb(uint8_t wanted, uint8_t interferer);
+
+// Lowest SF in range that closes the tx -> rx budget, or SF_DIVISION_NO_SF.
+uint8_t SfDivision_sfForLink(uint8_t tx, uint8_t rx);
+
+// True if cells a and b may be on air together on the same channel.
+bool SfDivision_canShare(const TschCell* a, const TschCell* b);
+
+// Like TschSchedule_assign(), but once the slot x channel grid is full the
+// link may share a cell position with others on a distinct SF.
+uint8_t SfDivision_assign(TschSchedule* schedule, uint8_t tx, uint8_t rx, uint8_t cellsWanted);
+
+// base with sf replaced and low-data-rate optimization set to match.
+void SfDivision_modParams(const sx126x_mod_params_lora_t* base, uint8_t sf, sx126x_mod_params_lora_t* out);
+
+// Highest SF whose frame of pkt->pld_len_in_bytes fits in slotMs, or
+// SF_DIVISION_NO_SF.
+uint8_t SfDivision_maxSfForSlot(const sx126x_mod_params_lora_t* mod, const sx126x_pkt_params_lora_t* pkt,
+                                uint32_t slotMs);
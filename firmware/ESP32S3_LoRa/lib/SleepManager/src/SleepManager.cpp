@@ -0,0 +1,136 @@
+#include "SleepManager.h"
+#include "SnipsRadio.h"
+#include "sx126x_regs.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct RetainedStep {
+  SleepManagerStep step;
+  uint16_t address;
+};
+
+static const RetainedStep steps[] = {
+  { SLEEP_STEP_RX_BOOSTED, SX126X_REG_RXGAIN },
+  { SLEEP_STEP_TX_MODULATION, SX126X_REG_TX_MODULATION },
+  { SLEEP_STEP_TX_CLAMP, SX126X_REG_TX_CLAMP_CFG },
+};
+
+#define SLEEP_STEP_COUNT (sizeof(steps) / sizeof(steps[0]))
+
+static bool rxBoostedEnabled = false;
+static SleepManagerStats stats;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool applyStep(const void* ctx, SleepManagerStep step) {
+  switch (step) {
+    case SLEEP_STEP_RX_BOOSTED:
+      return sx126x_cfg_rx_boosted(ctx, rxBoostedEnabled) == SX126X_STATUS_OK;
+    case SLEEP_STEP_TX_MODULATION:
+      return sx126x_tx_modulation_workaround(ctx, SX126X_PKT_TYPE_LORA,
+                                             SnipsRadio_loraConfig()->mod.bw) == SX126X_STATUS_OK;
+    case SLEEP_STEP_TX_CLAMP:
+      return sx126x_cfg_tx_clamp(ctx) == SX126X_STATUS_OK;
+  }
+  return false;
+}
+
+// Reads the retention list back and maps it onto the step mask, so steps are
+// only skipped if the chip really retains their register.
+static uint8_t readRetainedSteps(const void* ctx) {
+  uint8_t list[1 + 2 * SX126X_MAX_NB_REG_IN_RETENTION];
+  if (sx126x_read_register(ctx, SX126X_REG_RETENTION_LIST_BASE_ADDRESS, list, sizeof(list)) != SX126X_STATUS_OK) {
+    return 0;
+  }
+
+  uint8_t mask = 0;
+  uint8_t count = list[0] <= SX126X_MAX_NB_REG_IN_RETENTION ? list[0] : 0;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t address = ((uint16_t) list[1 + 2 * i] << 8) | list[2 + 2 * i];
+    for (uint8_t s = 0; s < SLEEP_STEP_COUNT; s++) {
+      if (steps[s].address == address) {
+        mask |= steps[s].step;
+      }
+    }
+  }
+  return mask;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool SleepManager_begin(bool rxBoosted) {
+  const void* ctx = SnipsRadio_context();
+  rxBoostedEnabled = rxBoosted;
+  memset(&stats, 0, sizeof(stats));
+  stats.minWakeUs = UINT32_MAX;
+
+  bool ok = true;
+
+  SnipsRadio_lock();
+  for (uint8_t s = 0; s < SLEEP_STEP_COUNT; s++) {
+    ok &= applyStep(ctx, steps[s].step);
+  }
+
+  // The driver adds a batch all or nothing: with the list full it returns
+  // ERROR and writes nothing (UNKNOWN_VALUE if the list reads back corrupt).
+  // One register per call keeps those that fit; the rest, and everything
+  // after a failure, is replayed on wake. The read-back below decides.
+  for (uint8_t s = 0; s < SLEEP_STEP_COUNT; s++) {
+    if (sx126x_add_registers_to_retention_list(ctx, &steps[s].address, 1) != SX126X_STATUS_OK) {
+      break;
+    }
+  }
+  stats.retainedSteps = readRetainedSteps(ctx);
+  SnipsRadio_unlock();
+
+  return ok;
+}
+
+bool SleepManager_sleep() {
+  SnipsRadio_lock();
+  bool ok = sx126x_set_sleep(SnipsRadio_context(), SX126X_SLEEP_CFG_WARM_START) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+  return ok;
+}
+
+bool SleepManager_wake() {
+  const void* ctx = SnipsRadio_context();
+  uint32_t start = micros();
+
+  SnipsRadio_lock();
+  bool ok = sx126x_wakeup(ctx) == SX126X_STATUS_OK;
+
+  for (uint8_t s = 0; s < SLEEP_STEP_COUNT && ok; s++) {
+    if (stats.retainedSteps & steps[s].step) {
+      stats.stepsSkipped++;
+    } else {
+      ok &= applyStep(ctx, steps[s].step);
+      stats.stepsReplayed++;
+    }
+  }
+  ok &= SnipsRadio_waitNotBusy(1000);
+  SnipsRadio_unlock();
+
+  uint32_t elapsed = micros() - start;
+  stats.wakeCount++;
+  stats.lastWakeUs = elapsed;
+  if (elapsed < stats.minWakeUs) stats.minWakeUs = elapsed;
+  if (elapsed > stats.maxWakeUs) stats.maxWakeUs = elapsed;
+  stats.avgWakeUs = stats.wakeCount == 1 ? elapsed : stats.avgWakeUs - stats.avgWakeUs / 8 + elapsed / 8;
+
+  return ok;
+}
+
+bool SleepManager_isSleeping() {
+  return SnipsRadio_isSleeping();
+}
+
+void SleepManager_getStats(SleepManagerStats* out) {
+  *out = stats;
+}
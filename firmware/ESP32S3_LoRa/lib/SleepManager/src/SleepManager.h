@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+
+// ============================================================================
+// WARM-SLEEP MANAGER (MOBILE NODES)
+// ============================================================================
+//
+// Mobiles sleep between their TDMA slots. The registers touched by
+// sx126x_cfg_rx_boosted(), sx126x_tx_modulation_workaround() and
+// sx126x_cfg_tx_clamp() are put in the chip's retention list once, so a
+// warm-start wake only has to replay the steps whose register did not make
+// it into the list. Wake-to-ready latency is measured on every wake.
+//
+
+enum SleepManagerStep : uint8_t {
+  SLEEP_STEP_RX_BOOSTED    = 0x01,
+  SLEEP_STEP_TX_MODULATION = 0x02,
+  SLEEP_STEP_TX_CLAMP      = 0x04,
+};
+
+struct SleepManagerStats {
+  uint32_t wakeCount;
+  uint32_t lastWakeUs;
+  uint32_t minWakeUs;
+  uint32_t maxWakeUs;
+  uint32_t avgWakeUs;      // moving average
+  uint32_t stepsReplayed;
+  uint32_t stepsSkipped;
+  uint8_t retainedSteps;   // SleepManagerStep mask covered by retention
+};
+
+// Applies the three register steps and registers their addresses in the
+// retention list. Call after SnipsRadio_configureLora().
+bool SleepManager_begin(bool rxBoosted);
+
+bool SleepManager_sleep();
+
+// Wakes the chip and replays only the steps not covered by retention.
+// Returns with the radio in STDBY_RC, ready for RX/TX.
+bool SleepManager_wake();
+
+bool SleepManager_isSleeping();
+
+void SleepManager_getStats(SleepManagerStats* stats);
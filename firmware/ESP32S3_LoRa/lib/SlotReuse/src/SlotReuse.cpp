@@ -0,0 +1,235 @@
+#include "SlotReuse.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct HeardEntry {
+  uint8_t from;
+  int8_t rssi;        // smoothed
+  bool audible;
+  bool used;
+};
+
+struct Link {
+  uint8_t tx;
+  uint8_t rx;
+  uint8_t slot;
+  bool used;
+};
+
+static HeardEntry heard[SLOT_REUSE_MAX_NODES][SLOT_REUSE_MAX_NEIGHBORS];
+static Link links[SLOT_REUSE_MAX_LINKS];
+static uint8_t slotCount = TDMA_DATA_SLOTS;
+static SlotReuseStats stats;
+
+// ============================================================================
+// INTERFERENCE GRAPH
+// ============================================================================
+
+static bool audible(uint8_t from, uint8_t at) {
+  if (at >= SLOT_REUSE_MAX_NODES) {
+    return false;
+  }
+  for (uint8_t k = 0; k < SLOT_REUSE_MAX_NEIGHBORS; k++) {
+    const HeardEntry& e = heard[at][k];
+    if (e.used && e.from == from) {
+      return e.audible;
+    }
+  }
+  return false;
+}
+
+bool SlotReuse_conflict(uint8_t a, uint8_t b) {
+  const Link& la = links[a];
+  const Link& lb = links[b];
+
+  if (la.tx == lb.tx || la.tx == lb.rx || la.rx == lb.tx || la.rx == lb.rx) {
+    return true;
+  }
+  return audible(lb.tx, la.rx) || audible(la.tx, lb.rx);
+}
+
+static uint64_t slotsTakenByNeighbors(uint8_t link) {
+  uint64_t taken = 0;
+  for (uint8_t j = 0; j < SLOT_REUSE_MAX_LINKS; j++) {
+    if (j != link && links[j].used && links[j].slot != SLOT_REUSE_NO_SLOT && SlotReuse_conflict(link, j)) {
+      taken |= (uint64_t) 1 << links[j].slot;
+    }
+  }
+  return taken;
+}
+
+static void colorLink(uint8_t link) {
+  uint64_t taken = slotsTakenByNeighbors(link);
+  links[link].slot = SLOT_REUSE_NO_SLOT;
+  for (uint8_t s = 0; s < slotCount; s++) {
+    if (!(taken & ((uint64_t) 1 << s))) {
+      links[link].slot = s;
+      return;
+    }
+  }
+}
+
+// A new edge (from -> at) can only create clashes between links received at
+// `at` and links transmitted by `from`.
+static void repairEdge(uint8_t from, uint8_t at) {
+  for (uint8_t i = 0; i < SLOT_REUSE_MAX_LINKS; i++) {
+    if (!links[i].used || links[i].rx != at || links[i].slot == SLOT_REUSE_NO_SLOT) {
+      continue;
+    }
+    for (uint8_t j = 0; j < SLOT_REUSE_MAX_LINKS; j++) {
+      if (j != i && links[j].used && links[j].tx == from && links[j].slot == links[i].slot) {
+        colorLink(i);
+        stats.recolored++;
+        break;
+      }
+    }
+  }
+}
+
+// A removed link or vanished edge frees slots for links that found none.
+static void retryUnassigned() {
+  for (uint8_t i = 0; i < SLOT_REUSE_MAX_LINKS; i++) {
+    if (links[i].used && links[i].slot == SLOT_REUSE_NO_SLOT) {
+      colorLink(i);
+      if (links[i].slot != SLOT_REUSE_NO_SLOT) {
+        stats.recolored++;
+      }
+    }
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void SlotReuse_begin(uint8_t slots) {
+  memset(heard, 0, sizeof(heard));
+  memset(links, 0, sizeof(links));
+  memset(&stats, 0, sizeof(stats));
+  slotCount = slots <= 64 ? slots : 64;
+}
+
+void SlotReuse_reportRssi(uint8_t from, uint8_t at, int8_t rssiDbm) {
+  if (at >= SLOT_REUSE_MAX_NODES || from == at) {
+    return;
+  }
+
+  HeardEntry* entry = nullptr;
+  HeardEntry* victim = nullptr;    // free entry, else the weakest neighbor
+  for (uint8_t k = 0; k < SLOT_REUSE_MAX_NEIGHBORS; k++) {
+    HeardEntry& e = heard[at][k];
+    if (e.used && e.from == from) {
+      entry = &e;
+      break;
+    }
+    if (victim == nullptr || (victim->used && (!e.used || e.rssi < victim->rssi))) {
+      victim = &e;
+    }
+  }
+
+  if (entry == nullptr) {
+    // Table full: only evict a weaker neighbor
+    if (victim->used && victim->rssi >= rssiDbm) {
+      return;
+    }
+    entry = victim;
+    entry->used = true;
+    entry->from = from;
+    entry->rssi = rssiDbm;
+    entry->audible = false;
+  } else {
+    entry->rssi = (int8_t) ((3 * (int16_t) entry->rssi + rssiDbm) / 4);
+  }
+
+  bool wasAudible = entry->audible;
+  if (!wasAudible && entry->rssi >= SLOT_REUSE_INTERFERENCE_DBM) {
+    entry->audible = true;
+  } else if (wasAudible && entry->rssi < SLOT_REUSE_INTERFERENCE_DBM - SLOT_REUSE_HYSTERESIS_DB) {
+    entry->audible = false;
+  }
+
+  if (entry->audible != wasAudible) {
+    stats.edgeChanges++;
+    if (entry->audible) {
+      repairEdge(from, at);
+    } else {
+      // A vanished edge never creates a clash; assigned slots stay put to
+      // avoid churn, only starved links get another try.
+      retryUnassigned();
+    }
+  }
+}
+
+uint8_t SlotReuse_addLink(uint8_t tx, uint8_t rx) {
+  for (uint8_t i = 0; i < SLOT_REUSE_MAX_LINKS; i++) {
+    if (!links[i].used) {
+      links[i].used = true;
+      links[i].tx = tx;
+      links[i].rx = rx;
+      colorLink(i);
+      return i;
+    }
+  }
+  return SLOT_REUSE_NO_LINK;
+}
+
+void SlotReuse_removeLink(uint8_t link) {
+  if (link < SLOT_REUSE_MAX_LINKS && links[link].used) {
+    links[link].used = false;
+    retryUnassigned();
+  }
+}
+
+uint8_t SlotReuse_slotOf(uint8_t link) {
+  return link < SLOT_REUSE_MAX_LINKS && links[link].used ? links[link].slot : SLOT_REUSE_NO_SLOT;
+}
+
+void SlotReuse_recolorAll() {
+  static uint8_t order[SLOT_REUSE_MAX_LINKS];
+  static uint8_t degree[SLOT_REUSE_MAX_LINKS];
+  uint8_t count = 0;
+
+  for (uint8_t i = 0; i < SLOT_REUSE_MAX_LINKS; i++) {
+    if (!links[i].used) {
+      continue;
+    }
+    links[i].slot = SLOT_REUSE_NO_SLOT;
+    degree[i] = 0;
+    for (uint8_t j = 0; j < SLOT_REUSE_MAX_LINKS; j++) {
+      if (j != i && links[j].used && SlotReuse_conflict(i, j) && degree[i] < 0xFF) {
+        degree[i]++;
+      }
+    }
+
+    // Insertion by descending degree (Welsh-Powell order)
+    uint8_t pos = count++;
+    while (pos > 0 && degree[order[pos - 1]] < degree[i]) {
+      order[pos] = order[pos - 1];
+      pos--;
+    }
+    order[pos] = i;
+  }
+
+  for (uint8_t k = 0; k < count; k++) {
+    colorLink(order[k]);
+  }
+}
+
+void SlotReuse_getStats(SlotReuseStats* out) {
+  *out = stats;
+  out->slotsUsed = 0;
+  out->unassigned = 0;
+  for (uint8_t i = 0; i < SLOT_REUSE_MAX_LINKS; i++) {
+    if (!links[i].used) {
+      continue;
+    }
+    if (links[i].slot == SLOT_REUSE_NO_SLOT) {
+      out->unassigned++;
+    } else if (links[i].slot + 1 > out->slotsUsed) {
+      out->slotsUsed = links[i].slot + 1;
+    }
+  }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include "Tdma.h"
+
+// ============================================================================
+// SPATIAL SLOT REUSE (INTERFERENCE-GRAPH COLORING)
+// ============================================================================
+//
+// Runs on the TDMA master. Every link is a vertex; two links conflict if
+// they share a node or if either transmitter is heard at the other link's
+// receiver above SLOT_REUSE_INTERFERENCE_DBM. The slot of a link is its
+// color, so links that are out of each other's range share a data slot.
+//
+// RSSI comes from sx126x_get_lora_pkt_status() on every node and is reported
+// to the master. Only a change in audibility (threshold crossing with
+// hysteresis) or a link change touches the coloring, and then only for the
+// links at the affected receiver. Each node keeps only its
+// SLOT_REUSE_MAX_NEIGHBORS strongest transmitters.
+//
+
+#ifndef SLOT_REUSE_MAX_NODES
+#define SLOT_REUSE_MAX_NODES           255
+#endif
+
+#ifndef SLOT_REUSE_MAX_NEIGHBORS
+#define SLOT_REUSE_MAX_NEIGHBORS       16
+#endif
+
+#ifndef SLOT_REUSE_MAX_LINKS
+#define SLOT_REUSE_MAX_LINKS           255
+#endif
+
+#ifndef SLOT_REUSE_INTERFERENCE_DBM
+#define SLOT_REUSE_INTERFERENCE_DBM    -118
+#endif
+
+#define SLOT_REUSE_HYSTERESIS_DB       3
+#define SLOT_REUSE_NO_SLOT             0xFF
+#define SLOT_REUSE_NO_LINK             0xFF
+
+struct SlotReuseStats {
+  uint32_t recolored;          // links whose slot changed incrementally
+  uint32_t edgeChanges;        // audibility threshold crossings
+  uint8_t slotsUsed;
+  uint8_t unassigned;          // links that found no free slot
+};
+
+void SlotReuse_begin(uint8_t slots);
+
+// RSSI of a frame from `from` measured at `at`.
+void SlotReuse_reportRssi(uint8_t from, uint8_t at, int8_t rssiDbm);
+
+uint8_t SlotReuse_addLink(uint8_t tx, uint8_t rx);
+void SlotReuse_removeLink(uint8_t link);
+
+uint8_t SlotReuse_slotOf(uint8_t link);
+bool SlotReuse_conflict(uint8_t linkA, uint8_t linkB);
+
+// Full greedy recoloring from scratch (largest degree first). Used after
+// bulk changes and as the baseline in the benchmark.
+void SlotReuse_recolorAll();
+
+void SlotReuse_getStats(SlotReuseStats* stats);
@@ -0,0 +1,31 @@
+#include "SnipsFrame.h"
+
+void SnipsFrame_encodeHeader(const SnipsFrameHeader* header, uint8_t* buf) {
+  buf[0] = header->netId;
+  buf[SNIPS_FRAME_OFFSET_TYPE] = (header->type & 0x0F) | ((header->trafficClass & 0x03) << 4);
+  buf[SNIPS_FRAME_OFFSET_FLAGS] = header->flags;
+  buf[SNIPS_FRAME_OFFSET_SRC] = header->src;
+  buf[SNIPS_FRAME_OFFSET_DST] = header->dst;
+  buf[SNIPS_FRAME_OFFSET_PREV_HOP] = header->prevHop;
+  buf[SNIPS_FRAME_OFFSET_NEXT_HOP] = header->nextHop;
+  buf[SNIPS_FRAME_OFFSET_SEQ] = header->seq;
+  buf[SNIPS_FRAME_OFFSET_HOPS] = header->hops;
+}
+
+bool SnipsFrame_decodeHeader(const uint8_t* buf, uint8_t len, SnipsFrameHeader* header) {
+  if (len < SNIPS_FRAME_HEADER_LEN || buf[0] != SNIPS_NETWORK_ID) {
+    return false;
+  }
+
+  header->netId = buf[0];
+  header->type = buf[SNIPS_FRAME_OFFSET_TYPE] & 0x0F;
+  header->trafficClass = (buf[SNIPS_FRAME_OFFSET_TYPE] >> 4) & 0x03;
+  header->flags = buf[SNIPS_FRAME_OFFSET_FLAGS];
+  header->src = buf[SNIPS_FRAME_OFFSET_SRC];
+  header->dst = buf[SNIPS_FRAME_OFFSET_DST];
+  header->prevHop = buf[SNIPS_FRAME_OFFSET_PREV_HOP];
+  header->nextHop = buf[SNIPS_FRAME_OFFSET_NEXT_HOP];
+  header->seq = buf[SNIPS_FRAME_OFFSET_SEQ];
+  header->hops = buf[SNIPS_FRAME_OFFSET_HOPS];
+  return true;
+}
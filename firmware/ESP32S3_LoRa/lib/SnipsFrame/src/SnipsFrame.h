@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// SNIPS FRAME FORMAT
+// ============================================================================
+//
+//  byte 0   network ID
+//  byte 1   type (bits 0-3) | traffic class (bits 4-5)
+//  byte 2   flags
+//  byte 3   source (originator)
+//  byte 4   destination (final)
+//  byte 5   previous hop (link transmitter)
+//  byte 6   next hop (link receiver)
+//  byte 7   sequence number (per link)
+//  byte 8   hop count
+//  byte 9+  payload
+//
+
+#define SNIPS_FRAME_HEADER_LEN   9
+#define SNIPS_FRAME_MAX_LEN      255
+#define SNIPS_FRAME_MAX_PAYLOAD  (SNIPS_FRAME_MAX_LEN - SNIPS_FRAME_HEADER_LEN)
+
+#define SNIPS_ADDR_BROADCAST     0xFF
+
+#ifndef SNIPS_NETWORK_ID
+#define SNIPS_NETWORK_ID         0x5A
+#endif
+
+enum SnipsFrameType : uint8_t {
+  SNIPS_FRAME_SYNC    = 0x0,
+  SNIPS_FRAME_CONTROL = 0x1,
+  SNIPS_FRAME_DATA    = 0x2,
+  SNIPS_FRAME_ACK     = 0x3,
+  SNIPS_FRAME_AGGREGATE = 0x4,   // payload: { len, frame } records
+  SNIPS_FRAME_CODED     = 0x5,   // XOR of two frames, see NetCoding
+  SNIPS_FRAME_ANNOUNCE  = 0x6,   // network-wide announcement, see TrickleFlood
+  SNIPS_FRAME_BLOCK_ACK = 0x7,   // standalone ARQ block ACK, see Arq
+  SNIPS_FRAME_FOUNTAIN  = 0x8,   // LT-coded bulk data symbol, see Fountain
+};
+
+enum SnipsTrafficClass : uint8_t {
+  SNIPS_CLASS_EMERGENCY   = 0,
+  SNIPS_CLASS_POSITIONING = 1,
+  SNIPS_CLASS_DATA        = 2,
+  SNIPS_CLASS_MANAGEMENT  = 3,
+};
+
+// Flags (byte 2)
+#define SNIPS_FLAG_ACK_REQ       0x01
+#define SNIPS_FLAG_GEO           0x02    // payload starts with a GeoHeader
+#define SNIPS_FLAG_BLOCK_ACK     0x04    // payload ends with an ARQ block ACK
+#define SNIPS_FLAG_QUEUE_VALID   0x08    // bits 4-7 hold a stamped queue depth
+
+// Bits 4-7 of the flags carry the sender's egress queue depth (saturating
+// at 15) so the TDMA master can size its reservation. QosScheduler_dequeue
+// stamps it and sets SNIPS_FLAG_QUEUE_VALID; frames built around the
+// QosScheduler (ACKs, block ACKs, announcements) leave both clear and
+// report no depth at all, rather than an empty queue.
+#define SNIPS_FLAG_QUEUE_SHIFT   4
+#define SNIPS_FLAG_QUEUE_MASK    0xF0
+#define SNIPS_QUEUE_DEPTH_MAX    15
+
+struct SnipsFrameHeader {
+  uint8_t netId;
+  uint8_t type;
+  uint8_t trafficClass;
+  uint8_t flags;
+  uint8_t src;
+  uint8_t dst;
+  uint8_t prevHop;
+  uint8_t nextHop;
+  uint8_t seq;
+  uint8_t hops;
+};
+
+// Serializes the header into buf (at least SNIPS_FRAME_HEADER_LEN bytes).
+void SnipsFrame_encodeHeader(const SnipsFrameHeader* header, uint8_t* buf);
+
+// Parses the header from buf. Returns false if the frame is too short or
+// belongs to another network.
+bool SnipsFrame_decodeHeader(const uint8_t* buf, uint8_t len, SnipsFrameHeader* header);
+
+// Header fields addressed by byte offset, for hot paths that only need a
+// field or two and must not parse the whole header.
+#define SNIPS_FRAME_OFFSET_TYPE     1
+#define SNIPS_FRAME_OFFSET_FLAGS    2
+#define SNIPS_FRAME_OFFSET_SRC      3
+#define SNIPS_FRAME_OFFSET_DST      4
+#define SNIPS_FRAME_OFFSET_PREV_HOP 5
+#define SNIPS_FRAME_OFFSET_NEXT_HOP 6
+#define SNIPS_FRAME_OFFSET_SEQ      7
+#define SNIPS_FRAME_OFFSET_HOPS     8
+
+static inline uint8_t SnipsFrame_type(const uint8_t* buf) {
+  return buf[SNIPS_FRAME_OFFSET_TYPE] & 0x0F;
+}
+
+static inline uint8_t SnipsFrame_queueDepth(const uint8_t* buf) {
+  return (buf[SNIPS_FRAME_OFFSET_FLAGS] & SNIPS_FLAG_QUEUE_MASK) >> SNIPS_FLAG_QUEUE_SHIFT;
+}
+
+static inline bool SnipsFrame_hasQueueDepth(const uint8_t* buf) {
+  return (buf[SNIPS_FRAME_OFFSET_FLAGS] & SNIPS_FLAG_QUEUE_VALID) != 0;
+}
+
+static inline uint8_t SnipsFrame_flagsWithQueue(uint8_t flags, uint16_t queueDepth) {
+  if (queueDepth > SNIPS_QUEUE_DEPTH_MAX) {
+    queueDepth = SNIPS_QUEUE_DEPTH_MAX;
+  }
+  return (flags & ~SNIPS_FLAG_QUEUE_MASK) | SNIPS_FLAG_QUEUE_VALID | (queueDepth << SNIPS_FLAG_QUEUE_SHIFT);
+}
@@ -0,0 +1,201 @@
+#include "SnipsHc.h"
+#include <string.h>
+
+// ============================================================================
+// CONTEXT
+// ============================================================================
+
+void SnipsHc_init(SnipsHcContext* ctx, uint8_t self) {
+  memset(ctx, 0, sizeof(*ctx));
+  memset(ctx->txSinceFull, SNIPS_HC_SEQ_REFRESH, sizeof(ctx->txSinceFull));
+  ctx->self = self;
+  ctx->cell = SNIPS_HC_NO_CELL;
+}
+
+void SnipsHc_setCell(SnipsHcContext* ctx, uint8_t owner, uint8_t receiver) {
+  ctx->cell = ((uint16_t) owner << 8) | receiver;
+}
+
+void SnipsHc_clearCell(SnipsHcContext* ctx) {
+  ctx->cell = SNIPS_HC_NO_CELL;
+}
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool bitSet(const uint8_t* bitmap, uint8_t addr) {
+  return (bitmap[addr >> 3] >> (addr & 7)) & 1;
+}
+
+// Keeps the newest sequence of a link. Retransmissions are older and must
+// not pull it back, or the two ends' windows drift apart.
+static void noteSeq(uint8_t* newest, uint8_t* known, uint8_t addr, uint8_t seq) {
+  if (!bitSet(known, addr) || (int8_t) (seq - newest[addr]) > 0) {
+    newest[addr] = seq;
+  }
+  known[addr >> 3] |= 1 << (addr & 7);
+}
+
+// Low-bits sequence is safe if seq is at most one ahead of and three behind
+// the newest one sent on the link (see the window in SnipsHc.h).
+static bool lsbAllowed(const SnipsHcContext* ctx, uint8_t nextHop, uint8_t seq, uint8_t hops) {
+  int8_t delta = (int8_t) (seq - ctx->txSeq[nextHop]);
+  return nextHop != SNIPS_ADDR_BROADCAST && hops > 0 && hops < 16 && bitSet(ctx->txKnown, nextHop) &&
+         ctx->txSinceFull[nextHop] < SNIPS_HC_SEQ_REFRESH && ctx->txSinceJump[nextHop] >= SNIPS_HC_SEQ_SETTLE &&
+         delta >= -3 && delta <= 1;
+}
+
+// ============================================================================
+// COMPRESSION
+// ============================================================================
+
+uint8_t SnipsHc_compress(SnipsHcContext* ctx, const uint8_t* frame, uint8_t len, uint8_t* out) {
+  SnipsFrameHeader h;
+  if (!SnipsFrame_decodeHeader(frame, len, &h)) {
+    return 0;
+  }
+
+  bool hasCell = ctx->cell != SNIPS_HC_NO_CELL;
+  uint8_t owner = ctx->cell >> 8;
+  uint8_t receiver = ctx->cell & 0xFF;
+  uint8_t fields[SNIPS_HC_MAX_HEADER_LEN - 2];
+  uint8_t n = 0;
+
+  uint8_t c0 = SNIPS_HC_DISPATCH;
+  if (h.flags != 0) {
+    c0 |= SNIPS_HC_F;
+    fields[n++] = h.flags;
+  }
+  if (!hasCell || h.prevHop != owner) {
+    c0 |= SNIPS_HC_P;
+    fields[n++] = h.prevHop;
+  }
+  if (!hasCell || h.nextHop != receiver) {
+    c0 |= SNIPS_HC_N;
+    fields[n++] = h.nextHop;
+  }
+  if (h.src != h.prevHop) {
+    c0 |= SNIPS_HC_S;
+    fields[n++] = h.src;
+  }
+  if (h.dst != h.nextHop) {
+    c0 |= SNIPS_HC_D;
+    fields[n++] = h.dst;
+  }
+
+  uint8_t mode;
+  if (lsbAllowed(ctx, h.nextHop, h.seq, h.hops)) {
+    mode = SNIPS_HC_SEQ_LSB;
+    fields[n++] = (uint8_t) ((h.seq & 0x0F) << 4) | h.hops;
+  } else {
+    mode = h.hops == 0 ? SNIPS_HC_SEQ_NO_HOPS : SNIPS_HC_SEQ_FULL;
+    fields[n++] = h.seq;
+    if (h.hops != 0) {
+      fields[n++] = h.hops;
+    }
+  }
+
+  // Applied by txDone once the frame is on air
+  ctx->txPending = h.nextHop != SNIPS_ADDR_BROADCAST;
+  ctx->txPendingHop = h.nextHop;
+  ctx->txPendingSeq = h.seq;
+  ctx->txPendingLsb = mode == SNIPS_HC_SEQ_LSB;
+
+  uint8_t hcLen = 2 + n;
+  uint8_t payloadLen = len - SNIPS_FRAME_HEADER_LEN;
+  memmove(out + hcLen, frame + SNIPS_FRAME_HEADER_LEN, payloadLen);
+  out[0] = c0;
+  out[1] = (uint8_t) (h.type << 4) | (uint8_t) (h.trafficClass << 2) | mode;
+  memcpy(out + 2, fields, n);
+
+  ctx->stats.compressed++;
+  ctx->stats.bytesSaved += SNIPS_FRAME_HEADER_LEN - hcLen;
+  return hcLen + payloadLen;
+}
+
+void SnipsHc_txDone(SnipsHcContext* ctx, bool sent) {
+  if (ctx->txPending && sent) {
+    uint8_t hop = ctx->txPendingHop;
+    int8_t delta = (int8_t) (ctx->txPendingSeq - ctx->txSeq[hop]);
+    if (!bitSet(ctx->txKnown, hop) || delta > 1) {
+      ctx->txSinceJump[hop] = 1;
+    } else if (ctx->txSinceJump[hop] < SNIPS_HC_SEQ_SETTLE) {
+      ctx->txSinceJump[hop]++;
+    }
+    if (ctx->txPendingLsb) {
+      ctx->txSinceFull[hop]++;
+    } else {
+      ctx->txSinceFull[hop] = 0;
+    }
+    noteSeq(ctx->txSeq, ctx->txKnown, hop, ctx->txPendingSeq);
+  }
+  ctx->txPending = false;
+}
+
+// ============================================================================
+// DECOMPRESSION
+// ============================================================================
+
+bool SnipsHc_decompress(SnipsHcContext* ctx, uint8_t* buf, uint8_t* len) {
+  if (*len >= SNIPS_FRAME_HEADER_LEN && buf[0] == SNIPS_NETWORK_ID) {
+    ctx->stats.passedThrough++;
+    return true;
+  }
+  if (*len < 3 || !SnipsHc_isCompressed(buf)) {
+    ctx->stats.undecodable++;
+    return false;
+  }
+
+  uint8_t c0 = buf[0];
+  uint8_t c1 = buf[1];
+  uint8_t mode = c1 & 0x03;
+  bool hasCell = ctx->cell != SNIPS_HC_NO_CELL;
+  if (mode > SNIPS_HC_SEQ_LSB || (!hasCell && (~c0 & (SNIPS_HC_P | SNIPS_HC_N)))) {
+    ctx->stats.undecodable++;
+    return false;
+  }
+
+  // Field count is known from the control bytes alone
+  uint8_t hcLen = 2 + ((c0 & SNIPS_HC_F) != 0) + ((c0 & SNIPS_HC_P) != 0) + ((c0 & SNIPS_HC_N) != 0) +
+                  ((c0 & SNIPS_HC_S) != 0) + ((c0 & SNIPS_HC_D) != 0) + (mode == SNIPS_HC_SEQ_FULL ? 2 : 1);
+  uint8_t payloadLen = *len - hcLen;
+  if (*len < hcLen || payloadLen > SNIPS_FRAME_MAX_PAYLOAD) {
+    ctx->stats.undecodable++;
+    return false;
+  }
+
+  const uint8_t* p = buf + 2;
+  SnipsFrameHeader h;
+  h.netId = SNIPS_NETWORK_ID;
+  h.type = c1 >> 4;
+  h.trafficClass = (c1 >> 2) & 0x03;
+  h.flags = (c0 & SNIPS_HC_F) ? *p++ : 0;
+  h.prevHop = (c0 & SNIPS_HC_P) ? *p++ : (uint8_t) (ctx->cell >> 8);
+  h.nextHop = (c0 & SNIPS_HC_N) ? *p++ : (uint8_t) (ctx->cell & 0xFF);
+  h.src = (c0 & SNIPS_HC_S) ? *p++ : h.prevHop;
+  h.dst = (c0 & SNIPS_HC_D) ? *p++ : h.nextHop;
+
+  bool mine = h.nextHop == ctx->self;
+  if (mode == SNIPS_HC_SEQ_LSB) {
+    if (!mine || !bitSet(ctx->rxKnown, h.prevHop)) {
+      ctx->stats.undecodable++;
+      return false;
+    }
+    uint8_t low = ctx->rxSeq[h.prevHop] - 3;
+    h.seq = low + (((*p >> 4) - low) & 0x0F);
+    h.hops = *p & 0x0F;
+  } else {
+    h.seq = p[0];
+    h.hops = mode == SNIPS_HC_SEQ_FULL ? p[1] : 0;
+  }
+  if (mine) {
+    noteSeq(ctx->rxSeq, ctx->rxKnown, h.prevHop, h.seq);
+  }
+
+  memmove(buf + SNIPS_FRAME_HEADER_LEN, buf + hcLen, payloadLen);
+  SnipsFrame_encodeHeader(&h, buf);
+  *len = SNIPS_FRAME_HEADER_LEN + payloadLen;
+  ctx->stats.decompressed++;
+  return true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <stdint.h>
+#include "SnipsFrame.h"
+
+// ============================================================================
+// SNIPS HEADER COMPRESSION (IPHC-STYLE SHARED CONTEXT)
+// ============================================================================
+//
+// A compressed frame replaces the 9-byte header with two control bytes and
+// only the fields the receiver cannot derive:
+//
+//  byte 0   110 S P N D F   dispatch (never a network ID, see below)
+//  byte 1   type (bits 4-7) | class (bits 2-3) | seq mode (bits 0-1)
+//  then, in this order, only if inline:
+//           flags (F), previous hop (P), next hop (N), source (S),
+//           destination (D), sequence / hops (seq mode)
+//
+//  S  source inline; elided when it equals the previous hop
+//  P  previous hop inline; elided when it is the owner of the TDMA cell
+//  N  next hop inline; elided when it is the receiver of the TDMA cell
+//  D  destination inline; elided when it equals the next hop
+//  F  flags inline; elided when zero
+//
+//  seq mode 0   [seq][hops]
+//  seq mode 1   [seq], hops 0
+//  seq mode 2   [seq bits 0-3 << 4 | hops], unicast only, hops < 16
+//
+// The network ID is always elided: the LoRa sync word already keeps other
+// networks out. The cell context (owner, receiver) comes from the TDMA
+// schedule and is identical at both ends of the link; with no cell
+// (opportunistic CAD traffic) the hops go inline.
+//
+// Mode 2 sends the low sequence bits only and the receiver rebuilds the
+// rest from the newest sequence it got from that previous hop, in the
+// window [newest - 3, newest + 12]. The sender uses it only for sequences
+// at most one ahead and three behind the newest one it sent on the link
+// (ARQ retransmissions are older), so up to eleven consecutive new frames
+// of the link may be lost, and it sends the full sequence every
+// SNIPS_HC_SEQ_REFRESH frames. When the newest sequence jumps further
+// ahead (frames numbered but never sent) or the link is new, the full
+// sequence goes inline for the next SNIPS_HC_SEQ_SETTLE frames sent, so
+// the receiver has caught up with the jump before low bits are used again.
+// Only the addressed next hop holds that context; overheard unicast frames
+// in mode 2 do not decode.
+//
+// The sender's side of that context only moves for frames that went on
+// air: compress stages the update and SnipsHc_txDone applies it, or drops
+// it for a frame the duty cycle refused or the chip did not take. A run of
+// unsent frames therefore never pulls the sender's window away from the
+// receiver's.
+//
+
+#define SNIPS_HC_DISPATCH        0xC0
+#define SNIPS_HC_DISPATCH_MASK   0xE0
+#define SNIPS_HC_MAX_HEADER_LEN  (2 + 7)
+
+#define SNIPS_HC_S               0x10
+#define SNIPS_HC_P               0x08
+#define SNIPS_HC_N               0x04
+#define SNIPS_HC_D               0x02
+#define SNIPS_HC_F               0x01
+
+#define SNIPS_HC_SEQ_FULL        0
+#define SNIPS_HC_SEQ_NO_HOPS     1
+#define SNIPS_HC_SEQ_LSB         2
+
+#define SNIPS_HC_NO_CELL         0xFFFF
+
+#ifndef SNIPS_HC_SEQ_REFRESH
+#define SNIPS_HC_SEQ_REFRESH     8
+#endif
+
+// One more than the consecutive losses the mode 2 window tolerates
+#define SNIPS_HC_SEQ_SETTLE      12
+
+#if (SNIPS_NETWORK_ID & SNIPS_HC_DISPATCH_MASK) == SNIPS_HC_DISPATCH
+#error "SNIPS_NETWORK_ID collides with the header compression dispatch"
+#endif
+
+struct SnipsHcStats {
+  uint32_t compressed;
+  uint32_t decompressed;
+  uint32_t passedThrough;      // uncompressed frames accepted on RX
+  uint32_t undecodable;        // context missing or frame malformed
+  uint32_t bytesSaved;
+};
+
+struct SnipsHcContext {
+  uint8_t self;
+  uint16_t cell;               // owner << 8 | receiver, or SNIPS_HC_NO_CELL
+  uint8_t txSeq[256];          // newest sequence sent, per next hop
+  uint8_t txKnown[32];         // bitmap over txSeq
+  uint8_t txSinceFull[256];
+  uint8_t txSinceJump[256];    // frames sent since the newest sequence jumped
+  uint8_t rxSeq[256];          // newest sequence received, per previous hop
+  uint8_t rxKnown[32];         // bitmap over rxSeq
+  bool txPending;              // compress staged an update for txDone
+  uint8_t txPendingHop;
+  uint8_t txPendingSeq;
+  bool txPendingLsb;
+  SnipsHcStats stats;
+};
+
+void SnipsHc_init(SnipsHcContext* ctx, uint8_t self);
+
+// TDMA cell of the current slot (owner transmits to receiver), or none.
+void SnipsHc_setCell(SnipsHcContext* ctx, uint8_t owner, uint8_t receiver);
+void SnipsHc_clearCell(SnipsHcContext* ctx);
+
+static inline bool SnipsHc_isCompressed(const uint8_t* buf) {
+  return (buf[0] & SNIPS_HC_DISPATCH_MASK) == SNIPS_HC_DISPATCH;
+}
+
+// Compresses a full SNIPS frame into out (which may alias frame). Returns
+// the compressed length, or 0 if the frame is not a SNIPS frame. Call
+// SnipsHc_txDone before compressing the next frame.
+uint8_t SnipsHc_compress(SnipsHcContext* ctx, const uint8_t* frame, uint8_t len, uint8_t* out);
+
+// Outcome of the frame last compressed: sent commits its sequence to the
+// link context, otherwise the context stays as it was.
+void SnipsHc_txDone(SnipsHcContext* ctx, bool sent);
+
+// Expands a compressed frame in place; buf must hold SNIPS_FRAME_MAX_LEN
+// bytes. Uncompressed SNIPS frames are left as they are. False if the frame
+// cannot be decoded with this context.
+bool SnipsHc_decompress(SnipsHcContext* ctx, uint8_t* buf, uint8_t* len);
@@ -0,0 +1,44 @@
+#include "SnipsHcRadio.h"
+#include "SnipsRadio.h"
+
+// Touched under the radio lock only.
+static SnipsHcContext context;
+
+static uint8_t encode(const uint8_t* frame, uint8_t len, uint8_t* out) {
+  return SnipsHc_compress(&context, frame, len, out);
+}
+
+static void encodeDone(bool sent) {
+  SnipsHc_txDone(&context, sent);
+}
+
+static bool decode(SnipsRxPacket* pkt) {
+  return SnipsHc_decompress(&context, pkt->data, &pkt->len);
+}
+
+bool SnipsHcRadio_attach(uint8_t selfAddress) {
+  SnipsRadio_lock();
+  SnipsHc_init(&context, selfAddress);
+  SnipsRadio_unlock();
+
+  SnipsRadio_setCodec(encode, encodeDone, decode);
+  return true;
+}
+
+void SnipsHcRadio_setCell(uint8_t owner, uint8_t receiver) {
+  SnipsRadio_lock();
+  SnipsHc_setCell(&context, owner, receiver);
+  SnipsRadio_unlock();
+}
+
+void SnipsHcRadio_clearCell() {
+  SnipsRadio_lock();
+  SnipsHc_clearCell(&context);
+  SnipsRadio_unlock();
+}
+
+void SnipsHcRadio_getStats(SnipsHcStats* out) {
+  SnipsRadio_lock();
+  *out = context.stats;
+  SnipsRadio_unlock();
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "SnipsHc.h"
+
+// ============================================================================
+// HEADER COMPRESSION RADIO BINDING
+// ============================================================================
+//
+// Installs SnipsHc as the SnipsRadio frame codec: every frame sent through
+// SnipsRadio_transmit goes out compressed and every compressed frame is
+// expanded in the harvest buffer before the fast-path hooks run, so the
+// rest of the stack only ever sees full headers. Frames sent around the
+// codec (AckEngine) stay uncompressed and pass through. The link context
+// advances only for frames SnipsRadio reports as sent.
+//
+// The TDMA slot loop reports the cell of every slot: TschRadio_enterCell
+// does so for slots this node has a cell in and TschRadio_leaveCell clears
+// it again; slots without one must call SnipsHcRadio_clearCell so a stale
+// cell is never used to decode.
+//
+
+bool SnipsHcRadio_attach(uint8_t selfAddress);
+
+void SnipsHcRadio_setCell(uint8_t owner, uint8_t receiver);
+void SnipsHcRadio_clearCell();
+
+void SnipsHcRadio_getStats(SnipsHcStats* stats);
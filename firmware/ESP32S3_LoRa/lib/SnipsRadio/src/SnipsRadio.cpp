@@ -0,0 +1,513 @@
+#include "SnipsRadio.h"
+#include "DutyCycle.h"
+#include "sx126x_hal.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static SnipsRadioContext radio = { nullptr, LORA_NSS, LORA_BUSY, LORA_RST, LORA_DIO1, false };
+static SnipsLoraConfig loraConfig;
+static SnipsGfskConfig gfskConfig;
+static volatile bool gfskMode = false;
+static uint32_t rfFreqHz = 0;
+
+static SemaphoreHandle_t radioLock = nullptr;
+static QueueHandle_t rxQueue = nullptr;
+static TaskHandle_t radioTask = nullptr;
+
+static SnipsRadioRxHook rxHooks[SNIPS_RADIO_MAX_HOOKS];
+static uint8_t rxHookCount = 0;
+static SnipsRadioIrqHook irqHooks[SNIPS_RADIO_MAX_HOOKS];
+static uint8_t irqHookCount = 0;
+static SnipsRadioRxHook gfskRxHook = nullptr;
+static SnipsRadioRxHook profileRxHook = nullptr;
+static SnipsRadioRxStartHook rxStartHook = nullptr;
+static bool pktParamsDirty = false;
+static uint16_t txPreamble = 0;
+static SnipsRadioTxCodec txCodec = nullptr;
+static SnipsRadioTxCodecDone txCodecDone = nullptr;
+static SnipsRadioRxCodec rxCodec = nullptr;
+static uint8_t txCoded[255];
+
+static volatile uint32_t dio1EdgeUs = 0;
+static SnipsRxPacket harvested;
+
+// ============================================================================
+// SX126X HAL
+// ============================================================================
+
+static bool waitBusyLow(const SnipsRadioContext* ctx, uint32_t timeoutUs) {
+  uint32_t start = micros();
+  while (digitalRead(ctx->busy) == HIGH) {
+    if (micros() - start > timeoutUs) {
+      return false;
+    }
+  }
+  return true;
+}
+
+sx126x_hal_status_t sx126x_hal_write(const void* context, const uint8_t* command, const uint16_t command_length,
+                                     const uint8_t* data, const uint16_t data_length) {
+  SnipsRadioContext* ctx = (SnipsRadioContext*) context;
+  if (!waitBusyLow(ctx, 10000)) {
+    return SX126X_HAL_STATUS_ERROR;
+  }
+
+  ctx->spi->beginTransaction(SPISettings(SNIPS_RADIO_SPI_HZ, MSBFIRST, SPI_MODE0));
+  digitalWrite(ctx->nss, LOW);
+  for (uint16_t i = 0; i < command_length; i++) {
+    ctx->spi->transfer(command[i]);
+  }
+  for (uint16_t i = 0; i < data_length; i++) {
+    ctx->spi->transfer(data[i]);
+  }
+  digitalWrite(ctx->nss, HIGH);
+  ctx->spi->endTransaction();
+
+  // The chip keeps BUSY high while asleep, so don't wait on it here.
+  ctx->sleeping = (command_length > 0 && command[0] == 0x84);
+  return SX126X_HAL_STATUS_OK;
+}
+
+sx126x_hal_status_t sx126x_hal_read(const void* context, const uint8_t* command, const uint16_t command_length,
+                                    uint8_t* data, const uint16_t data_length) {
+  SnipsRadioContext* ctx = (SnipsRadioContext*) context;
+  if (!waitBusyLow(ctx, 10000)) {
+    return SX126X_HAL_STATUS_ERROR;
+  }
+
+  ctx->spi->beginTransaction(SPISettings(SNIPS_RADIO_SPI_HZ, MSBFIRST, SPI_MODE0));
+  digitalWrite(ctx->nss, LOW);
+  for (uint16_t i = 0; i < command_length; i++) {
+    ctx->spi->transfer(command[i]);
+  }
+  for (uint16_t i = 0; i < data_length; i++) {
+    data[i] = ctx->spi->transfer(SX126X_NOP);
+  }
+  digitalWrite(ctx->nss, HIGH);
+  ctx->spi->endTransaction();
+
+  return SX126X_HAL_STATUS_OK;
+}
+
+sx126x_hal_status_t sx126x_hal_reset(const void* context) {
+  SnipsRadioContext* ctx = (SnipsRadioContext*) context;
+
+  digitalWrite(ctx->reset, LOW);
+  delayMicroseconds(100);
+  digitalWrite(ctx->reset, HIGH);
+  ctx->sleeping = false;
+
+  return SX126X_HAL_STATUS_OK;
+}
+
+sx126x_hal_status_t sx126x_hal_wakeup(const void* context) {
+  SnipsRadioContext* ctx = (SnipsRadioContext*) context;
+
+  // A falling edge on NSS wakes the chip; BUSY drops once it is in STDBY_RC.
+  digitalWrite(ctx->nss, LOW);
+  delayMicroseconds(2);
+  digitalWrite(ctx->nss, HIGH);
+  ctx->sleeping = false;
+
+  return waitBusyLow(ctx, 10000) ? SX126X_HAL_STATUS_OK : SX126X_HAL_STATUS_ERROR;
+}
+
+// ============================================================================
+// DIO1 HANDLER
+// ============================================================================
+
+static void IRAM_ATTR onDio1() {
+  dio1EdgeUs = micros();
+
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(radioTask, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+static bool harvestRx(SnipsRxPacket* pkt) {
+  sx126x_rx_buffer_status_t bufferStatus;
+  if (sx126x_get_rx_buffer_status(&radio, &bufferStatus) != SX126X_STATUS_OK) {
+    return false;
+  }
+
+  pkt->len = bufferStatus.pld_len_in_bytes;
+  if (sx126x_read_buffer(&radio, bufferStatus.buffer_start_pointer, pkt->data, pkt->len) != SX126X_STATUS_OK) {
+    return false;
+  }
+
+  if (!gfskMode) {
+    return sx126x_get_lora_pkt_status(&radio, &pkt->status) == SX126X_STATUS_OK;
+  }
+
+  sx126x_pkt_status_gfsk_t gfsk;
+  if (sx126x_get_gfsk_pkt_status(&radio, &gfsk) != SX126X_STATUS_OK ||
+      gfsk.rx_status.crc_error || gfsk.rx_status.adrs_error || gfsk.rx_status.length_error) {
+    return false;
+  }
+  pkt->status.rssi_pkt_in_dbm = gfsk.rssi_sync;
+  pkt->status.signal_rssi_pkt_in_dbm = gfsk.rssi_sync;
+  pkt->status.snr_pkt_in_db = 0;
+  return true;
+}
+
+static void radioTaskLoop(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    SnipsRadio_lock();
+
+    sx126x_irq_mask_t irq = SX126X_IRQ_NONE;
+    sx126x_get_and_clear_irq_status(&radio, &irq);
+    uint32_t edgeUs = dio1EdgeUs;
+
+    bool queued = false;
+    if ((irq & SX126X_IRQ_RX_DONE) && !(irq & (SX126X_IRQ_CRC_ERROR | SX126X_IRQ_HEADER_ERROR))) {
+      sx126x_handle_rx_done(&radio);
+
+      if (harvestRx(&harvested)) {
+        harvested.irq = irq;
+        harvested.dio1Us = edgeUs;
+
+        bool consumed;
+        if (gfskMode || profileRxHook != nullptr) {
+          SnipsRadioRxHook exclusive = gfskMode ? gfskRxHook : profileRxHook;
+          consumed = exclusive == nullptr || exclusive(&harvested);
+        } else {
+          consumed = rxCodec != nullptr && !rxCodec(&harvested);
+          for (uint8_t i = 0; i < rxHookCount && !consumed; i++) {
+            consumed = rxHooks[i](&harvested);
+          }
+        }
+        queued = !consumed;
+      }
+    }
+
+    for (uint8_t i = 0; i < irqHookCount; i++) {
+      irqHooks[i](irq, edgeUs);
+    }
+
+    SnipsRadio_unlock();
+
+    if (queued) {
+      xQueueSend(rxQueue, &harvested, 0);
+    }
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool SnipsRadio_begin() {
+  pinMode(radio.nss, OUTPUT);
+  digitalWrite(radio.nss, HIGH);
+  pinMode(radio.reset, OUTPUT);
+  digitalWrite(radio.reset, HIGH);
+  pinMode(radio.busy, INPUT);
+  pinMode(radio.dio1, INPUT);
+
+  radio.spi = new SPIClass(FSPI);
+  radio.spi->begin(LORA_SCK, LORA_MISO, LORA_MOSI, LORA_NSS);
+
+  radioLock = xSemaphoreCreateRecursiveMutex();
+  rxQueue = xQueueCreate(SNIPS_RADIO_RX_QUEUE_LEN, sizeof(SnipsRxPacket));
+  if (radioLock == nullptr || rxQueue == nullptr) {
+    return false;
+  }
+
+  if (xTaskCreatePinnedToCore(radioTaskLoop, "snips_radio", 4096, nullptr, SNIPS_RADIO_TASK_PRIORITY,
+                              &radioTask, SNIPS_RADIO_TASK_CORE) != pdPASS) {
+    return false;
+  }
+
+  attachInterrupt(digitalPinToInterrupt(radio.dio1), onDio1, RISING);
+  return true;
+}
+
+const void* SnipsRadio_context() {
+  return &radio;
+}
+
+void SnipsRadio_lock() {
+  xSemaphoreTakeRecursive(radioLock, portMAX_DELAY);
+}
+
+void SnipsRadio_unlock() {
+  xSemaphoreGiveRecursive(radioLock);
+}
+
+bool SnipsRadio_waitNotBusy(uint32_t timeoutUs) {
+  return waitBusyLow(&radio, timeoutUs);
+}
+
+bool SnipsRadio_isSleeping() {
+  return radio.sleeping;
+}
+
+bool SnipsRadio_configureLora(const SnipsLoraConfig* cfg) {
+  bool ok = true;
+
+  SnipsRadio_lock();
+  ok &= sx126x_set_standby(&radio, SX126X_STANDBY_CFG_RC) == SX126X_STATUS_OK;
+  ok &= sx126x_set_pkt_type(&radio, SX126X_PKT_TYPE_LORA) == SX126X_STATUS_OK;
+  ok &= sx126x_set_rf_freq(&radio, cfg->freqHz) == SX126X_STATUS_OK;
+  ok &= sx126x_set_tx_params(&radio, cfg->txPowerDbm, SX126X_RAMP_40_US) == SX126X_STATUS_OK;
+  ok &= sx126x_set_lora_mod_params(&radio, &cfg->mod) == SX126X_STATUS_OK;
+  ok &= sx126x_set_lora_pkt_params(&radio, &cfg->pkt) == SX126X_STATUS_OK;
+  ok &= sx126x_set_lora_sync_word(&radio, cfg->syncWord) == SX126X_STATUS_OK;
+  ok &= sx126x_tx_modulation_workaround(&radio, SX126X_PKT_TYPE_LORA, cfg->mod.bw) == SX126X_STATUS_OK;
+  ok &= sx126x_set_buffer_base_address(&radio, SNIPS_RADIO_TX_BASE, SNIPS_RADIO_RX_BASE) == SX126X_STATUS_OK;
+  ok &= sx126x_set_dio_irq_params(&radio, SX126X_IRQ_ALL,
+                                  SX126X_IRQ_TX_DONE | SX126X_IRQ_RX_DONE | SX126X_IRQ_TIMEOUT |
+                                  SX126X_IRQ_CRC_ERROR | SX126X_IRQ_HEADER_ERROR |
+                                  SX126X_IRQ_CAD_DONE | SX126X_IRQ_CAD_DETECTED,
+                                  SX126X_IRQ_NONE, SX126X_IRQ_NONE) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+
+  if (ok) {
+    loraConfig = *cfg;
+    pktParamsDirty = false;
+    rfFreqHz = cfg->freqHz;
+    gfskMode = false;
+  }
+  return ok;
+}
+
+const SnipsLoraConfig* SnipsRadio_loraConfig() {
+  return &loraConfig;
+}
+
+bool SnipsRadio_configureGfsk(const SnipsGfskConfig* cfg) {
+  bool ok = true;
+
+  SnipsRadio_lock();
+  ok &= sx126x_set_standby(&radio, SX126X_STANDBY_CFG_RC) == SX126X_STATUS_OK;
+  ok &= sx126x_set_pkt_type(&radio, SX126X_PKT_TYPE_GFSK) == SX126X_STATUS_OK;
+  ok &= sx126x_set_rf_freq(&radio, cfg->freqHz) == SX126X_STATUS_OK;
+  ok &= sx126x_set_tx_params(&radio, cfg->txPowerDbm, SX126X_RAMP_40_US) == SX126X_STATUS_OK;
+  ok &= sx126x_set_gfsk_mod_params(&radio, &cfg->mod) == SX126X_STATUS_OK;
+  ok &= sx126x_set_gfsk_pkt_params(&radio, &cfg->pkt) == SX126X_STATUS_OK;
+  ok &= sx126x_set_gfsk_sync_word(&radio, cfg->syncWord, cfg->syncWordLen) == SX126X_STATUS_OK;
+  ok &= sx126x_set_gfsk_pkt_address(&radio, cfg->nodeAddr, cfg->broadcastAddr) == SX126X_STATUS_OK;
+  // CCITT CRC as in the SX126x datasheet; inverted on air by the CRC type
+  ok &= sx126x_set_gfsk_crc_seed(&radio, 0x1D0F) == SX126X_STATUS_OK;
+  ok &= sx126x_set_gfsk_crc_polynomial(&radio, 0x1021) == SX126X_STATUS_OK;
+  ok &= sx126x_set_gfsk_whitening_seed(&radio, 0x01FF) == SX126X_STATUS_OK;
+  ok &= sx126x_tx_modulation_workaround(&radio, SX126X_PKT_TYPE_GFSK, SX126X_LORA_BW_125) == SX126X_STATUS_OK;
+  ok &= sx126x_set_buffer_base_address(&radio, SNIPS_RADIO_TX_BASE, SNIPS_RADIO_RX_BASE) == SX126X_STATUS_OK;
+  gfskMode = ok;
+  SnipsRadio_unlock();
+
+  if (ok) {
+    gfskConfig = *cfg;
+    pktParamsDirty = false;
+    rfFreqHz = cfg->freqHz;
+  }
+  return ok;
+}
+
+const SnipsGfskConfig* SnipsRadio_gfskConfig() {
+  return &gfskConfig;
+}
+
+bool SnipsRadio_isGfsk() {
+  return gfskMode;
+}
+
+void SnipsRadio_notePktParams() {
+  SnipsRadio_lock();
+  pktParamsDirty = true;
+  SnipsRadio_unlock();
+}
+
+bool SnipsRadio_restorePktParams() {
+  bool ok = true;
+
+  SnipsRadio_lock();
+  if (pktParamsDirty && profileRxHook == nullptr) {
+    ok = gfskMode ? sx126x_set_gfsk_pkt_params(&radio, &gfskConfig.pkt) == SX126X_STATUS_OK
+                  : sx126x_set_lora_pkt_params(&radio, &loraConfig.pkt) == SX126X_STATUS_OK;
+    pktParamsDirty = !ok;
+  }
+  SnipsRadio_unlock();
+  return ok;
+}
+
+bool SnipsRadio_startRx(uint32_t timeoutMs) {
+  SnipsRadio_lock();
+  bool ok = SnipsRadio_restorePktParams();
+  ok &= sx126x_set_rx(&radio, timeoutMs) == SX126X_STATUS_OK;
+  if (ok && rxStartHook != nullptr) {
+    rxStartHook();
+  }
+  SnipsRadio_unlock();
+  return ok;
+}
+
+bool SnipsRadio_beginRxProfile(const sx126x_pkt_params_lora_t* pkt, SnipsRadioRxHook hook) {
+  if (gfskMode) {
+    return false;
+  }
+
+  SnipsRadio_lock();
+  bool ok = sx126x_set_lora_pkt_params(&radio, pkt) == SX126X_STATUS_OK;
+  profileRxHook = ok ? hook : nullptr;
+  SnipsRadio_unlock();
+  return ok;
+}
+
+bool SnipsRadio_endRxProfile() {
+  SnipsRadio_lock();
+  profileRxHook = nullptr;
+  bool ok = gfskMode || sx126x_set_lora_pkt_params(&radio, &loraConfig.pkt) == SX126X_STATUS_OK;
+  pktParamsDirty = !ok;
+  SnipsRadio_unlock();
+  return ok;
+}
+
+uint32_t SnipsRadio_frequencyHz() {
+  return rfFreqHz;
+}
+
+void SnipsRadio_noteFrequency(uint32_t freqHz) {
+  rfFreqHz = freqHz;
+}
+
+bool SnipsRadio_transmit(const uint8_t* data, uint8_t len, uint32_t timeoutMs) {
+  bool ok = true;
+  if (gfskMode) {
+    return false;
+  }
+
+  SnipsRadio_lock();
+  uint8_t coded = txCodec != nullptr ? txCodec(data, len, txCoded) : 0;
+  if (coded != 0) {
+    data = txCoded;
+    len = coded;
+  }
+
+  sx126x_pkt_params_lora_t pkt = loraConfig.pkt;
+  pkt.pld_len_in_bytes = len;
+  if (txPreamble != 0) {
+    pkt.preamble_len_in_symb = txPreamble;
+  }
+  uint32_t airUs = DutyCycle_loraAirUs(&pkt, &loraConfig.mod);
+  if (!DutyCycle_reserve(rfFreqHz, airUs)) {
+    if (coded != 0 && txCodecDone != nullptr) {
+      txCodecDone(false);
+    }
+    SnipsRadio_unlock();
+    return false;
+  }
+
+  ok &= sx126x_write_buffer(&radio, SNIPS_RADIO_TX_BASE, data, len) == SX126X_STATUS_OK;
+  ok &= sx126x_set_lora_pkt_params(&radio, &pkt) == SX126X_STATUS_OK;
+  ok &= sx126x_set_tx(&radio, timeoutMs) == SX126X_STATUS_OK;
+  pktParamsDirty = true;
+  if (!ok) {
+    DutyCycle_release(rfFreqHz, airUs);
+  }
+  if (coded != 0 && txCodecDone != nullptr) {
+    txCodecDone(ok);
+  }
+  SnipsRadio_unlock();
+  return ok;
+}
+
+void SnipsRadio_setTxPreamble(uint16_t symbols) {
+  SnipsRadio_lock();
+  txPreamble = symbols;
+  SnipsRadio_unlock();
+}
+
+bool SnipsRadio_transmitWith(const sx126x_pkt_params_lora_t* pkt, const uint8_t* data, uint32_t timeoutMs) {
+  bool ok = true;
+  if (gfskMode) {
+    return false;
+  }
+
+  uint32_t airUs = DutyCycle_loraAirUs(pkt, &loraConfig.mod);
+  SnipsRadio_lock();
+  if (!DutyCycle_reserve(rfFreqHz, airUs)) {
+    SnipsRadio_unlock();
+    return false;
+  }
+
+  ok &= sx126x_write_buffer(&radio, SNIPS_RADIO_TX_BASE, data, pkt->pld_len_in_bytes) == SX126X_STATUS_OK;
+  ok &= sx126x_set_lora_pkt_params(&radio, pkt) == SX126X_STATUS_OK;
+  ok &= sx126x_set_tx(&radio, timeoutMs) == SX126X_STATUS_OK;
+  pktParamsDirty = true;
+  if (!ok) {
+    DutyCycle_release(rfFreqHz, airUs);
+  }
+  SnipsRadio_unlock();
+  return ok;
+}
+
+bool SnipsRadio_transmitGfsk(const uint8_t* data, uint8_t len, uint32_t timeoutMs) {
+  bool ok = true;
+  if (!gfskMode) {
+    return false;
+  }
+
+  sx126x_pkt_params_gfsk_t pkt = gfskConfig.pkt;
+  pkt.pld_len_in_bytes = len;
+  uint32_t airUs = DutyCycle_gfskAirUs(&pkt, &gfskConfig.mod);
+  SnipsRadio_lock();
+  if (!DutyCycle_reserve(rfFreqHz, airUs)) {
+    SnipsRadio_unlock();
+    return false;
+  }
+
+  ok &= sx126x_write_buffer(&radio, SNIPS_RADIO_TX_BASE, data, len) == SX126X_STATUS_OK;
+  ok &= sx126x_set_gfsk_pkt_params(&radio, &pkt) == SX126X_STATUS_OK;
+  ok &= sx126x_set_tx(&radio, timeoutMs) == SX126X_STATUS_OK;
+  pktParamsDirty = true;
+  if (!ok) {
+    DutyCycle_release(rfFreqHz, airUs);
+  }
+  SnipsRadio_unlock();
+  return ok;
+}
+
+bool SnipsRadio_addRxHook(SnipsRadioRxHook hook) {
+  if (rxHookCount >= SNIPS_RADIO_MAX_HOOKS) {
+    return false;
+  }
+  rxHooks[rxHookCount++] = hook;
+  return true;
+}
+
+bool SnipsRadio_addIrqHook(SnipsRadioIrqHook hook) {
+  if (irqHookCount >= SNIPS_RADIO_MAX_HOOKS) {
+    return false;
+  }
+  irqHooks[irqHookCount++] = hook;
+  return true;
+}
+
+void SnipsRadio_setRxStartHook(SnipsRadioRxStartHook hook) {
+  SnipsRadio_lock();
+  rxStartHook = hook;
+  SnipsRadio_unlock();
+}
+
+void SnipsRadio_setGfskRxHook(SnipsRadioRxHook hook) {
+  SnipsRadio_lock();
+  gfskRxHook = hook;
+  SnipsRadio_unlock();
+}
+
+void SnipsRadio_setCodec(SnipsRadioTxCodec tx, SnipsRadioTxCodecDone txDone, SnipsRadioRxCodec rx) {
+  SnipsRadio_lock();
+  txCodec = tx;
+  txCodecDone = txDone;
+  rxCodec = rx;
+  SnipsRadio_unlock();
+}
+
+bool SnipsRadio_receive(SnipsRxPacket* pkt, uint32_t timeoutMs) {
+  return xQueueReceive(rxQueue, pkt, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <Arduino.h>
+#include <SPI.h>
+#include "sx126x.h"
+
+// ============================================================================
+// SX1262 RADIO CORE
+// ============================================================================
+//
+// Owns the SPI bus, implements the sx126x driver HAL and runs the DIO1
+// handler. The DIO1 edge only wakes the radio task; the task harvests the
+// IRQ status (and the packet on RX_DONE), runs the registered fast-path
+// hooks in that same context and only then queues the packet for the
+// application.
+//
+
+#ifndef SNIPS_RADIO_SPI_HZ
+#define SNIPS_RADIO_SPI_HZ        8000000
+#endif
+
+#ifndef SNIPS_RADIO_TASK_PRIORITY
+#define SNIPS_RADIO_TASK_PRIORITY (configMAX_PRIORITIES - 1)
+#endif
+
+#ifndef SNIPS_RADIO_TASK_CORE
+#define SNIPS_RADIO_TASK_CORE     1
+#endif
+
+#define SNIPS_RADIO_MAX_HOOKS     4
+#define SNIPS_RADIO_RX_QUEUE_LEN  4
+
+// Radio buffer layout: TX frames at 0x00, RX frames at 0x80.
+#define SNIPS_RADIO_TX_BASE       0x00
+#define SNIPS_RADIO_RX_BASE       0x80
+
+struct SnipsRadioContext {
+  SPIClass* spi;
+  uint8_t nss;
+  uint8_t busy;
+  uint8_t reset;
+  uint8_t dio1;
+  volatile bool sleeping;
+};
+
+struct SnipsLoraConfig {
+  uint32_t freqHz;
+  int8_t txPowerDbm;
+  uint8_t syncWord;
+  sx126x_mod_params_lora_t mod;
+  sx126x_pkt_params_lora_t pkt;
+};
+
+struct SnipsGfskConfig {
+  uint32_t freqHz;
+  int8_t txPowerDbm;
+  uint8_t syncWord[8];
+  uint8_t syncWordLen;         // bytes
+  uint8_t nodeAddr;            // address filtering on the first payload byte
+  uint8_t broadcastAddr;
+  sx126x_mod_params_gfsk_t mod;
+  sx126x_pkt_params_gfsk_t pkt;
+};
+
+struct SnipsRxPacket {
+  uint8_t data[255];
+  uint8_t len;
+  sx126x_pkt_status_lora_t status;   // GFSK: only rssi_pkt_in_dbm is set
+  sx126x_irq_mask_t irq;
+  uint32_t dio1Us;
+};
+
+// Called from the radio task right after an RX_DONE harvest, with the radio
+// lock held. Return true to consume the packet (it is then not queued).
+typedef bool (*SnipsRadioRxHook)(const SnipsRxPacket* pkt);
+
+// Called from the radio task for every DIO1 event, with the radio lock held.
+typedef void (*SnipsRadioIrqHook)(sx126x_irq_mask_t irq, uint32_t dio1Us);
+
+// Called from SnipsRadio_startRx once the chip is in RX, with the radio
+// lock held (EntropyPool harvests the RNG register there).
+typedef void (*SnipsRadioRxStartHook)();
+
+// Frame codec for LoRa traffic (header compression). The TX side rewrites
+// a frame into out and returns its new length (0: send unchanged), and
+// txDone then reports whether that frame went on air (false: refused by
+// the duty cycle or not taken by the chip) so the codec only commits state
+// for frames actually sent. The RX side rewrites a harvested packet in
+// place before any hook sees it and returns false to drop it. All run with
+// the radio lock held.
+typedef uint8_t (*SnipsRadioTxCodec)(const uint8_t* frame, uint8_t len, uint8_t* out);
+typedef void (*SnipsRadioTxCodecDone)(bool sent);
+typedef bool (*SnipsRadioRxCodec)(SnipsRxPacket* pkt);
+
+bool SnipsRadio_begin();
+const void* SnipsRadio_context();
+
+// Multi-command sequences must hold the radio lock (recursive).
+void SnipsRadio_lock();
+void SnipsRadio_unlock();
+
+bool SnipsRadio_waitNotBusy(uint32_t timeoutUs);
+bool SnipsRadio_isSleeping();
+
+bool SnipsRadio_configureLora(const SnipsLoraConfig* cfg);
+const SnipsLoraConfig* SnipsRadio_loraConfig();
+
+// Switches the modem to GFSK for a scheduled bulk window. While in GFSK,
+// received packets skip the LoRa fast-path hooks and go to the GFSK hook
+// only, and SnipsRadio_transmit is refused. configureLora switches back.
+bool SnipsRadio_configureGfsk(const SnipsGfskConfig* cfg);
+const SnipsGfskConfig* SnipsRadio_gfskConfig();
+bool SnipsRadio_isGfsk();
+
+// Current carrier, for duty-cycle accounting. Code that retunes without
+// configureLora (FreqPlan) reports the new carrier through noteFrequency.
+uint32_t SnipsRadio_frequencyHz();
+void SnipsRadio_noteFrequency(uint32_t freqHz);
+
+// Every TX loads its own packet params, and the payload length in them is
+// also the longest packet RX accepts. Code that loads packet params around
+// SnipsRadio (AckEngine) reports it through notePktParams; restorePktParams
+// puts the configured ones (LoRa or GFSK) back before RX, and startRx does
+// so itself.
+void SnipsRadio_notePktParams();
+bool SnipsRadio_restorePktParams();
+bool SnipsRadio_startRx(uint32_t timeoutMs);
+
+// Fixed-format RX window (e.g. implicit-header beacons): pkt is applied for
+// reception and every packet goes to hook alone, bypassing the codec and
+// the fast-path hooks, until endRxProfile restores the configured params.
+bool SnipsRadio_beginRxProfile(const sx126x_pkt_params_lora_t* pkt, SnipsRadioRxHook hook);
+bool SnipsRadio_endRxProfile();
+
+// Reserved with the DutyCycle governor under the radio lock, and released
+// if the chip does not take the TX; refused (false) if the sub-band budget
+// is exhausted.
+bool SnipsRadio_transmit(const uint8_t* data, uint8_t len, uint32_t timeoutMs);
+bool SnipsRadio_transmitGfsk(const uint8_t* data, uint8_t len, uint32_t timeoutMs);
+
+// Preamble of frames sent through SnipsRadio_transmit (0: the configured
+// one) until set again; TschRadio sets it per slot and clears it when the
+// cell ends. Reception keeps the configured preamble, which covers any
+// shorter one.
+void SnipsRadio_setTxPreamble(uint16_t symbols);
+
+// LoRa TX with its own packet params (pkt->pld_len_in_bytes bytes of data),
+// not passed through the codec. Duty cycle as for SnipsRadio_transmit.
+bool SnipsRadio_transmitWith(const sx126x_pkt_params_lora_t* pkt, const uint8_t* data, uint32_t timeoutMs);
+
+bool SnipsRadio_addRxHook(SnipsRadioRxHook hook);
+bool SnipsRadio_addIrqHook(SnipsRadioIrqHook hook);
+void SnipsRadio_setGfskRxHook(SnipsRadioRxHook hook);
+void SnipsRadio_setCodec(SnipsRadioTxCodec tx, SnipsRadioTxCodecDone txDone, SnipsRadioRxCodec rx);
+void SnipsRadio_setRxStartHook(SnipsRadioRxStartHook hook);
+
+// Blocks until a harvested packet is available or the timeout expires.
+bool SnipsRadio_receive(SnipsRxPacket* pkt, uint32_t timeoutMs);
@@ -0,0 +1,143 @@
+#include "ArqSim.h"
+#include "Arq.h"
+#include "SimRng.h"
+#include "sx126x.h"
+#include "SimQueue.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static ArqSender sender;
+static ArqReceiver receiver;
+static SimQueue backlog;
+static uint32_t queuedSf[256];     // by sequence number
+static uint8_t frame[SNIPS_FRAME_MAX_LEN];
+
+static const sx126x_mod_params_lora_t simMod = { SX126X_LORA_SF7, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5, 0 };
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t airMs(uint8_t len) {
+  sx126x_pkt_params_lora_t pkt = { 8, SX126X_LORA_PKT_EXPLICIT, len, true, false };
+  return sx126x_get_lora_time_on_air_in_ms(&pkt, &simMod);
+}
+
+static void recordDelivery(ArqSimResult* result, uint64_t* latencySum, uint32_t latency) {
+  result->delivered++;
+  *latencySum += latency;
+  result->maxLatencySf = latency > result->maxLatencySf ? latency : result->maxLatencySf;
+}
+
+static void offer(const ArqSimConfig* config, uint32_t sf, ArqSimResult* result) {
+  for (uint8_t i = 0; i < config->framesPerSf; i++) {
+    result->offered++;
+    if (!SimQueue_pushSorted(&backlog, sf, backlog.count)) {
+      result->overflow++;
+    }
+  }
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+static void runBlock(const ArqSimConfig* config, SimRng* rng, ArqSimResult* result, uint64_t* latencySum) {
+  ArqStats stats = {};
+  ArqSender_init(&sender);
+  ArqReceiver_init(&receiver);
+  uint8_t frameLen = SNIPS_FRAME_HEADER_LEN + config->payloadLen;
+  memset(frame, 0, sizeof(frame));
+
+  for (uint32_t sf = 0; sf < config->superframes; sf++) {
+    offer(config, sf, result);
+    while (backlog.count > 0 && ArqSender_inFlight(&sender) < ARQ_WINDOW) {
+      queuedSf[sender.nextSeq] = SimQueue_pop(&backlog);
+      ArqSender_queue(&sender, frame, frameLen, &stats);
+    }
+
+    // A's slot
+    for (uint8_t t = 0; t < config->slotFrames; t++) {
+      uint8_t len = ArqSender_next(&sender, sf, frame, &stats);
+      if (len == 0) {
+        break;
+      }
+      result->dataAirMs += airMs(len);
+      uint8_t seq = frame[SNIPS_FRAME_OFFSET_SEQ];
+      if (!SimRng_chance(rng, config->lossPercent) && ArqReceiver_accept(&receiver, seq, &stats)) {
+        recordDelivery(result, latencySum, sf - queuedSf[seq]);
+      }
+    }
+
+    // B's slot: one block ACK for the superframe
+    if (receiver.ackPending) {
+      uint8_t ack[ARQ_ACK_LEN];
+      ArqReceiver_encodeAck(&receiver, ack);
+      if (SimRng_chance(rng, config->reversePercent)) {
+        result->ackAirMs += airMs(frameLen + ARQ_ACK_LEN) - airMs(frameLen);
+      } else {
+        result->ackAirMs += airMs(SNIPS_FRAME_HEADER_LEN + ARQ_ACK_LEN);
+      }
+      if (!SimRng_chance(rng, config->lossPercent)) {
+        ArqSender_onAck(&sender, ack, &stats);
+      }
+    }
+  }
+
+  result->dropped = stats.dropped;
+  result->backlog = backlog.count + ArqSender_inFlight(&sender);
+}
+
+static void runPerFrame(const ArqSimConfig* config, SimRng* rng, ArqSimResult* result, uint64_t* latencySum) {
+  uint8_t frameLen = SNIPS_FRAME_HEADER_LEN + config->payloadLen;
+  uint32_t ackMs = airMs(SNIPS_FRAME_HEADER_LEN + 2);
+  uint8_t retries = 0;
+  bool headDelivered = false;
+
+  for (uint32_t sf = 0; sf < config->superframes; sf++) {
+    offer(config, sf, result);
+
+    for (uint8_t t = 0; t < config->slotFrames && backlog.count > 0; t++) {
+      result->dataAirMs += airMs(frameLen);
+      bool acked = false;
+      if (!SimRng_chance(rng, config->lossPercent)) {
+        if (!headDelivered) {
+          headDelivered = true;
+          recordDelivery(result, latencySum, sf - backlog.arrivalMs[backlog.head]);
+        }
+        result->ackAirMs += ackMs;
+        acked = !SimRng_chance(rng, config->lossPercent);
+      }
+
+      if (acked || retries >= ARQ_MAX_RETRIES) {
+        if (!acked) {
+          result->dropped++;
+        }
+        SimQueue_pop(&backlog);
+        retries = 0;
+        headDelivered = false;
+      } else {
+        retries++;
+      }
+    }
+  }
+  result->backlog = backlog.count;
+}
+
+void ArqSim_run(const ArqSimConfig* config, ArqSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  memset(&backlog, 0, sizeof(backlog));
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  uint64_t latencySum = 0;
+  if (config->blockAck) {
+    runBlock(config, &rng, result, &latencySum);
+  } else {
+    runPerFrame(config, &rng, result, &latencySum);
+  }
+  result->meanLatencySf = result->delivered ? (uint32_t) (latencySum * 100 / result->delivered) : 0;
+}
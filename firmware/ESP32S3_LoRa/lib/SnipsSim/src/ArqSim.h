@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// ARQ SIMULATION
+// ============================================================================
+//
+// One link, A -> B, over superframes. A gets framesPerSf new frames each
+// superframe and may put slotFrames transmissions on air in its slot; every
+// frame (data or ACK) is lost independently with lossPercent.
+//
+// Block mode runs ArqSender / ArqReceiver: B answers once per superframe in
+// its own slot, piggybacked on reverse traffic when it has some
+// (reversePercent) or standalone otherwise. Per-frame mode is the AckEngine
+// pattern: every received data frame is ACKed at once and A retries
+// straight away until the ACK arrives or the retries run out.
+//
+
+struct ArqSimConfig {
+  uint16_t superframes;
+  uint8_t framesPerSf;
+  uint8_t slotFrames;
+  uint8_t payloadLen;
+  uint8_t lossPercent;
+  uint8_t reversePercent;
+  bool blockAck;
+  uint32_t seed;
+};
+
+struct ArqSimResult {
+  uint32_t offered;
+  uint32_t delivered;        // distinct frames at B
+  uint32_t dropped;          // retries exhausted
+  uint32_t overflow;         // source queue full
+  uint32_t backlog;          // still queued at the end
+  uint32_t meanLatencySf;    // x100
+  uint32_t maxLatencySf;
+  uint32_t dataAirMs;
+  uint32_t ackAirMs;
+};
+
+void ArqSim_run(const ArqSimConfig* config, ArqSimResult* result);
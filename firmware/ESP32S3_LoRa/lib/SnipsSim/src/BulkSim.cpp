@@ -0,0 +1,95 @@
+#include "BulkSim.h"
+#include "BulkTransfer.h"
+#include "SimRng.h"
+#include "sx126x.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static BulkSender sender;
+static BulkReceiver receiver;
+static uint8_t chunk[BULK_CHUNK_LEN];
+static uint8_t packet[BULK_MAX_PACKET_LEN];
+
+static const sx126x_mod_params_lora_t loraMod = { SX126X_LORA_SF7, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5, 0 };
+static const sx126x_mod_params_gfsk_t gfskMod = { 300000, 62500, SX126X_GFSK_PULSE_SHAPE_BT_05,
+                                                  SX126X_GFSK_BW_467000 };
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t airUs(bool gfsk, uint8_t len) {
+  if (gfsk) {
+    sx126x_pkt_params_gfsk_t pkt = { 32, SX126X_GFSK_PREAMBLE_DETECTOR_MIN_16BITS, 32,
+                                     SX126X_GFSK_ADDRESS_FILTERING_NODE_AND_BROADCAST_ADDRESSES,
+                                     SX126X_GFSK_PKT_VAR_LEN, len, SX126X_GFSK_CRC_2_BYTES_INV,
+                                     SX126X_GFSK_DC_FREE_WHITENING };
+    return (uint32_t) ((uint64_t) sx126x_get_gfsk_time_on_air_numerator(&pkt) * 1000000ULL / gfskMod.br_in_bps);
+  }
+  sx126x_pkt_params_lora_t pkt = { 8, SX126X_LORA_PKT_EXPLICIT, len, true, false };
+  return (uint32_t) ((uint64_t) sx126x_get_lora_time_on_air_numerator(&pkt, &loraMod) * 1000000ULL /
+                     sx126x_get_lora_bw_in_hz(loraMod.bw));
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void BulkSim_run(const BulkSimConfig* config, BulkSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  BulkStats stats = {};
+  BulkSender_init(&sender, 0x42, config->size);
+  BulkReceiver_init(&receiver);
+  memset(chunk, 0, sizeof(chunk));
+
+  uint32_t ackUs = airUs(config->gfsk, BULK_ACK_PACKET_LEN);
+  uint32_t timeoutUs = ackUs + config->turnaroundMs * 1000;
+  uint64_t elapsedUs = 0;
+  uint64_t totalAirUs = 0;
+
+  while (!BulkSender_done(&sender) && stats.ackTimeouts < 10000) {
+    bool poll = false;
+    bool pollHeard = false;
+    int32_t index;
+    while ((index = BulkSender_next(&sender, &poll, &stats)) >= 0) {
+      uint8_t len = BulkSender_encode(&sender, 2, 1, index, poll, chunk, packet);
+      uint32_t us = airUs(config->gfsk, len);
+      elapsedUs += us;
+      totalAirUs += us;
+
+      uint16_t got;
+      if (!SimRng_chance(&rng, config->lossPercent)) {
+        BulkReceiver_accept(&receiver, packet, len, &got, &stats);
+        pollHeard = poll;
+      }
+    }
+
+    if (pollHeard && !SimRng_chance(&rng, config->lossPercent)) {
+      uint8_t len = BulkReceiver_encodeAck(&receiver, 1, 2, packet);
+      elapsedUs += config->turnaroundMs * 1000 + ackUs;
+      totalAirUs += ackUs;
+      BulkSender_onAck(&sender, packet, len, &stats);
+    } else {
+      if (pollHeard) {
+        totalAirUs += ackUs;
+      }
+      elapsedUs += timeoutUs;
+      BulkSender_onTimeout(&sender, &stats);
+    }
+  }
+
+  result->packets = stats.chunksSent;
+  result->retransmitted = stats.retransmitted;
+  result->polls = stats.polls;
+  result->ackTimeouts = stats.ackTimeouts;
+  result->airMs = (uint32_t) (totalAirUs / 1000);
+  result->elapsedMs = (uint32_t) (elapsedUs / 1000);
+  result->goodputBps = elapsedUs ? (uint32_t) ((uint64_t) config->size * 8 * 1000000ULL / elapsedUs) : 0;
+  result->complete = BulkReceiver_done(&receiver) && stats.delivered == receiver.chunks;
+}
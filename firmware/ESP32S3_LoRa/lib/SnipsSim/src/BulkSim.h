@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// BULK TRANSFER SIMULATION
+// ============================================================================
+//
+// One anchor-to-anchor transfer of `size` bytes with BulkSender /
+// BulkReceiver, either over the GFSK backhaul (300 kbps) or over LoRa
+// SF7/125 kHz with the same 255-byte packets and window. Every packet (data
+// or ACK) is lost independently with lossPercent. Time runs on packet
+// airtime plus turnaroundMs per poll; a lost poll or ACK costs the ACK
+// timeout instead.
+//
+
+struct BulkSimConfig {
+  uint32_t size;
+  uint8_t lossPercent;
+  uint8_t turnaroundMs;
+  bool gfsk;
+  uint32_t seed;
+};
+
+struct BulkSimResult {
+  uint32_t packets;
+  uint32_t retransmitted;
+  uint32_t polls;
+  uint32_t ackTimeouts;
+  uint32_t airMs;
+  uint32_t elapsedMs;
+  uint32_t goodputBps;
+  bool complete;             // every chunk delivered exactly once
+};
+
+void BulkSim_run(const BulkSimConfig* config, BulkSimResult* result);
@@ -0,0 +1,92 @@
+#include "DedupSim.h"
+#include "Dedup.h"
+#include "SimRng.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define SIM_TICK_MS          10
+#define SIM_MAX_PENDING      512
+#define SIM_MAX_SOURCES      64
+#define SIM_MAX_SET_SLOTS    4096
+#define SIM_MAX_BLOOM_BITS   32768
+
+struct PendingCopy {
+  uint32_t atMs;
+  uint8_t src;
+  uint8_t seq;
+  bool used;
+};
+
+static PendingCopy pending[SIM_MAX_PENDING];
+static DedupEntry setStorage[SIM_MAX_SET_SLOTS];
+static uint8_t bloomStorage[SIM_MAX_BLOOM_BITS / 4];
+static uint32_t nextSendMs[SIM_MAX_SOURCES];
+static uint8_t nextSeq[SIM_MAX_SOURCES];
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void DedupSim_run(const DedupSimConfig* config, DedupSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  memset(pending, 0, sizeof(pending));
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  DedupSet set;
+  DedupBloom bloom;
+  if (config->bloom) {
+    uint16_t bits = config->size <= SIM_MAX_BLOOM_BITS ? config->size : SIM_MAX_BLOOM_BITS;
+    DedupBloom_init(&bloom, bloomStorage, bits, 0);
+    result->memoryBytes = bits / 4;
+  } else {
+    uint16_t slots = config->size <= SIM_MAX_SET_SLOTS ? config->size : SIM_MAX_SET_SLOTS;
+    DedupSet_init(&set, setStorage, slots);
+    result->memoryBytes = slots * sizeof(DedupEntry);
+  }
+
+  uint8_t sources = config->sources <= SIM_MAX_SOURCES ? config->sources : SIM_MAX_SOURCES;
+  for (uint8_t s = 0; s < sources; s++) {
+    nextSendMs[s] = SimRng_uniform(&rng, config->periodMs);
+    nextSeq[s] = (uint8_t) SimRng_next(&rng);
+  }
+
+  for (uint32_t now = 0; now < config->durationMs; now += SIM_TICK_MS) {
+    for (uint8_t s = 0; s < sources; s++) {
+      if (nextSendMs[s] > now) {
+        continue;
+      }
+      uint8_t seq = nextSeq[s]++;
+      nextSendMs[s] += config->periodMs;
+      result->frames++;
+      bool dup = config->bloom ? DedupBloom_check(&bloom, s, seq, now) : DedupSet_check(&set, s, seq, now);
+      if (dup) {
+        result->falsePositives++;
+      }
+
+      uint8_t scheduled = 1;
+      for (uint16_t p = 0; p < SIM_MAX_PENDING && scheduled < config->copies; p++) {
+        if (!pending[p].used) {
+          pending[p] = { now + 1 + SimRng_uniform(&rng, config->spreadMs), s, seq, true };
+          scheduled++;
+        }
+      }
+    }
+
+    for (uint16_t p = 0; p < SIM_MAX_PENDING; p++) {
+      if (!pending[p].used || pending[p].atMs > now) {
+        continue;
+      }
+      pending[p].used = false;
+      result->copies++;
+      bool dup = config->bloom ? DedupBloom_check(&bloom, pending[p].src, pending[p].seq, now)
+                               : DedupSet_check(&set, pending[p].src, pending[p].seq, now);
+      if (!dup) {
+        result->missed++;
+      }
+    }
+  }
+}
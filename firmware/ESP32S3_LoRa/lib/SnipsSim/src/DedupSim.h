@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// DUPLICATE SUPPRESSION SIMULATION
+// ============================================================================
+//
+// Flood traffic as a relay sees it: every source sends a frame each
+// periodMs (sequence numbers wrap at 256), and each frame reaches the relay
+// `copies` times over different paths, the first copy on time and the rest
+// within spreadMs. Every copy is checked against a DedupSet or DedupBloom of
+// the given size; the ground truth counts new frames taken for duplicates
+// and duplicates let through.
+//
+
+struct DedupSimConfig {
+  uint8_t sources;
+  uint16_t periodMs;
+  uint8_t copies;
+  uint16_t spreadMs;
+  uint32_t durationMs;
+  bool bloom;
+  uint16_t size;             // set slots (power of two) or bloom bits
+  uint32_t seed;
+};
+
+struct DedupSimResult {
+  uint32_t frames;           // distinct frames
+  uint32_t copies;           // later copies
+  uint32_t falsePositives;   // new frames dropped as duplicates
+  uint32_t missed;           // later copies let through
+  uint16_t memoryBytes;
+};
+
+void DedupSim_run(const DedupSimConfig* config, DedupSimResult* result);
@@ -0,0 +1,64 @@
+#include "DutyCycleSim.h"
+#include "DutyCycle.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static DutyCycleWindow window;
+static uint32_t sentMs[DUTY_CYCLE_SIM_MAX_FRAMES];
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+// Airtime of the sent frames inside [fromMs, fromMs + DUTY_CYCLE_WINDOW_MS).
+static uint32_t airtimeIn(uint32_t count, uint32_t frameMs, uint32_t fromMs) {
+  uint32_t toMs = fromMs + DUTY_CYCLE_WINDOW_MS;
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t start = sentMs[i] > fromMs ? sentMs[i] : fromMs;
+    uint32_t end = sentMs[i] + frameMs < toMs ? sentMs[i] + frameMs : toMs;
+    if (end > start) {
+      total += end - start;
+    }
+  }
+  return total;
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void DutyCycleSim_run(const DutyCycleSimConfig* config, DutyCycleSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  DutyCycleWindow_init(&window, 0);
+
+  // Same budget as DutyCycle: window * limit / 1000
+  uint32_t budgetUs = DUTY_CYCLE_WINDOW_MS * config->limitTenthPercent;
+  uint32_t airUs = (uint32_t) config->frameMs * 1000;
+  result->budgetMs = budgetUs / 1000;
+
+  for (uint32_t t = config->startMs; t < config->startMs + config->durationMs; t += config->periodMs) {
+    if (result->framesSent >= DUTY_CYCLE_SIM_MAX_FRAMES) {
+      break;
+    }
+    if (DutyCycleWindow_waitMs(&window, budgetUs, airUs, t) == 0) {
+      DutyCycleWindow_charge(&window, airUs, t);
+      sentMs[result->framesSent++] = t;
+    }
+  }
+
+  // The fullest window starts at a frame's start or ends at a frame's end
+  for (uint32_t i = 0; i < result->framesSent; i++) {
+    uint32_t endMs = sentMs[i] + config->frameMs;
+    uint32_t candidates[] = { sentMs[i], endMs > DUTY_CYCLE_WINDOW_MS ? (uint32_t) (endMs - DUTY_CYCLE_WINDOW_MS) : 0 };
+    for (uint32_t fromMs : candidates) {
+      uint32_t used = airtimeIn(result->framesSent, config->frameMs, fromMs);
+      if (used > result->maxWindowMs) {
+        result->maxWindowMs = used;
+      }
+    }
+  }
+}
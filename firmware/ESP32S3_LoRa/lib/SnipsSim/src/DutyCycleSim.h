@@ -0,0 +1,31 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// DUTY-CYCLE WINDOW SIMULATION
+// ============================================================================
+//
+// A greedy sender on one sub-band: from startMs it tries a frameMs frame
+// every periodMs and sends whenever the DutyCycleWindow lets it, so its
+// first burst spends the whole budget wherever startMs falls in a bucket.
+// Every sent frame is kept, and the airtime in every true sliding window of
+// DUTY_CYCLE_WINDOW_MS is measured against the budget.
+//
+
+#define DUTY_CYCLE_SIM_MAX_FRAMES  4096
+
+struct DutyCycleSimConfig {
+  uint16_t limitTenthPercent;
+  uint16_t frameMs;
+  uint16_t periodMs;
+  uint32_t startMs;
+  uint32_t durationMs;
+};
+
+struct DutyCycleSimResult {
+  uint32_t framesSent;
+  uint32_t budgetMs;
+  uint32_t maxWindowMs;      // most airtime in any sliding window
+};
+
+void DutyCycleSim_run(const DutyCycleSimConfig* config, DutyCycleSimResult* result);
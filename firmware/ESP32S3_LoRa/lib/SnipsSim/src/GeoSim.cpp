@@ -0,0 +1,217 @@
+#include "GeoSim.h"
+#include "GeoRouting.h"
+#include "SimRng.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static GeoPoint pos[GEO_SIM_MAX_NODES];
+static GeoNeighbor tables[GEO_SIM_MAX_NODES][GEO_MAX_NEIGHBORS];
+static uint8_t tableCount[GEO_SIM_MAX_NODES];
+static uint8_t depth[GEO_SIM_MAX_NODES];
+static uint8_t bfsQueue[GEO_SIM_MAX_NODES];
+static uint8_t cache[GEO_SIM_MAX_NODES][GEO_MAX_LOCATIONS];
+static uint8_t cacheCount[GEO_SIM_MAX_NODES];
+static uint8_t cacheNext[GEO_SIM_MAX_NODES];
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static int32_t distSq(uint8_t a, uint8_t b) {
+  int32_t dx = pos[a].x - pos[b].x;
+  int32_t dy = pos[a].y - pos[b].y;
+  return dx * dx + dy * dy;
+}
+
+// Hop counts from src over the neighbor tables; returns nodes reached.
+static uint8_t bfs(uint8_t nodes, uint8_t src) {
+  memset(depth, 0xFF, sizeof(depth));
+  depth[src] = 0;
+  uint8_t head = 0;
+  uint8_t tail = 0;
+  bfsQueue[tail++] = src;
+  while (head < tail) {
+    uint8_t u = bfsQueue[head++];
+    for (uint8_t i = 0; i < tableCount[u]; i++) {
+      uint8_t v = tables[u][i].addr;
+      if (depth[v] == 0xFF) {
+        depth[v] = depth[u] + 1;
+        bfsQueue[tail++] = v;
+      }
+    }
+  }
+  (void) nodes;
+  return tail;
+}
+
+static void buildTables(uint8_t nodes, int32_t rangeSq) {
+  for (uint8_t a = 0; a < nodes; a++) {
+    tableCount[a] = 0;
+    for (uint8_t b = 0; b < nodes; b++) {
+      int32_t d = distSq(a, b);
+      if (b == a || d > rangeSq) {
+        continue;
+      }
+      // Insertion by distance; a full table drops the farthest
+      uint8_t n = tableCount[a];
+      if (n == GEO_MAX_NEIGHBORS && d >= distSq(a, tables[a][n - 1].addr)) {
+        continue;
+      }
+      uint8_t p = n < GEO_MAX_NEIGHBORS ? n : n - 1;
+      while (p > 0 && distSq(a, tables[a][p - 1].addr) > d) {
+        tables[a][p] = tables[a][p - 1];
+        p--;
+      }
+      tables[a][p] = { b, pos[b], 0 };
+      if (n < GEO_MAX_NEIGHBORS) {
+        tableCount[a]++;
+      }
+    }
+  }
+
+  // Links must be symmetric for the planar walk
+  for (uint8_t a = 0; a < nodes; a++) {
+    for (uint8_t i = 0; i < tableCount[a];) {
+      uint8_t b = tables[a][i].addr;
+      bool mutual = false;
+      for (uint8_t j = 0; j < tableCount[b] && !mutual; j++) {
+        mutual = tables[b][j].addr == a;
+      }
+      if (mutual) {
+        i++;
+      } else {
+        tables[a][i] = tables[a][--tableCount[a]];
+      }
+    }
+  }
+}
+
+static bool knows(uint8_t node, uint8_t target) {
+  for (uint8_t i = 0; i < tableCount[node]; i++) {
+    if (tables[node][i].addr == target) {
+      return true;
+    }
+  }
+  for (uint8_t i = 0; i < cacheCount[node]; i++) {
+    if (cache[node][i] == target) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void learn(uint8_t node, uint8_t target) {
+  if (knows(node, target)) {
+    return;
+  }
+  cache[node][cacheNext[node]] = target;
+  cacheNext[node] = (cacheNext[node] + 1) % GEO_MAX_LOCATIONS;
+  if (cacheCount[node] < GEO_MAX_LOCATIONS) {
+    cacheCount[node]++;
+  }
+}
+
+// Geographic forwarding from src to dst. Returns true if delivered; the
+// hops taken (delivered or not) go to greedy / perimeter.
+static bool geoWalk(uint8_t src, uint8_t dst, uint32_t* greedy, uint32_t* perimeter) {
+  GeoHeader header;
+  GeoHeader_init(&header, pos[dst]);
+  uint8_t at = src;
+  uint8_t prev = GEO_NO_ROUTE;
+  *greedy = 0;
+  *perimeter = 0;
+  for (uint8_t ttl = 0; ttl < GEO_SIM_TTL && at != dst; ttl++) {
+    bool wasPerimeter = header.mode == GEO_MODE_PERIMETER;
+    uint8_t next = GeoRouting_choose(at, pos[at], tables[at], tableCount[at], dst, prev, &header);
+    if (next == GEO_NO_ROUTE) {
+      break;
+    }
+    if (wasPerimeter || header.mode == GEO_MODE_PERIMETER) {
+      (*perimeter)++;
+    } else {
+      (*greedy)++;
+    }
+    prev = at;
+    at = next;
+  }
+  return at == dst;
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void GeoSim_run(const GeoSimConfig* config, GeoSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  uint8_t nodes = config->nodes <= GEO_SIM_MAX_NODES ? config->nodes : GEO_SIM_MAX_NODES;
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  uint32_t side = 0;
+  while ((side + 1) * (side + 1) <= nodes) {
+    side++;
+  }
+  side = side * config->spacingM + config->spacingM / 2;
+  for (uint8_t i = 0; i < nodes; i++) {
+    pos[i].x = (int16_t) SimRng_uniform(&rng, side);
+    pos[i].y = (int16_t) SimRng_uniform(&rng, side);
+  }
+  buildTables(nodes, (int32_t) config->rangeM * config->rangeM);
+  memset(cacheCount, 0, sizeof(cacheCount));
+  memset(cacheNext, 0, sizeof(cacheNext));
+
+  uint32_t spanMs = (uint32_t) config->routes * config->routeIntervalMs;
+  if (config->helloIntervalMs > 0) {
+    result->helloTx = (spanMs + config->helloIntervalMs - 1) / config->helloIntervalMs * nodes;
+  }
+  for (uint8_t i = 0; i < nodes; i++) {
+    result->neighborsMax = tableCount[i] > result->neighborsMax ? tableCount[i] : result->neighborsMax;
+  }
+
+  for (uint16_t r = 0; r < config->routes; r++) {
+    uint8_t src = (uint8_t) SimRng_uniform(&rng, nodes);
+    uint8_t dst = (uint8_t) SimRng_uniform(&rng, nodes);
+    if (src == dst) {
+      continue;
+    }
+    uint8_t reached = bfs(nodes, src);
+    if (depth[dst] == 0xFF) {
+      continue;
+    }
+    result->routes++;
+
+    // Discovery: every reached node rebroadcasts the request once, the reply
+    // comes back hop by hop; the first data frame follows the reply.
+    result->discoveryTx += reached + depth[dst];
+    result->discoverySf += 2 * depth[dst];
+
+    // Location lookup: the request floods like a discovery request and
+    // teaches every node it reaches where src is; the reply goes back by
+    // geographic forwarding, one hop per superframe.
+    uint32_t greedy;
+    uint32_t perimeter;
+    if (!knows(src, dst)) {
+      result->lookups++;
+      for (uint8_t i = 1; i < reached; i++) {     // bfsQueue[0] is src
+        learn(bfsQueue[i], src);
+      }
+      bool answered = geoWalk(dst, src, &greedy, &perimeter);
+      result->lookupTx += reached + greedy + perimeter;
+      result->lookupSf += depth[dst] + greedy + perimeter;
+      if (!answered) {
+        continue;
+      }
+      learn(src, dst);
+    }
+
+    if (geoWalk(src, dst, &greedy, &perimeter)) {
+      result->delivered++;
+      result->greedyHops += greedy;
+      result->perimeterHops += perimeter;
+      result->shortestHops += depth[dst];
+    }
+  }
+}
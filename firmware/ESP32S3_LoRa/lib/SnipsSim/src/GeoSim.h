@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// GEOGRAPHIC FORWARDING SIMULATION
+// ============================================================================
+//
+// Nodes placed uniformly in a square whose side grows with sqrt(nodes),
+// linked when within rangeM (each keeps its GEO_MAX_NEIGHBORS nearest).
+// Random source/destination pairs are routed hop by hop with
+// GeoRouting_choose and compared against on-demand discovery, where each
+// route floods a request through every reachable node and unicasts a reply
+// back along the shortest path, one hop per superframe Control phase.
+//
+// Geographic control traffic is counted the same way: every node sends a
+// hello each helloIntervalMs over the span of the routes (one route opens
+// every routeIntervalMs), and a source that has neither heard the
+// destination's hello nor cached its position floods a location request.
+// Every node that hears it caches the source's position, and the
+// destination answers by geographic forwarding. Caches hold
+// GEO_MAX_LOCATIONS entries with round-robin replacement, as in
+// GeoRouting.
+//
+
+#define GEO_SIM_MAX_NODES   250
+#define GEO_SIM_TTL         255
+
+struct GeoSimConfig {
+  uint8_t nodes;
+  uint16_t spacingM;
+  uint16_t rangeM;
+  uint16_t routes;
+  uint16_t routeIntervalMs;  // network-wide, between route openings
+  uint16_t helloIntervalMs;
+  uint32_t seed;
+};
+
+struct GeoSimResult {
+  uint16_t routes;           // pairs with a path in the graph
+  uint16_t delivered;        // of those, delivered by geographic forwarding
+  uint32_t greedyHops;
+  uint32_t perimeterHops;
+  uint32_t shortestHops;     // over delivered routes
+  uint32_t discoveryTx;      // request floods + replies, all routes
+  uint32_t discoverySf;      // superframes until the first data frame, all routes
+  uint32_t helloTx;          // over the span of the routes
+  uint32_t lookups;          // routes whose destination position was unknown
+  uint32_t lookupTx;         // request floods + geographic replies
+  uint32_t lookupSf;         // superframes until the first data frame, all routes
+  uint16_t neighborsMax;     // largest neighbor table
+};
+
+void GeoSim_run(const GeoSimConfig* config, GeoSimResult* result);
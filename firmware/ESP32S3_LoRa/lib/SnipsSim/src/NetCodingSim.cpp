@@ -0,0 +1,145 @@
+#include "NetCodingSim.h"
+#include "NetCoding.h"
+#include "SimRng.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define SIM_RELAY  1
+#define SIM_M1     2
+#define SIM_M2     3
+#define SIM_FRAME_LEN  20
+
+struct SimEndpoint {
+  uint8_t addr;
+  uint8_t peer;
+  uint32_t sent;               // frames sent so far
+  uint32_t sentMs[256];        // by seq
+  uint8_t frames[256][SIM_FRAME_LEN];
+  NetCodingEndpoint coding;
+};
+
+static SimEndpoint endpoints[2];
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool arrives(SimRng* rng, uint16_t perMin, uint16_t stepMs) {
+  // Bernoulli per step approximates Poisson arrivals for small steps
+  return SimRng_uniform(rng, 60000) < (uint32_t) perMin * stepMs;
+}
+
+static bool send(SimEndpoint* e, SimRng* rng, uint32_t nowMs) {
+  uint8_t frame[SIM_FRAME_LEN];
+  SnipsFrameHeader header = {};
+  header.netId = SNIPS_NETWORK_ID;
+  header.type = SNIPS_FRAME_DATA;
+  header.src = e->addr;
+  header.dst = e->peer;
+  header.prevHop = e->addr;
+  header.nextHop = SIM_RELAY;
+  header.seq = e->sent & 0xFF;
+  SnipsFrame_encodeHeader(&header, frame);
+  for (uint8_t i = SNIPS_FRAME_HEADER_LEN; i < SIM_FRAME_LEN; i++) {
+    frame[i] = SimRng_uniform(rng, 256);
+  }
+
+  memcpy(e->frames[header.seq], frame, SIM_FRAME_LEN);
+  e->sentMs[header.seq] = nowMs;
+  e->sent++;
+  NetCodingEndpoint_retain(&e->coding, frame, SIM_FRAME_LEN);
+  return NetCoding_relayAdd(frame, SIM_FRAME_LEN, nowMs);
+}
+
+// True if decoded is the peer's frame seq as the relay would have forwarded it.
+static bool matchesForward(const SimEndpoint* peer, uint8_t seq, const uint8_t* decoded, uint8_t len) {
+  uint8_t expected[SIM_FRAME_LEN];
+  memcpy(expected, peer->frames[seq], SIM_FRAME_LEN);
+  expected[SNIPS_FRAME_OFFSET_PREV_HOP] = SIM_RELAY;
+  expected[SNIPS_FRAME_OFFSET_NEXT_HOP] = expected[SNIPS_FRAME_OFFSET_DST];
+  expected[SNIPS_FRAME_OFFSET_HOPS]++;
+  return len == SIM_FRAME_LEN && memcmp(expected, decoded, SIM_FRAME_LEN) == 0;
+}
+
+static SimEndpoint* endpointOf(uint8_t addr) {
+  return addr == SIM_M1 ? &endpoints[0] : &endpoints[1];
+}
+
+static void recordHold(NetCodingSimResult* result, uint64_t* holdSum, uint32_t holdMs) {
+  *holdSum += holdMs;
+  if (holdMs > result->maxHoldMs) {
+    result->maxHoldMs = holdMs;
+  }
+  result->framesRelayed++;
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void NetCodingSim_run(const NetCodingSimConfig* config, NetCodingSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  memset(endpoints, 0, sizeof(endpoints));
+  endpoints[0].addr = SIM_M1;
+  endpoints[0].peer = SIM_M2;
+  endpoints[1].addr = SIM_M2;
+  endpoints[1].peer = SIM_M1;
+  NetCodingEndpoint_init(&endpoints[0].coding, SIM_M1);
+  NetCodingEndpoint_init(&endpoints[1].coding, SIM_M2);
+
+  NetCoding_begin(SIM_RELAY);
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  const uint16_t stepMs = 10;
+  uint64_t holdSum = 0;
+  uint8_t packet[SNIPS_FRAME_MAX_LEN];
+  uint8_t decoded[SNIPS_FRAME_MAX_LEN];
+  NetCodingStats decodeStats = {};
+
+  for (uint32_t now = 0; now < config->durationMs; now += stepMs) {
+    for (uint8_t k = 0; k < 2; k++) {
+      uint16_t rate = k == 0 ? config->rateAPerMin : config->rateBPerMin;
+      if (arrives(&rng, rate, stepMs) && !send(&endpoints[k], &rng, now)) {
+        result->framesDropped++;
+      }
+    }
+
+    if (now % config->relayPeriodMs != 0) {
+      continue;
+    }
+    uint8_t len = NetCoding_relayPoll(now, packet);
+    if (len == 0) {
+      continue;
+    }
+    result->relayTransmissions++;
+
+    if (SnipsFrame_type(packet) != SNIPS_FRAME_CODED) {
+      SimEndpoint* e = endpointOf(packet[SNIPS_FRAME_OFFSET_SRC]);
+      recordHold(result, &holdSum, now - e->sentMs[packet[SNIPS_FRAME_OFFSET_SEQ]]);
+      continue;
+    }
+
+    result->codedTransmissions++;
+    const uint8_t* ids = packet + SNIPS_FRAME_HEADER_LEN;
+    for (uint8_t k = 0; k < 2; k++) {
+      SimEndpoint* e = endpointOf(ids[3 * k]);
+      recordHold(result, &holdSum, now - e->sentMs[ids[3 * k + 1]]);
+
+      // e xors its own copy out to recover the other endpoint's frame
+      SimEndpoint* peer = endpointOf(e->peer);
+      uint8_t peerSeq = ids[3 * (k ^ 1) + 1];
+      uint8_t decodedLen = NetCodingEndpoint_decode(&e->coding, packet, len, decoded, &decodeStats);
+      if (decodedLen == 0) {
+        result->decodeFailures++;
+      } else if (!matchesForward(peer, peerSeq, decoded, decodedLen)) {
+        result->decodeMismatches++;
+      }
+    }
+  }
+
+  result->meanHoldMs = result->framesRelayed ? (uint32_t) (holdSum / result->framesRelayed) : 0;
+}
@@ -0,0 +1,120 @@
+#include "ProfileSim.h"
+#include "SimRng.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static TdmaTimeline master;
+static TdmaTimeline nodeTimeline[PROFILE_SIM_MAX_NODES];
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static const ProfileSimSwitch* upcomingSwitch(const ProfileSimConfig* config, uint32_t superframe) {
+  for (uint8_t i = 0; i < config->switchCount; i++) {
+    const ProfileSimSwitch* sw = &config->switches[i];
+    if (sw->superframe > superframe && sw->superframe - superframe <= config->leadSuperframes) {
+      return sw;
+    }
+  }
+  return nullptr;
+}
+
+static bool sameTimeline(const TdmaTimeline* a, const TdmaTimeline* b) {
+  return a->profile.period == b->profile.period && a->profile.split == b->profile.split &&
+         a->epochSuperframe == b->epochSuperframe;
+}
+
+static bool switchAt(const ProfileSimConfig* config, uint32_t superframe) {
+  for (uint8_t i = 0; i < config->switchCount; i++) {
+    if (config->switches[i].superframe == superframe) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void ProfileSim_run(const ProfileSimConfig* config, ProfileSimResult* result) {
+  memset(result, 0, sizeof(*result));
+
+  uint8_t nodes = config->nodes <= PROFILE_SIM_MAX_NODES ? config->nodes : PROFILE_SIM_MAX_NODES;
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  TdmaProfile standard = { TDMA_PERIOD_STANDARD, TDMA_SPLIT_BALANCED };
+  TdmaTimeline_init(&master, standard, 0, 0);
+  for (uint8_t n = 0; n < nodes; n++) {
+    TdmaTimeline_init(&nodeTimeline[n], standard, 0, 0);
+  }
+
+  for (uint32_t sf = 0; sf < config->superframes; sf++) {
+    // Sync beacon at the master's superframe start
+    uint32_t startMs = TdmaTimeline_superframeStart(&master, sf);
+    TdmaPosition pos;
+    TdmaTimeline_locate(&master, startMs, &pos);
+    result->expectedMs += master.layout.superframeMs;
+
+    const ProfileSimSwitch* sw = upcomingSwitch(config, sf);
+    if (sw != nullptr && !master.pending) {
+      TdmaTimeline_schedule(&master, sw->profile, sw->superframe, sf);
+    }
+
+    uint8_t beacon[TDMA_ANNOUNCEMENT_LEN];
+    uint8_t beaconLen = TdmaTimeline_encodeAnnouncement(&master, beacon);
+
+    for (uint8_t n = 0; n < nodes; n++) {
+      TdmaTimeline* node = &nodeTimeline[n];
+      TdmaTimeline_locate(node, startMs, &pos);
+      if (switchAt(config, sf) && !(node->profile.period == master.profile.period &&
+                                    node->profile.split == master.profile.split)) {
+        result->nodeSwitchesMissed++;
+      }
+      if (!SimRng_chance(&rng, config->beaconLossPercent)) {
+        if (!sameTimeline(node, &master)) {
+          result->nodeResyncs++;
+        }
+        TdmaTimeline_applyAnnouncement(node, beacon, beaconLen, sf, startMs);
+      }
+    }
+
+    // Data phase under saturated load, timed by each node
+    for (uint8_t slot = 0; slot < TDMA_DATA_SLOTS; slot++) {
+      uint8_t n = slot % nodes;
+      TdmaTimeline* node = &nodeTimeline[n];
+      const TdmaLayout* layout = TdmaTimeline_layoutOf(node, sf);
+      uint32_t txMs = TdmaTimeline_superframeStart(node, sf) + layout->syncMs + layout->controlMs +
+                      slot * layout->dataSlotMs;
+      result->framesOffered++;
+
+      TdmaPosition at;
+      TdmaTimeline_locate(&master, txMs, &at);
+      if (at.superframe != sf || at.dataSlot != slot) {
+        result->framesMisaligned++;
+        result->lastMisalignedSuperframe = sf;
+      } else if (at.offsetMs + config->frameMs > master.layout.syncMs + master.layout.controlMs +
+                                                (uint32_t) (slot + 1) * master.layout.dataSlotMs) {
+        result->framesTooLong++;
+      } else {
+        result->framesDelivered++;
+      }
+    }
+  }
+
+  result->elapsedMs = TdmaTimeline_superframeStart(&master, config->superframes);
+
+  uint32_t lastSwitch = 0;
+  for (uint8_t i = 0; i < config->switchCount; i++) {
+    if (config->switches[i].superframe > lastSwitch) {
+      lastSwitch = config->switches[i].superframe;
+    }
+  }
+  result->converged = result->framesMisaligned == 0 ||
+                      result->lastMisalignedSuperframe < lastSwitch + PROFILE_SIM_SETTLE_SUPERFRAMES;
+}
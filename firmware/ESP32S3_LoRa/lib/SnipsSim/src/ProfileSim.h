@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include "TdmaTimeline.h"
+
+// ============================================================================
+// SUPERFRAME PROFILE SWITCH SIMULATION
+// ============================================================================
+//
+// The master runs a sequence of profile switches. Each is announced in the
+// Sync beacons of the leadSuperframes superframes before it takes effect
+// (at least TDMA_MIN_SWITCH_LEAD, or the master refuses the switch), and
+// every beacon is lost at each node with beaconLossPercent. A node that
+// missed the announcements resyncs from the next beacon it hears. Under
+// saturated load each node sends one frame in every slot it owns
+// (slot % nodes), timed from its own timeline; the master locates each
+// frame on its timeline and counts it as delivered only if it falls in that
+// node's slot, in the same superframe, and ends before the slot does.
+//
+// The run has converged if no frame is misaligned from
+// PROFILE_SIM_SETTLE_SUPERFRAMES after the last switch to the end.
+//
+
+#define PROFILE_SIM_MAX_NODES     60
+#define PROFILE_SIM_MAX_SWITCHES  8
+#define PROFILE_SIM_SETTLE_SUPERFRAMES  10
+
+struct ProfileSimSwitch {
+  uint16_t superframe;
+  TdmaProfile profile;
+};
+
+struct ProfileSimConfig {
+  uint8_t nodes;
+  uint16_t superframes;
+  uint8_t leadSuperframes;
+  uint8_t beaconLossPercent;
+  uint8_t frameMs;           // time on air of a data frame
+  uint8_t switchCount;
+  ProfileSimSwitch switches[PROFILE_SIM_MAX_SWITCHES];
+  uint32_t seed;
+};
+
+struct ProfileSimResult {
+  uint32_t framesOffered;
+  uint32_t framesDelivered;
+  uint32_t framesMisaligned;   // wrong slot/superframe on the master's timeline
+  uint32_t framesTooLong;      // did not fit the (shorter) slot
+  uint16_t nodeSwitchesMissed; // node/boundary pairs where no announcement arrived
+  uint16_t nodeResyncs;        // beacons that re-anchored a node's timeline
+  uint32_t lastMisalignedSuperframe;
+  bool converged;
+  uint32_t elapsedMs;          // master timeline length, to check no time was lost
+  uint32_t expectedMs;         // sum of the profiles' superframe periods
+};
+
+void ProfileSim_run(const ProfileSimConfig* config, ProfileSimResult* result);
@@ -0,0 +1,160 @@
+#include "ReservationSim.h"
+#include "Reservation.h"
+#include "SimQueue.h"
+#include "SnipsFrame.h"
+#include "SimRng.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static SimQueue queues[RESERVATION_SIM_MAX_NODES];
+static bool bursting[RESERVATION_SIM_MAX_NODES];
+static uint8_t owner[TDMA_DATA_SLOTS];
+static uint32_t delayBins[RESERVATION_SIM_BINS];
+static ReservationMap map;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static void buildOwners(const ReservationSimConfig* config, uint8_t nodes) {
+  memset(owner, 0xFF, sizeof(owner));
+  if (!config->reservation) {
+    for (uint8_t s = 0; s < TDMA_DATA_SLOTS; s++) {
+      owner[s] = s % nodes;
+    }
+    return;
+  }
+
+  uint8_t slot = 0;
+  for (uint8_t i = 0; i < map.count; i++) {
+    for (uint8_t k = 0; k < map.runs[i].slots && slot < TDMA_DATA_SLOTS; k++) {
+      owner[slot++] = map.runs[i].node;
+    }
+  }
+}
+
+// What the master hears: a SNIPS header from node, type and flags as sent.
+static void hear(uint8_t node, uint8_t type, uint8_t flags) {
+  SnipsFrameHeader header = {};
+  header.netId = SNIPS_NETWORK_ID;
+  header.type = type;
+  header.flags = flags;
+  header.src = node;
+  header.prevHop = node;
+  uint8_t frame[SNIPS_FRAME_HEADER_LEN];
+  SnipsFrame_encodeHeader(&header, frame);
+  Reservation_onFrame(frame, sizeof(frame));
+}
+
+static void hearQueue(uint8_t node, uint8_t type, const SimQueue* queue, uint32_t nowMs) {
+  hear(node, type, SnipsFrame_flagsWithQueue(0, SimQueue_countBy(queue, nowMs)));
+}
+
+static uint32_t percentile(uint32_t total, uint8_t percent) {
+  uint64_t target = ((uint64_t) total * percent + 99) / 100;
+  uint64_t seen = 0;
+  for (uint16_t bin = 0; bin < RESERVATION_SIM_BINS; bin++) {
+    seen += delayBins[bin];
+    if (seen >= target) {
+      return (bin + 1) * RESERVATION_SIM_BIN_MS;
+    }
+  }
+  return RESERVATION_SIM_BINS * RESERVATION_SIM_BIN_MS;
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void ReservationSim_run(const ReservationSimConfig* config, ReservationSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  memset(queues, 0, sizeof(queues));
+  memset(bursting, 0, sizeof(bursting));
+  memset(delayBins, 0, sizeof(delayBins));
+  memset(&map, 0, sizeof(map));
+
+  uint8_t nodes = config->nodes <= RESERVATION_SIM_MAX_NODES ? config->nodes : RESERVATION_SIM_MAX_NODES;
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+  // ACKs draw from their own stream so the offered load is the same with
+  // and without them
+  SimRng ackRng;
+  SimRng_seed(&ackRng, ~config->seed);
+  Reservation_begin(TDMA_DATA_SLOTS);
+
+  uint64_t delaySum = 0;
+
+  for (uint16_t sf = 0; sf < config->superframes; sf++) {
+    uint32_t sfStart = (uint32_t) sf * TDMA_SUPERFRAME_MS;
+
+    if (config->reservation) {
+      Reservation_compute(sf, &map);
+    }
+    buildOwners(config, nodes);
+
+    for (uint8_t node = 0; node < nodes; node++) {
+      bursting[node] = bursting[node] ? !SimRng_chance(&rng, config->stopPercent)
+                                      : SimRng_chance(&rng, config->startPercent);
+      if (!bursting[node]) {
+        continue;
+      }
+
+      uint8_t firstNew = queues[node].count;
+      for (uint8_t f = 0; f < config->burstFrames; f++) {
+        result->framesOffered++;
+        if (!SimQueue_pushSorted(&queues[node], sfStart + SimRng_uniform(&rng, TDMA_SUPERFRAME_MS), firstNew)) {
+          result->framesDropped++;
+        }
+      }
+    }
+
+    // Control phase report from every node, overwritten by data frames
+    if (config->reservation) {
+      for (uint8_t node = 0; node < nodes; node++) {
+        hearQueue(node, SNIPS_FRAME_CONTROL, &queues[node], sfStart + TDMA_DATA_OFFSET_MS);
+      }
+    }
+
+    for (uint8_t slot = 0; slot < TDMA_DATA_SLOTS; slot++) {
+      uint8_t node = owner[slot];
+      if (node >= nodes) {
+        continue;
+      }
+
+      uint32_t slotStart = sfStart + TDMA_DATA_OFFSET_MS + slot * TDMA_DATA_SLOT_MS;
+      if (config->reservation && nodes > 1 && SimRng_chance(&ackRng, config->ackPercent)) {
+        uint8_t acker = (node + 1 + SimRng_uniform(&ackRng, nodes - 1)) % nodes;
+        hear(acker, SNIPS_FRAME_ACK, 0);
+      }
+      if (!SimQueue_ready(&queues[node], slotStart)) {
+        result->idleSlots++;
+        continue;
+      }
+
+      uint32_t delay = slotStart + TDMA_DATA_SLOT_MS - SimQueue_pop(&queues[node]);
+      delaySum += delay;
+      delayBins[delay / RESERVATION_SIM_BIN_MS < RESERVATION_SIM_BINS ? delay / RESERVATION_SIM_BIN_MS
+                                                                       : RESERVATION_SIM_BINS - 1]++;
+      if (delay > result->maxDelayMs) {
+        result->maxDelayMs = delay;
+      }
+      result->framesDelivered++;
+      if (config->reservation) {
+        hearQueue(node, SNIPS_FRAME_DATA, &queues[node], slotStart);
+      }
+    }
+  }
+
+  for (uint8_t node = 0; node < nodes; node++) {
+    result->backlog += queues[node].count;
+  }
+  result->meanDelayMs = result->framesDelivered ? (uint32_t) (delaySum / result->framesDelivered) : 0;
+  result->p95DelayMs = percentile(result->framesDelivered, 95);
+
+  ReservationStats stats;
+  Reservation_getStats(&stats);
+  result->acksIgnored = stats.noDepth;
+}
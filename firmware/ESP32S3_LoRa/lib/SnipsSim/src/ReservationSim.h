@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// SLOT RESERVATION SIMULATION
+// ============================================================================
+//
+// Bursty sensor traffic: every node flips between idle and a burst of
+// burstFrames frames per superframe (two-state Markov chain, evaluated once
+// per superframe). Static mode gives node i every slot s with
+// s % nodes == i; reservation mode runs Reservation on the queue depths
+// the master heard during the previous superframe, fed to
+// Reservation_onFrame as real frames: a Control report from every node,
+// then the depth stamped on each data frame. With ackPercent, a data slot
+// is followed by an ACK (no stamped depth) from a random other node, as a
+// relay acknowledging traffic would send.
+//
+
+#define RESERVATION_SIM_MAX_NODES  60
+#define RESERVATION_SIM_BIN_MS     50
+#define RESERVATION_SIM_BINS       400
+
+struct ReservationSimConfig {
+  uint8_t nodes;
+  uint8_t burstFrames;
+  uint8_t startPercent;      // idle -> burst, per superframe
+  uint8_t stopPercent;       // burst -> idle, per superframe
+  uint16_t superframes;
+  bool reservation;
+  uint8_t ackPercent;        // chance a data slot is followed by an ACK
+  uint32_t seed;
+};
+
+struct ReservationSimResult {
+  uint32_t framesOffered;
+  uint32_t framesDelivered;
+  uint32_t framesDropped;
+  uint32_t backlog;
+  uint32_t idleSlots;        // owned slots with nothing to send
+  uint32_t acksIgnored;      // ACKs the master heard and kept out of demand
+  uint32_t meanDelayMs;
+  uint32_t p95DelayMs;
+  uint32_t maxDelayMs;
+};
+
+void ReservationSim_run(const ReservationSimConfig* config, ReservationSimResult* result);
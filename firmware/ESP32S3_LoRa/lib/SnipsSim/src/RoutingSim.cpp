@@ -0,0 +1,132 @@
+#include "RoutingSim.h"
+#include "Routing.h"
+#include "SimRng.h"
+#include <math.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define SIM_TX_POWER_DBM     14
+#define SIM_PL_1M_DB         31.5f     // free space at 868 MHz
+#define SIM_PL_EXPONENT      3.0f
+#define SIM_NOISE_DBM        -117      // 125 kHz, 6 dB noise figure
+#define SIM_SNR_FLOOR_DB     -20       // SF12 demodulation floor
+
+struct SimLink {
+  uint8_t a;
+  uint8_t b;
+  int8_t snrDb;              // from path loss
+  uint16_t distanceM;
+  bool down;
+};
+
+static float posX[ROUTING_SIM_MAX_NODES];
+static float posY[ROUTING_SIM_MAX_NODES];
+static SimLink links[ROUTING_SIM_MAX_NODES * ROUTING_MAX_LINKS / 2];
+static uint16_t linkCount = 0;
+static uint8_t placed = 0;
+static SimRng rng;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static float distance(uint8_t a, uint8_t b) {
+  float dx = posX[a] - posX[b];
+  float dy = posY[a] - posY[b];
+  return sqrtf(dx * dx + dy * dy);
+}
+
+static int16_t snrOf(float d) {
+  if (d < 1.0f) {
+    d = 1.0f;
+  }
+  float pathLoss = SIM_PL_1M_DB + 10.0f * SIM_PL_EXPONENT * log10f(d);
+  return (int16_t) lroundf(SIM_TX_POWER_DBM - pathLoss) - SIM_NOISE_DBM;
+}
+
+static uint8_t degreeOf(uint8_t node) {
+  uint8_t degree = 0;
+  for (uint16_t i = 0; i < linkCount; i++) {
+    if (links[i].a == node || links[i].b == node) {
+      degree++;
+    }
+  }
+  return degree;
+}
+
+// ============================================================================
+// TOPOLOGY
+// ============================================================================
+
+uint16_t RoutingSim_build(const RoutingSimConfig* config) {
+  placed = config->nodes <= ROUTING_SIM_MAX_NODES ? config->nodes : ROUTING_SIM_MAX_NODES;
+  linkCount = 0;
+  SimRng_seed(&rng, config->seed);
+
+  float side = sqrtf((float) placed) * config->spacingM;
+  posX[0] = side / 2;
+  posY[0] = side / 2;
+  for (uint8_t i = 1; i < placed; i++) {
+    posX[i] = SimRng_uniform(&rng, 1000) * side / 1000;
+    posY[i] = SimRng_uniform(&rng, 1000) * side / 1000;
+  }
+
+  // Nearest neighbors first, so a full link table keeps the best links
+  for (uint8_t a = 0; a < placed; a++) {
+    while (degreeOf(a) < ROUTING_MAX_LINKS) {
+      uint8_t best = 0xFF;
+      for (uint8_t b = 0; b < placed; b++) {
+        if (b == a || degreeOf(b) >= ROUTING_MAX_LINKS || snrOf(distance(a, b)) < SIM_SNR_FLOOR_DB) {
+          continue;
+        }
+        bool linked = false;
+        for (uint16_t i = 0; i < linkCount && !linked; i++) {
+          linked = (links[i].a == a && links[i].b == b) || (links[i].a == b && links[i].b == a);
+        }
+        if (!linked && (best == 0xFF || distance(a, b) < distance(a, best))) {
+          best = b;
+        }
+      }
+      if (best == 0xFF) {
+        break;
+      }
+
+      int16_t snr = snrOf(distance(a, best));
+      SimLink& link = links[linkCount++];
+      link.a = a;
+      link.b = best;
+      link.snrDb = (int8_t) (snr < 20 ? snr : 20);
+      link.distanceM = (uint16_t) distance(a, best);
+      link.down = false;
+      Routing_updateLink(a, best, link.snrDb, link.distanceM);
+    }
+  }
+  return linkCount;
+}
+
+void RoutingSim_perturb() {
+  if (linkCount == 0) {
+    return;
+  }
+
+  uint32_t kind = SimRng_uniform(&rng, 10);
+  if (kind == 0) {
+    Routing_setEnergy((uint8_t) SimRng_uniform(&rng, placed), (uint8_t) SimRng_uniform(&rng, 101));
+    return;
+  }
+
+  SimLink& link = links[SimRng_uniform(&rng, linkCount)];
+  if (link.down) {
+    link.down = false;
+    Routing_updateLink(link.a, link.b, link.snrDb, link.distanceM);
+  } else if (kind <= 2) {
+    link.down = true;
+    Routing_removeLink(link.a, link.b);
+  } else {
+    // Fading: +/- 8 dB around the path-loss SNR
+    int8_t snr = (int8_t) (link.snrDb + (int8_t) SimRng_uniform(&rng, 17) - 8);
+    Routing_updateLink(link.a, link.b, snr, link.distanceM);
+  }
+}
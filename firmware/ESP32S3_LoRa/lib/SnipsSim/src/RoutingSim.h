@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// ROUTING TOPOLOGY
+// ============================================================================
+//
+// Places nodes uniformly in a square whose side grows with sqrt(nodes) and
+// links every pair whose log-distance SNR clears the SF12 floor (nearest
+// first, up to ROUTING_MAX_LINKS per node). Node 0 is the router under
+// test. Link changes are drawn from the same seed: SNR drifts, battery
+// drain, and links that drop and later return.
+//
+
+#define ROUTING_SIM_MAX_NODES   64
+
+struct RoutingSimConfig {
+  uint8_t nodes;
+  uint16_t spacingM;         // mean distance between neighboring nodes
+  uint32_t seed;
+};
+
+// Builds the topology into Routing (which must already be started with
+// node 0 as self). Returns the number of links added.
+uint16_t RoutingSim_build(const RoutingSimConfig* config);
+
+// Applies one random link change to Routing.
+void RoutingSim_perturb();
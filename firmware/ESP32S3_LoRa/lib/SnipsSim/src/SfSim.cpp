@@ -0,0 +1,112 @@
+#include "SfSim.h"
+#include "SfDivision.h"
+#include "SimRng.h"
+#include "SlotReuse.h"
+#include "SlotReuseSim.h"
+#include "Tsch.h"
+#include <math.h>
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define SF_COUNT  (SX126X_LORA_SF12 - SX126X_LORA_SF5 + 1)
+
+static TschSchedule schedule;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+// Approximately normal, sum of twelve uniforms.
+static float shadowing(SimRng* rng, uint8_t sigmaDb) {
+  float sum = -6.0f;
+  for (uint8_t i = 0; i < 12; i++) {
+    sum += SimRng_uniform(rng, 10000) / 10000.0f;
+  }
+  return sum * sigmaDb;
+}
+
+static bool cellDelivered(const TschCell* cell, SimRng* rng, uint8_t sigmaDb, bool* noiseLoss) {
+  float signal = SlotReuseSim_rssi(cell->tx, cell->rx) + shadowing(rng, sigmaDb);
+  *noiseLoss = (signal - SF_DIVISION_NOISE_FLOOR_DBM) * 10 < SfDivision_snrFloorTenthDb(cell->sf);
+  if (*noiseLoss) {
+    return false;
+  }
+
+  float interferenceMw[SF_COUNT] = { 0 };
+  for (uint16_t i = 0; i < schedule.cellCount; i++) {
+    const TschCell& other = schedule.cells[i];
+    if (&other == cell || other.slot != cell->slot || other.channelOffset != cell->channelOffset) {
+      continue;
+    }
+    float dbm = SlotReuseSim_rssi(other.tx, cell->rx) + shadowing(rng, sigmaDb);
+    interferenceMw[other.sf - SX126X_LORA_SF5] += powf(10.0f, dbm / 10.0f);
+  }
+
+  for (uint8_t sf = 0; sf < SF_COUNT; sf++) {
+    if (interferenceMw[sf] > 0 &&
+        signal - 10.0f * log10f(interferenceMw[sf]) < SfDivision_isolationDb(cell->sf, SX126X_LORA_SF5 + sf)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void SfSim_run(const SfSimConfig* config, SfSimResult* result) {
+  memset(result, 0, sizeof(*result));
+
+  SlotReuse_begin(TDMA_DATA_SLOTS);
+  SlotReuseSimConfig topology = { config->nodes, config->spacingM, config->seed };
+  uint8_t nodes = SlotReuseSim_build(&topology);
+
+  SfDivision_begin(SlotReuseSim_rssi, SX126X_LORA_SF7, SX126X_LORA_SF12);
+  TschSchedule_init(&schedule, TDMA_DATA_SLOTS, config->channels);
+
+  for (uint8_t node = 1; node < nodes; node++) {
+    uint8_t parent = SlotReuseSim_parentOf(node);
+    uint8_t budgetSf = SfDivision_sfForLink(node, parent);
+    result->links++;
+    if (budgetSf == SF_DIVISION_NO_SF) {
+      continue;
+    }
+
+    if (config->sfDivision) {
+      result->linksScheduled += SfDivision_assign(&schedule, node, parent, 1);
+    } else if (TschSchedule_assign(&schedule, node, parent, 1) == 1) {
+      schedule.cells[schedule.cellCount - 1].sf = budgetSf;
+      result->linksScheduled++;
+    }
+  }
+
+  for (uint16_t i = 0; i < schedule.cellCount; i++) {
+    for (uint16_t j = 0; j < schedule.cellCount; j++) {
+      if (j != i && schedule.cells[j].slot == schedule.cells[i].slot &&
+          schedule.cells[j].channelOffset == schedule.cells[i].channelOffset) {
+        result->sharedCells++;
+        break;
+      }
+    }
+  }
+
+  SimRng rng;
+  SimRng_seed(&rng, config->seed ^ 0xA5A5A5A5u);
+  for (uint16_t sf = 0; sf < config->superframes; sf++) {
+    for (uint16_t i = 0; i < schedule.cellCount; i++) {
+      bool noiseLoss;
+      result->framesOffered++;
+      if (cellDelivered(&schedule.cells[i], &rng, config->shadowingDb, &noiseLoss)) {
+        result->framesDelivered++;
+      } else if (noiseLoss) {
+        result->lostNoise++;
+      } else {
+        result->lostInterference++;
+      }
+    }
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// SF DIVISION SIMULATION
+// ============================================================================
+//
+// Uses the SlotReuseSim topology (every node forwards towards the sink) and
+// schedules one cell per link, either one link per cell position with a
+// budget-chosen SF, or with SF division. Every cell then transmits once per
+// superframe under log-normal shadowing; a frame is lost if its SNR misses
+// the SF floor, or if the summed power of concurrent frames at any SF beats
+// the inter-SF isolation threshold at its receiver.
+//
+
+struct SfSimConfig {
+  uint8_t nodes;
+  uint8_t channels;
+  uint16_t spacingM;
+  uint16_t superframes;
+  uint8_t shadowingDb;       // standard deviation per frame
+  bool sfDivision;
+  uint32_t seed;
+};
+
+struct SfSimResult {
+  uint8_t links;
+  uint8_t linksScheduled;
+  uint16_t sharedCells;      // cells on air with another cell on their channel
+  uint32_t framesOffered;
+  uint32_t framesDelivered;
+  uint32_t lostNoise;
+  uint32_t lostInterference;
+};
+
+void SfSim_run(const SfSimConfig* config, SfSimResult* result);
@@ -0,0 +1,822 @@
+#include "SimBench.h"
+#include "TschSim.h"
+#include "SlotReuseSim.h"
+#include "SfSim.h"
+#include "ReservationSim.h"
+#include "ProfileSim.h"
+#include "DutyCycleSim.h"
+#include "Aggregator.h"
+#include "NetCodingSim.h"
+#include "NetCoding.h"
+#include "RoutingSim.h"
+#include "GeoSim.h"
+#include "DedupSim.h"
+#include "Dedup.h"
+#include "TrickleSim.h"
+#include "ArqSim.h"
+#include "Fountain.h"
+#include "BulkSim.h"
+#include "SnipsHc.h"
+#include "PositioningBeacon.h"
+#include "SyncPreamble.h"
+#include "SimRng.h"
+#include "Routing.h"
+#include "Tdma.h"
+#include "sx126x.h"
+#include "SlotReuse.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static void printSection(const char* title) {
+  Serial.println();
+  Serial.println("============================================================================");
+  Serial.printf("  %s\n", title);
+  Serial.println("============================================================================");
+  Serial.flush();
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+void SimBench_tschCapacity() {
+  printSection("TSCH CAPACITY (slot x channel cells)");
+
+  static const uint8_t nodeCounts[] = { 5, 20, 60 };
+  static const uint8_t channelCounts[] = { 1, 2, 4, 8 };
+
+  Serial.println("  nodes  ch  cells granted  delivered/offered  mean delay  dropped    sim us");
+  for (uint8_t n : nodeCounts) {
+    for (uint8_t ch : channelCounts) {
+      TschSimConfig config = { n, ch, 4, 3, 200, 0x5A5A0000u + n };
+      TschSimResult result;
+
+      uint32_t start = micros();
+      TschSim_run(&config, &result);
+      uint32_t elapsed = micros() - start;
+
+      Serial.printf("  %5u  %2u  %5u / %5u  %8lu / %-8lu  %7lu ms  %7lu  %8lu\n",
+                    n, ch, result.cellsGranted, result.cellsRequested,
+                    (unsigned long) result.framesDelivered, (unsigned long) result.framesOffered,
+                    (unsigned long) result.meanDelayMs, (unsigned long) result.framesDropped,
+                    (unsigned long) elapsed);
+    }
+  }
+}
+
+void SimBench_slotReuse() {
+  printSection("SPATIAL SLOT REUSE (interference-graph coloring)");
+
+  static const uint8_t nodeCounts[] = { 10, 25, 50, 100, 150, 200, 250 };
+
+  Serial.println("  nodes  links  slots inc/full  unassigned  add us/link  full us  edge us  recolored");
+  for (uint8_t n : nodeCounts) {
+    SlotReuse_begin(TDMA_DATA_SLOTS);
+    SlotReuseSimConfig config = { n, 400, 0x5A5A0000u + n };
+    uint8_t placed = SlotReuseSim_build(&config);
+
+    uint32_t start = micros();
+    uint8_t links = 0;
+    for (uint8_t node = 1; node < placed; node++) {
+      if (SlotReuse_addLink(node, SlotReuseSim_parentOf(node)) != SLOT_REUSE_NO_LINK) {
+        links++;
+      }
+    }
+    uint32_t addUs = micros() - start;
+    SlotReuseStats incremental;
+    SlotReuse_getStats(&incremental);
+
+    // One new interference edge: the farthest node suddenly heard at the sink
+    uint8_t far = 1;
+    for (uint8_t node = 2; node < placed; node++) {
+      if (SlotReuseSim_rssi(node, 0) < SlotReuseSim_rssi(far, 0)) {
+        far = node;
+      }
+    }
+    start = micros();
+    for (uint8_t i = 0; i < 8; i++) {
+      SlotReuse_reportRssi(far, 0, SLOT_REUSE_INTERFERENCE_DBM + 10);
+    }
+    uint32_t edgeUs = micros() - start;
+    SlotReuseStats afterEdge;
+    SlotReuse_getStats(&afterEdge);
+
+    start = micros();
+    SlotReuse_recolorAll();
+    uint32_t fullUs = micros() - start;
+    SlotReuseStats full;
+    SlotReuse_getStats(&full);
+
+    Serial.printf("  %5u  %5u  %5u / %-5u  %10u  %11lu  %7lu  %7lu  %9lu\n",
+                  placed, links, incremental.slotsUsed, full.slotsUsed, full.unassigned,
+                  (unsigned long) (links ? addUs / links : 0), (unsigned long) fullUs,
+                  (unsigned long) edgeUs, (unsigned long) afterEdge.recolored);
+  }
+}
+
+void SimBench_sfDivision() {
+  printSection("SF DIVISION (concurrent links on distinct SFs)");
+
+  static const uint8_t nodeCounts[] = { 25, 50, 100, 200 };
+
+  Serial.println("  nodes  mode      scheduled/links  shared  delivered/offered  lost snr  lost sir");
+  for (uint8_t n : nodeCounts) {
+    for (uint8_t division = 0; division < 2; division++) {
+      SfSimConfig config = { n, 1, 2000, 100, 4, division != 0, 0x5A5A0000u + n };
+      SfSimResult result;
+      SfSim_run(&config, &result);
+
+      Serial.printf("  %5u  %-8s  %7u / %-7u  %6u  %8lu / %-8lu  %8lu  %8lu\n",
+                    n, division ? "sf-div" : "single", result.linksScheduled, result.links,
+                    result.sharedCells, (unsigned long) result.framesDelivered,
+                    (unsigned long) result.framesOffered, (unsigned long) result.lostNoise,
+                    (unsigned long) result.lostInterference);
+    }
+  }
+}
+
+void SimBench_reservation() {
+  printSection("SLOT RESERVATION vs STATIC ALLOCATION (bursty load)");
+
+  static const uint8_t nodeCounts[] = { 10, 30, 60 };
+
+  // Static, reservation, and reservation with half the data slots followed
+  // by a relay's ACK, which must not reset the relay's reported backlog
+  static const char* const modes[] = { "static", "reserve", "+acks" };
+
+  Serial.println("  nodes  mode     delivered/offered  mean ms  p95 ms  max ms  idle slots  backlog  acks ignored");
+  for (uint8_t n : nodeCounts) {
+    for (uint8_t mode = 0; mode < 3; mode++) {
+      // Bursts of 8 frames lasting ~4 superframes, ~1 in 10 nodes active
+      ReservationSimConfig config = { n, 8, 3, 25, 600, mode != 0, (uint8_t) (mode == 2 ? 50 : 0), 0x5A5A0000u + n };
+      ReservationSimResult result;
+      ReservationSim_run(&config, &result);
+
+      Serial.printf("  %5u  %-7s  %8lu / %-8lu  %7lu  %6lu  %6lu  %10lu  %7lu  %12lu\n",
+                    n, modes[mode], (unsigned long) result.framesDelivered,
+                    (unsigned long) result.framesOffered, (unsigned long) result.meanDelayMs,
+                    (unsigned long) result.p95DelayMs, (unsigned long) result.maxDelayMs,
+                    (unsigned long) result.idleSlots, (unsigned long) result.backlog,
+                    (unsigned long) result.acksIgnored);
+    }
+  }
+}
+
+void SimBench_profileSwitch() {
+  printSection("SUPERFRAME PROFILE SWITCHING (saturated load)");
+
+  // Standard -> Fast -> Slow/mobile-heavy -> Standard/anchor-heavy
+  ProfileSimConfig config = {};
+  config.nodes = 30;
+  config.superframes = 80;
+  config.frameMs = 3;
+  config.switchCount = 3;
+  config.switches[0] = { 20, { TDMA_PERIOD_FAST, TDMA_SPLIT_BALANCED } };
+  config.switches[1] = { 40, { TDMA_PERIOD_SLOW, TDMA_SPLIT_MOBILE_HEAVY } };
+  config.switches[2] = { 60, { TDMA_PERIOD_STANDARD, TDMA_SPLIT_ANCHOR_HEAVY } };
+
+  // Leads start at TDMA_MIN_SWITCH_LEAD; the master refuses shorter ones
+  static const uint8_t leads[] = { TDMA_MIN_SWITCH_LEAD, 3, 5 };
+  static const uint8_t losses[] = { 0, 10, 30, 60 };
+
+  Serial.println("  lead  loss %  delivered/offered  misaligned  too long  missed  resyncs  timeline ms  converged");
+  for (uint8_t lead : leads) {
+    for (uint8_t loss : losses) {
+      config.leadSuperframes = lead;
+      config.beaconLossPercent = loss;
+      config.seed = 0x5A5A0000u + lead * 100 + loss;
+      ProfileSimResult result;
+      ProfileSim_run(&config, &result);
+
+      Serial.printf("  %4u  %6u  %8lu / %-8lu  %10lu  %8lu  %6u  %7u  %5lu/%-5lu  %9s\n",
+                    lead, loss, (unsigned long) result.framesDelivered,
+                    (unsigned long) result.framesOffered, (unsigned long) result.framesMisaligned,
+                    (unsigned long) result.framesTooLong, result.nodeSwitchesMissed, result.nodeResyncs,
+                    (unsigned long) result.elapsedMs, (unsigned long) result.expectedMs,
+                    result.converged ? "yes" : "NO");
+    }
+  }
+}
+
+void SimBench_dutyCycle() {
+  printSection("DUTY-CYCLE WINDOW (greedy sender, 400 ms frames, 3 h)");
+
+  // Bursts starting inside a bucket are the case a window of exactly
+  // DUTY_CYCLE_BUCKETS buckets gets wrong: the bucket ages out while its
+  // later airtime is still less than an hour old
+  static const uint16_t limits[] = { 1, 10, 100 };
+  static const uint32_t offsets[] = { 0, 30000, 59600 };
+
+  Serial.println("  limit %  burst at ms  frames  max hour s  budget s  ok");
+  for (uint16_t limit : limits) {
+    for (uint32_t offset : offsets) {
+      DutyCycleSimConfig config = { limit, 400, 500, offset, 3 * 3600000UL };
+      DutyCycleSimResult result;
+      DutyCycleSim_run(&config, &result);
+
+      Serial.printf("  %7.1f  %11lu  %6lu  %10.1f  %8.1f  %s\n", limit / 10.0, (unsigned long) offset,
+                    (unsigned long) result.framesSent, result.maxWindowMs / 1000.0, result.budgetMs / 1000.0,
+                    result.maxWindowMs <= result.budgetMs ? "yes" : "NO");
+    }
+  }
+}
+
+void SimBench_aggregation() {
+  printSection("RELAY AGGREGATION (20-byte readings, BW125, CR 4/5)");
+
+  static const uint8_t counts[] = { 5, 10 };
+  uint8_t reading[20] = { SNIPS_NETWORK_ID, SNIPS_FRAME_DATA };
+  uint8_t packet[SNIPS_FRAME_MAX_LEN];
+
+  sx126x_mod_params_lora_t mod = { SX126X_LORA_SF7, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5, 0 };
+  sx126x_pkt_params_lora_t pkt = { 8, SX126X_LORA_PKT_EXPLICIT, 0, true, false };
+
+  Serial.println("  sf  frames  separate ms  aggregated ms  bytes  gain");
+  for (uint8_t sf = SX126X_LORA_SF7; sf <= SX126X_LORA_SF12; sf++) {
+    mod.sf = (sx126x_lora_sf_t) sf;
+    mod.ldro = sf >= SX126X_LORA_SF11 ? 1 : 0;
+
+    for (uint8_t n : counts) {
+      Aggregator_begin(1);
+      for (uint8_t i = 0; i < n; i++) {
+        Aggregator_add(2, reading, sizeof(reading), 0);
+      }
+      uint8_t len = Aggregator_flush(0, packet);
+
+      pkt.pld_len_in_bytes = sizeof(reading);
+      uint32_t separateMs = n * sx126x_get_lora_time_on_air_in_ms(&pkt, &mod);
+      pkt.pld_len_in_bytes = len;
+      uint32_t aggregatedMs = sx126x_get_lora_time_on_air_in_ms(&pkt, &mod);
+
+      Serial.printf("  %2u  %6u  %11lu  %13lu  %5u  %3lu.%lux\n", sf, n, (unsigned long) separateMs,
+                    (unsigned long) aggregatedMs, len, (unsigned long) (separateMs / aggregatedMs),
+                    (unsigned long) (separateMs * 10 / aggregatedMs % 10));
+    }
+  }
+}
+
+void SimBench_netCoding() {
+  printSection("XOR NETWORK CODING AT THE RELAY (M1 <-> M2)");
+
+  static const uint16_t ratesB[] = { 60, 30, 10 };
+  static const uint16_t periods[] = { 100, 500, 1000 };
+
+  Serial.printf("  hold %u ms, retain %u frames, M1 -> M2 at 60 frames/min\n", NETCODING_HOLD_MS,
+                NETCODING_RETAIN_FRAMES);
+  Serial.println("  M2 rate/min  relay period  relayed  dropped  relay tx  coded  saved %  mean hold  max hold  decode fail  wrong");
+  for (uint16_t rateB : ratesB) {
+    for (uint16_t period : periods) {
+      NetCodingSimConfig config = { 60, rateB, period, 3600000, 0x5A5A0000u + rateB + period };
+      NetCodingSimResult result;
+      NetCodingSim_run(&config, &result);
+
+      uint32_t saved = result.framesRelayed
+                         ? 100 - (uint32_t) ((uint64_t) result.relayTransmissions * 100 / result.framesRelayed)
+                         : 0;
+      Serial.printf("  %11u  %12u  %7lu  %7lu  %8lu  %5lu  %7lu  %9lu  %8lu  %11lu  %5lu\n", rateB, period,
+                    (unsigned long) result.framesRelayed, (unsigned long) result.framesDropped,
+                    (unsigned long) result.relayTransmissions,
+                    (unsigned long) result.codedTransmissions, (unsigned long) saved,
+                    (unsigned long) result.meanHoldMs, (unsigned long) result.maxHoldMs,
+                    (unsigned long) result.decodeFailures, (unsigned long) result.decodeMismatches);
+    }
+  }
+}
+
+void SimBench_routing() {
+  printSection("MULTI-METRIC ROUTING (incremental vs full shortest path)");
+
+  static const uint8_t nodeCounts[] = { 5, 10, 20, 40, 60 };
+  const uint16_t changes = 200;
+
+  Serial.println("  nodes  links  reach  hops  conv ms  inc us/chg  full us  settled/chg  mismatch");
+  for (uint8_t n : nodeCounts) {
+    Routing_begin(0);
+    RoutingSimConfig config = { n, 600, 0x5A5A0000u + n };
+    uint16_t links = RoutingSim_build(&config);
+
+    uint32_t incUs = 0;
+    uint32_t fullUs = 0;
+    uint32_t settled = 0;
+    uint32_t mismatches = 0;
+    static uint16_t reference[ROUTING_MAX_NODES];
+
+    for (uint16_t c = 0; c < changes; c++) {
+      RoutingStats before;
+      RoutingStats after;
+      Routing_getStats(&before);
+      uint32_t start = micros();
+      RoutingSim_perturb();
+      incUs += micros() - start;
+      Routing_getStats(&after);
+      settled += after.nodesSettled - before.nodesSettled;
+
+      // The incremental tree is never reset, so any drift accumulates
+      start = micros();
+      Routing_referenceCosts(reference);
+      fullUs += micros() - start;
+      for (uint8_t node = 0; node < n; node++) {
+        if (Routing_cost(node) != reference[node]) {
+          mismatches++;
+        }
+      }
+    }
+
+    // Convergence estimate for link state distributed one hop per Control
+    // phase (not part of Routing): a change at the far edge reaches this
+    // router after `hops` superframes.
+    uint8_t reach = 0;
+    uint8_t hops = 0;
+    for (uint8_t node = 0; node < n; node++) {
+      uint8_t h = Routing_hops(node);
+      if (h != ROUTING_NO_ROUTE) {
+        reach++;
+        hops = h > hops ? h : hops;
+      }
+    }
+
+    Serial.printf("  %5u  %5u  %5u  %4u  %7lu  %10lu  %7lu  %9lu.%lu  %8lu\n",
+                  n, links, reach, hops, (unsigned long) hops * TDMA_SUPERFRAME_MS,
+                  (unsigned long) (incUs / changes), (unsigned long) (fullUs / changes),
+                  (unsigned long) (settled / changes), (unsigned long) (settled * 10 / changes % 10),
+                  (unsigned long) mismatches);
+  }
+}
+
+void SimBench_geoRouting() {
+  printSection("GEOGRAPHIC FORWARDING vs ROUTE DISCOVERY");
+
+  static const uint8_t nodeCounts[] = { 25, 50, 100, 150, 200, 250 };
+  const uint16_t routes = 200;
+
+  // One route opens every second somewhere in the network; hellos every
+  // 10 s (a third of GEO_NEIGHBOR_TIMEOUT_MS)
+  Serial.println("  nodes  nbrs  delivered/routes  perim %  stretch  lookups  ctrl tx/route  setup ms");
+  Serial.println("                                                             geo / disc     geo / disc");
+  for (uint8_t n : nodeCounts) {
+    GeoSimConfig config = { n, 400, 800, routes, 1000, 10000, 0x5A5A0000u + n };
+    GeoSimResult result;
+    GeoSim_run(&config, &result);
+
+    uint32_t hops = result.greedyHops + result.perimeterHops;
+    uint32_t stretch = result.shortestHops ? hops * 100 / result.shortestHops : 0;
+    uint32_t perim = hops ? result.perimeterHops * 100 / hops : 0;
+    uint32_t geoTx = result.routes ? (result.helloTx + result.lookupTx) / result.routes : 0;
+    uint32_t geoMs = result.routes ? result.lookupSf * TDMA_SUPERFRAME_MS / result.routes : 0;
+    uint32_t discTx = result.routes ? result.discoveryTx / result.routes : 0;
+    uint32_t discMs = result.routes ? result.discoverySf * TDMA_SUPERFRAME_MS / result.routes : 0;
+
+    Serial.printf("  %5u  %4u  %7u / %-7u  %7lu  %4lu.%02lu  %7lu  %5lu / %-6lu  %4lu / %-6lu\n",
+                  n, result.neighborsMax, result.delivered, result.routes, (unsigned long) perim,
+                  (unsigned long) (stretch / 100), (unsigned long) (stretch % 100),
+                  (unsigned long) result.lookups, (unsigned long) geoTx, (unsigned long) discTx,
+                  (unsigned long) geoMs, (unsigned long) discMs);
+  }
+}
+
+void SimBench_dedup() {
+  printSection("DUPLICATE SUPPRESSION (hash set vs Bloom filter)");
+
+  struct Variant {
+    bool bloom;
+    uint16_t size;
+  };
+  static const Variant variants[] = {
+    { false, 64 }, { false, 128 }, { false, 256 }, { false, 512 },
+    { true, 1024 }, { true, 2048 }, { true, 4096 }, { true, 8192 },
+  };
+  static DedupEntry entries[512];
+  static uint8_t bits[8192 / 4];
+
+  // 40 sources flooding every 2 s, each frame heard 3 times within 1 s:
+  // ~600 keys live within the expiry.
+  Serial.println("  mode   size   bytes  frames  false pos  copies  missed  ns/check");
+  for (const Variant& v : variants) {
+    DedupSimConfig config = { 40, 2000, 3, 1000, 300000, v.bloom, v.size, 0x5A5A0000u + v.size };
+    DedupSimResult result;
+    DedupSim_run(&config, &result);
+
+    // Raw query cost, keys spread over the whole (source, seq) space
+    DedupSet set;
+    DedupBloom bloom;
+    if (v.bloom) {
+      DedupBloom_init(&bloom, bits, v.size, 0);
+    } else {
+      DedupSet_init(&set, entries, v.size);
+    }
+    const uint32_t checks = 10000;
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < checks; i++) {
+      uint8_t src = (uint8_t) (i * 7);
+      uint8_t seq = (uint8_t) (i >> 3);
+      if (v.bloom) {
+        DedupBloom_check(&bloom, src, seq, i);
+      } else {
+        DedupSet_check(&set, src, seq, i);
+      }
+    }
+    uint32_t elapsed = micros() - start;
+
+    Serial.printf("  %-5s  %5u  %6u  %6lu  %9lu  %6lu  %6lu  %8lu\n",
+                  v.bloom ? "bloom" : "set", v.size, result.memoryBytes,
+                  (unsigned long) result.frames, (unsigned long) result.falsePositives,
+                  (unsigned long) result.copies, (unsigned long) result.missed,
+                  (unsigned long) ((uint64_t) elapsed * 1000 / checks));
+  }
+}
+
+void SimBench_trickle() {
+  printSection("TRICKLE vs NAIVE FLOODING (one announcement)");
+
+  static const uint8_t nodeCounts[] = { 25, 50, 100, 150, 200, 250 };
+
+  Serial.println("  nodes  nbrs  mode     covered  tx  tx/node  collisions  coverage ms  upkeep tx/Imax");
+  for (uint8_t n : nodeCounts) {
+    for (uint8_t trickle = 0; trickle < 2; trickle++) {
+      TrickleSimConfig config = { n, 3000, 1000, 150, trickle != 0, 0x5A5A0000u + n };
+      TrickleSimResult result;
+      TrickleSim_run(&config, &result);
+
+      Serial.printf("  %5u  %4u  %-7s  %7u  %4lu  %4lu.%02lu  %10lu  %11lu  %14lu\n",
+                    n, result.meanNeighbors, trickle ? "trickle" : "naive", result.covered,
+                    (unsigned long) result.transmissions,
+                    (unsigned long) (result.transmissions / n),
+                    (unsigned long) (result.transmissions * 100 / n % 100),
+                    (unsigned long) result.collisions, (unsigned long) result.coverageMs,
+                    (unsigned long) result.maintenanceTx);
+    }
+  }
+}
+
+void SimBench_arq() {
+  printSection("SELECTIVE-REPEAT ARQ (block ACK per superframe vs per-frame ACK)");
+
+  static const uint8_t losses[] = { 5, 10, 20, 30 };
+
+  // 3 frames of 20 bytes per superframe, room for 5 transmissions per slot,
+  // reverse traffic to piggyback on in 30 % of superframes (SF7)
+  Serial.println("  loss %  mode       delivered %  dropped  overflow  backlog  latency sf  max  data ms  ack ms  ack ms/frame");
+  for (uint8_t loss : losses) {
+    for (uint8_t block = 0; block < 2; block++) {
+      ArqSimConfig config = { 2000, 3, 5, 20, loss, 30, block != 0, 0x5A5A0000u + loss };
+      ArqSimResult result;
+      ArqSim_run(&config, &result);
+
+      uint32_t deliveredX100 = result.offered ? (uint32_t) ((uint64_t) result.delivered * 10000 / result.offered) : 0;
+      uint32_t ackPerFrameX100 = result.delivered ? result.ackAirMs * 100 / result.delivered : 0;
+      Serial.printf("  %6u  %-9s  %7lu.%02lu  %7lu  %8lu  %7lu  %6lu.%02lu  %3lu  %7lu  %6lu  %9lu.%02lu\n",
+                    loss, block ? "block" : "per-frame",
+                    (unsigned long) (deliveredX100 / 100), (unsigned long) (deliveredX100 % 100),
+                    (unsigned long) result.dropped, (unsigned long) result.overflow,
+                    (unsigned long) result.backlog, (unsigned long) (result.meanLatencySf / 100), (unsigned long) (result.meanLatencySf % 100),
+                    (unsigned long) result.maxLatencySf, (unsigned long) result.dataAirMs,
+                    (unsigned long) result.ackAirMs,
+                    (unsigned long) (ackPerFrameX100 / 100), (unsigned long) (ackPerFrameX100 % 100));
+    }
+  }
+}
+
+void SimBench_fountain() {
+  printSection("FOUNTAIN-CODED BULK BROADCAST (LT code, 200-byte symbols)");
+
+  static const uint16_t ks[] = { 50, 200, 500, 1000 };
+  static const uint8_t losses[] = { 0, 20 };
+  const uint16_t symbolLen = 200;
+  static uint8_t packet[FOUNTAIN_HEADER_LEN + 200];
+
+  Serial.println("  K     blob KB  loss %  sent  received  overhead %  enc KB/s  dec KB/s  broadcast s  ok");
+  for (uint16_t k : ks) {
+    uint32_t size = (uint32_t) k * symbolLen - symbolLen / 2;
+    uint8_t* blob = (uint8_t*) malloc(size);
+    uint8_t* copy = (uint8_t*) malloc(size);
+    if (blob == nullptr || copy == nullptr) {
+      Serial.printf("  %4u  out of memory\n", k);
+      free(blob);
+      free(copy);
+      continue;
+    }
+    SimRng rng;
+    SimRng_seed(&rng, 0x5A5A0000u + k);
+    for (uint32_t i = 0; i < size; i++) {
+      blob[i] = (uint8_t) SimRng_next(&rng);
+    }
+
+    // SF7 / BW125 time on air of one encoded symbol in a SNIPS frame
+    sx126x_mod_params_lora_t mod = { SX126X_LORA_SF7, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5, 0 };
+    sx126x_pkt_params_lora_t pkt = { 8, SX126X_LORA_PKT_EXPLICIT,
+                                     SNIPS_FRAME_HEADER_LEN + FOUNTAIN_HEADER_LEN + symbolLen, true, false };
+    uint32_t symbolAirMs = sx126x_get_lora_time_on_air_in_ms(&pkt, &mod);
+
+    for (uint8_t loss : losses) {
+      FountainEncoder enc;
+      FountainEncoder_init(&enc, 1, blob, size, symbolLen);
+      FountainDecoder dec = {};
+      bool started = false;
+      uint32_t encUs = 0;
+      uint32_t decUs = 0;
+      uint16_t esi = 0;
+
+      while (esi < 0xFFFF && !FountainDecoder_complete(&dec)) {
+        uint32_t start = micros();
+        uint16_t len = FountainEncoder_symbol(&enc, esi++, packet);
+        encUs += micros() - start;
+        if (SimRng_chance(&rng, loss)) {
+          continue;
+        }
+        start = micros();
+        if (!started) {
+          started = FountainDecoder_begin(&dec, packet, len, 120);
+          if (!started) {
+            break;
+          }
+        }
+        FountainDecoder_add(&dec, packet, len);
+        decUs += micros() - start;
+      }
+
+      bool ok = started && FountainDecoder_copy(&dec, copy) && memcmp(blob, copy, size) == 0;
+      uint32_t received = started ? dec.stats.received : 0;
+      // Fewer than K symbols can never decode; no overhead to report then
+      char overhead[12];
+      if (received < k) {
+        snprintf(overhead, sizeof(overhead), "failed");
+      } else {
+        uint32_t overheadX10 = received * 1000 / k - 1000;
+        snprintf(overhead, sizeof(overhead), "%lu.%lu", (unsigned long) (overheadX10 / 10),
+                 (unsigned long) (overheadX10 % 10));
+      }
+      uint64_t kb = (uint64_t) size * 1000;   // KB/s = bytes / us * 1000
+      Serial.printf("  %4u  %7lu  %6u  %4u  %8lu  %10s  %8lu  %8lu  %11lu  %s\n",
+                    k, (unsigned long) (size / 1024), loss, esi, (unsigned long) received, overhead,
+                    (unsigned long) (encUs ? kb * esi / k / encUs : 0), (unsigned long) (decUs ? kb / decUs : 0),
+                    (unsigned long) ((uint32_t) esi * symbolAirMs / 1000), ok ? "yes" : "NO");
+      if (started) {
+        FountainDecoder_end(&dec);
+      }
+    }
+    free(blob);
+    free(copy);
+  }
+}
+
+void SimBench_bulkLink() {
+  printSection("ANCHOR BULK TRANSFER (GFSK 300 kbps vs LoRa SF7/125, 32-packet window)");
+
+  static const uint32_t sizes[] = { 16384, 131072, 1048576 };
+  static const uint8_t losses[] = { 0, 5, 20 };
+
+  Serial.println("  size KB  loss %  modem  packets  retx  polls  timeouts  air ms    time ms   kbps    speedup  ok");
+  for (uint32_t size : sizes) {
+    for (uint8_t loss : losses) {
+      BulkSimResult lora;
+      for (uint8_t gfsk = 0; gfsk < 2; gfsk++) {
+        BulkSimConfig config = { size, loss, 4, gfsk != 0, 0x5A5A0000u + loss };
+        BulkSimResult result;
+        BulkSim_run(&config, &result);
+        if (!gfsk) {
+          lora = result;
+        }
+        uint32_t speedupX10 = gfsk && result.elapsedMs ? (uint32_t) ((uint64_t) lora.elapsedMs * 10 / result.elapsedMs) : 10;
+        Serial.printf("  %7lu  %6u  %-5s  %7lu  %4lu  %5lu  %8lu  %7lu  %9lu  %5lu.%lu  %5lu.%lux  %s\n",
+                      (unsigned long) (size / 1024), loss, gfsk ? "GFSK" : "LoRa",
+                      (unsigned long) result.packets, (unsigned long) result.retransmitted,
+                      (unsigned long) result.polls, (unsigned long) result.ackTimeouts,
+                      (unsigned long) result.airMs, (unsigned long) result.elapsedMs,
+                      (unsigned long) (result.goodputBps / 1000), (unsigned long) (result.goodputBps % 1000 / 100),
+                      (unsigned long) (speedupX10 / 10), (unsigned long) (speedupX10 % 10),
+                      result.complete ? "yes" : "NO");
+      }
+    }
+  }
+}
+
+void SimBench_headerComp() {
+  printSection("SNIPS HEADER COMPRESSION (20-byte frames, BW125, CR 4/5)");
+
+  struct HcCase {
+    const char* name;
+    SnipsFrameHeader header;
+    bool inCell;
+  };
+  // Node 1 owns the cell towards 2
+  static const HcCase cases[] = {
+    { "uplink in own cell", { SNIPS_NETWORK_ID, SNIPS_FRAME_DATA, SNIPS_CLASS_DATA, SNIPS_FLAG_QUEUE_VALID | 0x20, 1, 2, 1, 2, 7, 0 }, true },
+    { "ACK_REQ, no queue", { SNIPS_NETWORK_ID, SNIPS_FRAME_DATA, SNIPS_CLASS_POSITIONING, SNIPS_FLAG_ACK_REQ, 1, 2, 1, 2, 7, 0 }, true },
+    { "relayed, hop 3", { SNIPS_NETWORK_ID, SNIPS_FRAME_DATA, SNIPS_CLASS_DATA, SNIPS_FLAG_QUEUE_VALID | 0x10, 9, 0, 1, 2, 8, 3 }, true },
+    { "broadcast (CAD)", { SNIPS_NETWORK_ID, SNIPS_FRAME_ANNOUNCE, SNIPS_CLASS_MANAGEMENT, 0, 1, 0xFF, 1, 0xFF, 3, 0 }, false },
+  };
+  static const uint8_t sfs[] = { SX126X_LORA_SF7, SX126X_LORA_SF9, SX126X_LORA_SF10, SX126X_LORA_SF12 };
+  static SnipsHcContext tx;
+  static SnipsHcContext rx;
+  uint8_t frame[SNIPS_FRAME_MAX_LEN] = {};
+  uint8_t packet[SNIPS_FRAME_MAX_LEN];
+  const uint8_t frameLen = 20;
+
+  Serial.println("  frame                header B  saved ms SF7  SF9    SF10   SF12");
+  for (const HcCase& hc : cases) {
+    SnipsHc_init(&tx, 1);
+    if (hc.inCell) {
+      SnipsHc_setCell(&tx, 1, 2);
+    }
+    SnipsFrame_encodeHeader(&hc.header, frame);
+    // Steady state on the link: once it has settled the sequence can go as
+    // low bits
+    SnipsFrameHeader next = hc.header;
+    uint8_t len = 0;
+    for (uint8_t i = 0; i <= SNIPS_HC_SEQ_SETTLE; i++) {
+      SnipsFrame_encodeHeader(&next, frame);
+      len = SnipsHc_compress(&tx, frame, frameLen, packet);
+      SnipsHc_txDone(&tx, true);
+      next.seq++;
+    }
+
+    Serial.printf("  %-19s  %2u -> %u ", hc.name, SNIPS_FRAME_HEADER_LEN, len - (frameLen - SNIPS_FRAME_HEADER_LEN));
+    for (uint8_t sf : sfs) {
+      sx126x_mod_params_lora_t mod = { (sx126x_lora_sf_t) sf, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5,
+                                       (uint8_t) (sf >= SX126X_LORA_SF11) };
+      sx126x_pkt_params_lora_t full = { 8, SX126X_LORA_PKT_EXPLICIT, frameLen, true, false };
+      sx126x_pkt_params_lora_t small = full;
+      small.pld_len_in_bytes = len;
+      Serial.printf("  %5lu", (unsigned long) (sx126x_get_lora_time_on_air_in_ms(&full, &mod) -
+                                                sx126x_get_lora_time_on_air_in_ms(&small, &mod)));
+    }
+    Serial.println();
+  }
+
+  // Lossy link with retransmissions and duty-cycle refusals (runs of 20
+  // frames that never go on air): every decoded header must match
+  static const uint8_t losses[] = { 0, 10, 30 };
+  Serial.println();
+  Serial.println("  loss %  frames  refused  decoded  wrong  undecodable  mean header B");
+  for (uint8_t loss : losses) {
+    SimRng rng;
+    SimRng_seed(&rng, 0x5A5A0000u + loss);
+    SnipsHc_init(&tx, 1);
+    SnipsHc_init(&rx, 2);
+    SnipsHc_setCell(&tx, 1, 2);
+    SnipsHc_setCell(&rx, 1, 2);
+
+    uint32_t decoded = 0;
+    uint32_t wrong = 0;
+    uint32_t refused = 0;
+    uint32_t headerBytes = 0;
+    uint8_t refuseRun = 0;
+    uint8_t seq = 0;
+    const uint32_t frames = 20000;
+    for (uint32_t i = 0; i < frames; i++) {
+      SnipsFrameHeader h = { SNIPS_NETWORK_ID, SNIPS_FRAME_DATA, SNIPS_CLASS_DATA, 0, 1, 2, 1, 2, 0, 0 };
+      h.flags = SnipsFrame_flagsWithQueue(0, SimRng_uniform(&rng, 4));
+      h.hops = (uint8_t) SimRng_uniform(&rng, 4);
+      h.src = h.hops ? (uint8_t) (10 + SimRng_uniform(&rng, 20)) : 1;
+      h.seq = SimRng_chance(&rng, 10) ? (uint8_t) (seq - 1 - SimRng_uniform(&rng, 6)) : seq++;
+      SnipsFrame_encodeHeader(&h, frame);
+      for (uint8_t b = SNIPS_FRAME_HEADER_LEN; b < frameLen; b++) {
+        frame[b] = (uint8_t) SimRng_next(&rng);
+      }
+
+      uint8_t len = SnipsHc_compress(&tx, frame, frameLen, packet);
+      if (refuseRun == 0 && SimRng_chance(&rng, 1)) {
+        refuseRun = 20;
+      }
+      if (refuseRun > 0) {
+        refuseRun--;
+        refused++;
+        SnipsHc_txDone(&tx, false);
+        continue;
+      }
+      SnipsHc_txDone(&tx, true);
+      headerBytes += len - (frameLen - SNIPS_FRAME_HEADER_LEN);
+      if (SimRng_chance(&rng, loss) || !SnipsHc_decompress(&rx, packet, &len)) {
+        continue;
+      }
+      decoded++;
+      if (len != frameLen || memcmp(packet, frame, frameLen) != 0) {
+        wrong++;
+      }
+    }
+    uint32_t meanX100 = headerBytes * 100 / (frames - refused);
+    Serial.printf("  %6u  %6lu  %7lu  %7lu  %5lu  %11lu  %10lu.%02lu\n", loss, (unsigned long) frames,
+                  (unsigned long) refused, (unsigned long) decoded, (unsigned long) wrong,
+                  (unsigned long) rx.stats.undecodable,
+                  (unsigned long) (meanX100 / 100), (unsigned long) (meanX100 % 100));
+  }
+}
+
+void SimBench_positioning() {
+  printSection("POSITIONING BEACONS (3 bytes, BW125, CR 4/5, 8-symbol preamble)");
+
+  // Control phase of Standard balanced and Standard anchor-heavy
+  static const uint16_t controlMs[] = { 200, 380 };
+  sx126x_pkt_params_lora_t base = { 8, SX126X_LORA_PKT_EXPLICIT, 0, true, false };
+
+  Serial.println("  SF  explicit ms  implicit ms  saved ms  mobiles/200 ms  mobiles/380 ms");
+  for (uint8_t sf = SX126X_LORA_SF7; sf <= SX126X_LORA_SF12; sf++) {
+    sx126x_mod_params_lora_t mod = { (sx126x_lora_sf_t) sf, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5,
+                                     (uint8_t) (sf >= SX126X_LORA_SF11) };
+    Serial.printf("  %2u  %11.1f  %11.1f  %8.1f", sf, Positioning_beaconAirUs(&base, &mod, false) / 1000.0,
+                  Positioning_beaconAirUs(&base, &mod, true) / 1000.0,
+                  Positioning_headerSavingUs(&base, &mod) / 1000.0);
+    for (uint16_t ms : controlMs) {
+      Serial.printf("  %6u -> %-5u", Positioning_slotCount(ms, &base, &mod, false),
+                    Positioning_slotCount(ms, &base, &mod, true));
+    }
+    Serial.println();
+  }
+  Serial.printf("  (%u ms of each Control phase kept for management, %u us guard per slot)\n",
+                POSITIONING_MGMT_MS, POSITIONING_GUARD_US);
+}
+
+void SimBench_syncPreamble() {
+  printSection("SYNCHRONIZED-WAKE PREAMBLES (BW125, CR 4/5, long preamble 16 symbols)");
+
+  const uint16_t longSymb = 16;
+  sx126x_pkt_params_lora_t pkt = { longSymb, SX126X_LORA_PKT_EXPLICIT, 20, true, false };
+
+  // Beacon every 1 s, slot 900 ms after it
+  SyncPreamble sync;
+  SyncPreamble_init(&sync);
+  SyncPreamble_onSync(&sync, 0, 0);
+  SyncPreamble_onSync(&sync, 1000, 0);
+  Serial.println("  SF  symbol ms  preamble  saved ms/frame  listen ms");
+  for (uint8_t sf = SX126X_LORA_SF7; sf <= SX126X_LORA_SF12; sf++) {
+    sx126x_mod_params_lora_t mod = { (sx126x_lora_sf_t) sf, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5,
+                                     (uint8_t) (sf >= SX126X_LORA_SF11) };
+    sx126x_pkt_params_lora_t shortPkt = pkt;
+    shortPkt.preamble_len_in_symb = SyncPreamble_symbols(&sync, 1900, &mod, longSymb);
+    double savedMs = (sx126x_get_lora_time_on_air_numerator(&pkt, &mod) -
+                      sx126x_get_lora_time_on_air_numerator(&shortPkt, &mod)) *
+                     1000.0 / sx126x_get_lora_bw_in_hz(mod.bw);
+    Serial.printf("  %2u  %9.2f  %2u -> %-2u  %14.1f  %9.1f\n", sf, SyncPreamble_symbolUs(&mod) / 1000.0, longSymb,
+                  shortPkt.preamble_len_in_symb, savedMs, SyncPreamble_listenUs(&sync, 1900, &mod) / 1000.0);
+  }
+
+  // Two nodes with true drift up to 30 ppm (above the 20 ppm floor) and
+  // independent beacon losses exchange one SF10 frame per 1 s superframe.
+  // Each end sizes its side from its own state. A miss is a frame that
+  // starts too early for the receiver to still see SYNC_PREAMBLE_MIN_SYMB
+  // preamble symbols, or too late for its listen window.
+  static const uint8_t losses[] = { 0, 10, 30 };
+  sx126x_mod_params_lora_t mod = { SX126X_LORA_SF10, SX126X_LORA_BW_125, SX126X_LORA_CR_4_5, 0 };
+  double symbolUs = SyncPreamble_symbolUs(&mod);
+  const uint32_t frames = 5000;
+
+  Serial.println();
+  Serial.println("  beacon loss %  short frames  mean preamble  air saved ms  mean listen ms  misses  fallbacks");
+  for (uint8_t loss : losses) {
+    SimRng rng;
+    SimRng_seed(&rng, 0x5C0000u + loss);
+    SyncPreamble node[2];
+    double driftPpm[2];
+    double errorUs[2];
+    for (uint8_t i = 0; i < 2; i++) {
+      SyncPreamble_init(&node[i]);
+      driftPpm[i] = (double) SimRng_uniform(&rng, 61) - 30;
+      errorUs[i] = 0;
+    }
+
+    uint32_t shortFrames = 0;
+    uint32_t misses = 0;
+    uint64_t preambleSum = 0;
+    double listenSum = 0;
+    uint32_t listenCount = 0;
+    for (uint32_t n = 0; n < frames; n++) {
+      uint32_t beaconMs = n * 1000;
+      for (uint8_t i = 0; i < 2; i++) {
+        double drifted = errorUs[i] + driftPpm[i];
+        if (SimRng_chance(&rng, loss)) {
+          errorUs[i] = drifted;
+          SyncPreamble_onSyncMissed(&node[i]);
+          continue;
+        }
+        errorUs[i] = (double) SimRng_uniform(&rng, 2 * SYNC_PREAMBLE_JITTER_US + 1) - SYNC_PREAMBLE_JITTER_US;
+        SyncPreamble_onSync(&node[i], beaconMs, (int32_t) (drifted - errorUs[i]));
+      }
+
+      // Data slot 300-900 ms into the superframe, node 0 to node 1
+      uint32_t atMs = 300 + SimRng_uniform(&rng, 600);
+      double early = (errorUs[1] + driftPpm[1] * atMs / 1000) - (errorUs[0] + driftPpm[0] * atMs / 1000);
+      uint16_t preamble = SyncPreamble_symbols(&node[0], beaconMs + atMs, &mod, longSymb);
+      uint32_t listenUs = SyncPreamble_listenUs(&node[1], beaconMs + atMs, &mod);
+
+      preambleSum += preamble;
+      shortFrames += preamble < longSymb;
+      bool caught = early <= (preamble - SYNC_PREAMBLE_MIN_SYMB) * symbolUs;
+      if (listenUs != 0) {
+        listenSum += listenUs;
+        listenCount++;
+        caught &= -early + SYNC_PREAMBLE_MIN_SYMB * symbolUs <= listenUs;
+      }
+      misses += !caught;
+    }
+
+    double meanPreamble = (double) preambleSum / frames;
+    Serial.printf("  %13u  %11.1f%%  %13.1f  %12.1f  %14.1f  %6lu  %9lu\n", loss, 100.0 * shortFrames / frames,
+                  meanPreamble, (longSymb - meanPreamble) * symbolUs / 1000.0,
+                  listenCount ? listenSum / 1000.0 / listenCount : 0.0, (unsigned long) misses,
+                  (unsigned long) (node[0].stats.fallbacks + node[1].stats.fallbacks));
+  }
+}
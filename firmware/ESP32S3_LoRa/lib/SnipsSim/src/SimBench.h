@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// ============================================================================
+// ON-DEVICE SIMULATOR BENCHMARKS
+// ============================================================================
+//
+// Runs the SnipsSim scenarios and prints result tables on Serial, in the
+// same format as the LoRaTest output. Call from setup() on a bench board.
+//
+
+void SimBench_tschCapacity();
+void SimBench_slotReuse();
+void SimBench_sfDivision();
+void SimBench_reservation();
+void SimBench_profileSwitch();
+void SimBench_dutyCycle();
+void SimBench_aggregation();
+void SimBench_netCoding();
+void SimBench_routing();
+void SimBench_geoRouting();
+void SimBench_dedup();
+void SimBench_trickle();
+void SimBench_arq();
+void SimBench_fountain();
+void SimBench_bulkLink();
+void SimBench_headerComp();
+void SimBench_positioning();
+void SimBench_syncPreamble();
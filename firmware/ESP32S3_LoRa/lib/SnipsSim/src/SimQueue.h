@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// SIMULATOR FRAME QUEUE
+// ============================================================================
+//
+// FIFO of frame arrival times, kept sorted by arrival so a frame is only
+// served once it exists.
+//
+
+#ifndef SIM_QUEUE_DEPTH
+#define SIM_QUEUE_DEPTH  32
+#endif
+
+struct SimQueue {
+  uint32_t arrivalMs[SIM_QUEUE_DEPTH];
+  uint8_t head;
+  uint8_t count;
+};
+
+// Only the arrivals added since the queue held firstNew frames can be out
+// of order. Returns false (frame dropped) when the queue is full.
+static inline bool SimQueue_pushSorted(SimQueue* q, uint32_t arrivalMs, uint8_t firstNew) {
+  if (q->count >= SIM_QUEUE_DEPTH) {
+    return false;
+  }
+
+  uint8_t pos = q->count++;
+  while (pos > firstNew) {
+    uint8_t prev = (q->head + pos - 1) % SIM_QUEUE_DEPTH;
+    if (q->arrivalMs[prev] <= arrivalMs) {
+      break;
+    }
+    q->arrivalMs[(q->head + pos) % SIM_QUEUE_DEPTH] = q->arrivalMs[prev];
+    pos--;
+  }
+  q->arrivalMs[(q->head + pos) % SIM_QUEUE_DEPTH] = arrivalMs;
+  return true;
+}
+
+// True if the head frame has arrived by nowMs.
+static inline bool SimQueue_ready(const SimQueue* q, uint32_t nowMs) {
+  return q->count > 0 && q->arrivalMs[q->head] <= nowMs;
+}
+
+// Removes the head frame and returns its arrival time.
+static inline uint32_t SimQueue_pop(SimQueue* q) {
+  uint32_t arrivalMs = q->arrivalMs[q->head];
+  q->head = (q->head + 1) % SIM_QUEUE_DEPTH;
+  q->count--;
+  return arrivalMs;
+}
+
+// Number of queued frames that have arrived by nowMs.
+static inline uint8_t SimQueue_countBy(const SimQueue* q, uint32_t nowMs) {
+  uint8_t n = 0;
+  while (n < q->count && q->arrivalMs[(q->head + n) % SIM_QUEUE_DEPTH] <= nowMs) {
+    n++;
+  }
+  return n;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// DETERMINISTIC SIMULATOR PRNG
+// ============================================================================
+//
+// Simulations must be reproducible from their seed, so they never draw from
+// the EntropyPool.
+//
+
+struct SimRng {
+  uint32_t state;
+};
+
+static inline void SimRng_seed(SimRng* rng, uint32_t seed) {
+  rng->state = seed != 0 ? seed : 0x9E3779B9;
+}
+
+static inline uint32_t SimRng_next(SimRng* rng) {
+  rng->state ^= rng->state << 13;
+  rng->state ^= rng->state >> 17;
+  rng->state ^= rng->state << 5;
+  return rng->state;
+}
+
+// Uniform value in [0, bound).
+static inline uint32_t SimRng_uniform(SimRng* rng, uint32_t bound) {
+  return (uint32_t) (((uint64_t) SimRng_next(rng) * bound) >> 32);
+}
+
+// True with probability percent / 100.
+static inline bool SimRng_chance(SimRng* rng, uint8_t percent) {
+  return SimRng_uniform(rng, 100) < percent;
+}
@@ -0,0 +1,79 @@
+#include "SlotReuseSim.h"
+#include "SimRng.h"
+#include "SlotReuse.h"
+#include <math.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define SIM_TX_POWER_DBM     14
+#define SIM_PL_1M_DB         31.5f     // free space at 868 MHz
+#define SIM_PL_EXPONENT      3.0f
+
+static float posX[SLOT_REUSE_SIM_MAX_NODES];
+static float posY[SLOT_REUSE_SIM_MAX_NODES];
+static uint8_t parent[SLOT_REUSE_SIM_MAX_NODES];
+static uint8_t placed = 0;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static float distanceSq(uint8_t a, uint8_t b) {
+  float dx = posX[a] - posX[b];
+  float dy = posY[a] - posY[b];
+  return dx * dx + dy * dy;
+}
+
+int16_t SlotReuseSim_rssi(uint8_t a, uint8_t b) {
+  float d = sqrtf(distanceSq(a, b));
+  if (d < 1.0f) {
+    d = 1.0f;
+  }
+  float pathLoss = SIM_PL_1M_DB + 10.0f * SIM_PL_EXPONENT * log10f(d);
+  return (int16_t) lroundf(SIM_TX_POWER_DBM - pathLoss);
+}
+
+// ============================================================================
+// TOPOLOGY
+// ============================================================================
+
+uint8_t SlotReuseSim_build(const SlotReuseSimConfig* config) {
+  placed = config->nodes <= SLOT_REUSE_SIM_MAX_NODES ? config->nodes : SLOT_REUSE_SIM_MAX_NODES;
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  float side = sqrtf((float) placed) * config->spacingM;
+  posX[0] = side / 2;
+  posY[0] = side / 2;
+  for (uint8_t i = 1; i < placed; i++) {
+    posX[i] = SimRng_uniform(&rng, 1000) * side / 1000;
+    posY[i] = SimRng_uniform(&rng, 1000) * side / 1000;
+  }
+
+  for (uint8_t i = 0; i < placed; i++) {
+    float toSink = distanceSq(i, 0);
+    float best = -1;
+    parent[i] = 0;
+    for (uint8_t j = 0; j < placed; j++) {
+      if (j == i) {
+        continue;
+      }
+      int16_t rssi = SlotReuseSim_rssi(i, j);
+      if (rssi >= -128) {
+        SlotReuse_reportRssi(j, i, (int8_t) rssi);
+      }
+      float d = distanceSq(i, j);
+      if (i != 0 && distanceSq(j, 0) < toSink && (best < 0 || d < best)) {
+        best = d;
+        parent[i] = j;
+      }
+    }
+  }
+  return placed;
+}
+
+uint8_t SlotReuseSim_parentOf(uint8_t node) {
+  return node < placed ? parent[node] : 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// SLOT REUSE TOPOLOGY
+// ============================================================================
+//
+// Places nodes uniformly in a square whose side grows with sqrt(nodes), so
+// density stays constant, and reports the log-distance path-loss RSSI of
+// every audible pair to SlotReuse. Node 0 is the sink; every other node
+// forwards to its nearest neighbor that is closer to the sink.
+//
+
+#define SLOT_REUSE_SIM_MAX_NODES   250
+
+struct SlotReuseSimConfig {
+  uint8_t nodes;
+  uint16_t spacingM;         // mean distance between neighboring nodes
+  uint32_t seed;
+};
+
+// Builds the topology and feeds RSSI into SlotReuse (which must already be
+// started). Returns the number of nodes placed.
+uint8_t SlotReuseSim_build(const SlotReuseSimConfig* config);
+
+// Next hop of node towards the sink (node 0 returns 0).
+uint8_t SlotReuseSim_parentOf(uint8_t node);
+
+// Path-loss RSSI between two placed nodes.
+int16_t SlotReuseSim_rssi(uint8_t a, uint8_t b);
@@ -0,0 +1,208 @@
+#include "TrickleSim.h"
+#include "SimRng.h"
+#include "Trickle.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+#define SIM_TICK_MS          10
+#define SIM_TIMEOUT_MS       120000
+#define SIM_NAIVE_JITTER_MS  500
+#define SIM_CAD_ATTEMPTS     6
+#define SIM_BACKOFF_SLOT_MS  20
+#define SIM_IMAX_MS          ((uint32_t) TRICKLE_IMIN_MS << TRICKLE_DOUBLINGS)
+#define SIM_NONE             0xFF
+
+struct SimNode {
+  int16_t x;
+  int16_t y;
+  uint8_t version;
+  bool has;                  // naive: heard the announcement
+  TrickleTimer timer;
+
+  bool ready;                // wants the channel
+  uint8_t attempts;
+  uint32_t tryAtMs;
+
+  uint32_t txEndMs;          // 0 when not transmitting
+  uint8_t txVersion;
+
+  uint8_t rxFrom;
+  uint8_t rxVersion;
+  uint32_t rxEndMs;
+  bool rxCollided;
+};
+
+static SimNode nodes[TRICKLE_SIM_MAX_NODES];
+static uint8_t count = 0;
+static int32_t rangeSq = 0;
+static SimRng rng;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool inRange(uint8_t a, uint8_t b) {
+  int32_t dx = nodes[a].x - nodes[b].x;
+  int32_t dy = nodes[a].y - nodes[b].y;
+  return a != b && dx * dx + dy * dy <= rangeSq;
+}
+
+static bool channelBusy(uint8_t node) {
+  for (uint8_t j = 0; j < count; j++) {
+    if (nodes[j].txEndMs != 0 && inRange(node, j)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void startTx(uint8_t node, uint32_t nowMs, uint16_t airMs, TrickleSimResult* result) {
+  SimNode& n = nodes[node];
+  n.txEndMs = nowMs + airMs;
+  n.txVersion = n.version;
+  n.rxFrom = SIM_NONE;       // half duplex: drops a reception in progress
+  result->transmissions++;
+
+  for (uint8_t r = 0; r < count; r++) {
+    if (!inRange(node, r) || nodes[r].txEndMs != 0) {
+      continue;
+    }
+    SimNode& rx = nodes[r];
+    if (rx.rxFrom != SIM_NONE) {
+      rx.rxCollided = true;
+      rx.rxEndMs = n.txEndMs > rx.rxEndMs ? n.txEndMs : rx.rxEndMs;
+    } else {
+      rx.rxFrom = node;
+      rx.rxVersion = n.txVersion;
+      rx.rxEndMs = n.txEndMs;
+      rx.rxCollided = false;
+    }
+  }
+}
+
+static void receive(uint8_t node, uint32_t nowMs, bool trickle) {
+  SimNode& n = nodes[node];
+  if (trickle) {
+    if (n.rxVersion == n.version) {
+      TrickleTimer_consistent(&n.timer);
+      return;
+    }
+    if ((int8_t) (n.rxVersion - n.version) > 0) {
+      n.version = n.rxVersion;
+    }
+    TrickleTimer_reset(&n.timer, nowMs);
+  } else if (!n.has) {
+    n.has = true;
+    n.ready = true;
+    n.attempts = 0;
+    n.tryAtMs = nowMs + SimRng_uniform(&rng, SIM_NAIVE_JITTER_MS);
+  }
+}
+
+// One tick of radio and timers. Returns the number of nodes holding
+// version 1 (trickle) or the announcement (naive).
+static uint16_t step(uint32_t now, const TrickleSimConfig* config, TrickleSimResult* result) {
+  for (uint8_t i = 0; i < count; i++) {
+    SimNode& n = nodes[i];
+    if (n.txEndMs != 0 && n.txEndMs <= now) {
+      n.txEndMs = 0;
+    }
+    if (n.rxFrom != SIM_NONE && n.rxEndMs <= now) {
+      if (n.rxCollided) {
+        result->collisions++;
+      } else {
+        receive(i, now, config->trickle);
+      }
+      n.rxFrom = SIM_NONE;
+    }
+  }
+
+  uint16_t holding = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    SimNode& n = nodes[i];
+    if (config->trickle && TrickleTimer_poll(&n.timer, now)) {
+      n.ready = true;
+      n.attempts = 0;
+      n.tryAtMs = now;
+    }
+    if (n.ready && n.txEndMs == 0 && now >= n.tryAtMs) {
+      if (!channelBusy(i)) {
+        n.ready = false;
+        startTx(i, now, config->airMs, result);
+      } else if (++n.attempts >= SIM_CAD_ATTEMPTS) {
+        n.ready = false;
+      } else {
+        n.tryAtMs = now + (1 + SimRng_uniform(&rng, 1u << n.attempts)) * SIM_BACKOFF_SLOT_MS;
+      }
+    }
+    holding += config->trickle ? n.version == 1 : n.has;
+  }
+  return holding;
+}
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void TrickleSim_run(const TrickleSimConfig* config, TrickleSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  memset(nodes, 0, sizeof(nodes));
+  count = config->nodes <= TRICKLE_SIM_MAX_NODES ? config->nodes : TRICKLE_SIM_MAX_NODES;
+  rangeSq = (int32_t) config->rangeM * config->rangeM;
+  SimRng_seed(&rng, config->seed);
+
+  for (uint8_t i = 0; i < count; i++) {
+    nodes[i].x = (int16_t) SimRng_uniform(&rng, config->sideM);
+    nodes[i].y = (int16_t) SimRng_uniform(&rng, config->sideM);
+    nodes[i].rxFrom = SIM_NONE;
+  }
+  uint32_t links = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    for (uint8_t j = 0; j < count; j++) {
+      links += inRange(i, j);
+    }
+  }
+  result->meanNeighbors = count ? links / count : 0;
+
+  uint32_t now = 0;
+  if (config->trickle) {
+    for (uint8_t i = 0; i < count; i++) {
+      TrickleTimer_init(&nodes[i].timer, SimRng_next(&rng), SimRng_uniform(&rng, TRICKLE_IMIN_MS));
+    }
+    // Settle on version 0 until every timer has reached Imax, and count the
+    // last Imax worth of chatter
+    uint32_t settleMs = 2 * SIM_IMAX_MS + TRICKLE_IMIN_MS;
+    for (; now < settleMs; now += SIM_TICK_MS) {
+      if (now == settleMs - SIM_IMAX_MS) {
+        result->maintenanceTx = result->transmissions;
+      }
+      step(now, config, result);
+    }
+    result->maintenanceTx = result->transmissions - result->maintenanceTx;
+    result->transmissions = 0;
+    result->collisions = 0;
+
+    nodes[0].version = 1;
+    TrickleTimer_reset(&nodes[0].timer, now);
+  } else {
+    nodes[0].has = true;
+    nodes[0].ready = true;
+    nodes[0].tryAtMs = now;
+  }
+
+  uint32_t start = now;
+  for (; now < start + SIM_TIMEOUT_MS; now += SIM_TICK_MS) {
+    result->covered = step(now, config, result);
+    bool quiet = true;
+    for (uint8_t i = 0; i < count && quiet; i++) {
+      quiet = nodes[i].txEndMs == 0 && (config->trickle || !nodes[i].ready);
+    }
+    if (result->covered == count && quiet) {
+      break;
+    }
+  }
+  result->coverageMs = now - start;
+}
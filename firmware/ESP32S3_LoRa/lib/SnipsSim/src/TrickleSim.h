@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// TRICKLE FLOODING SIMULATION
+// ============================================================================
+//
+// Nodes placed uniformly in a fixed square, so adding nodes raises the
+// density. A link exists within rangeM; a packet is lost at a receiver when
+// two of its neighbors overlap on air or when it is transmitting itself.
+// Transmissions go through CAD: a node whose neighbor is on air backs off
+// and retries, like ChannelAccess.
+//
+// Naive flooding: every node rebroadcasts the announcement once, after a
+// random jitter, the first time it hears it. Trickle: all nodes first
+// settle on version 0 (timers grow to Imax, which also measures the
+// maintenance cost), then node 0 publishes version 1.
+//
+
+#define TRICKLE_SIM_MAX_NODES   250
+
+struct TrickleSimConfig {
+  uint8_t nodes;
+  uint16_t sideM;
+  uint16_t rangeM;
+  uint16_t airMs;            // time on air of an announcement
+  bool trickle;
+  uint32_t seed;
+};
+
+struct TrickleSimResult {
+  uint16_t meanNeighbors;
+  uint16_t covered;          // nodes holding the announcement at the end
+  uint32_t transmissions;    // from publication to full coverage
+  uint32_t coverageMs;       // time to full coverage (or the timeout)
+  uint32_t collisions;       // receptions lost to overlap
+  uint32_t maintenanceTx;    // trickle: transmissions in the last settled Imax
+};
+
+void TrickleSim_run(const TrickleSimConfig* config, TrickleSimResult* result);
@@ -0,0 +1,68 @@
+#include "TschSim.h"
+#include "SimQueue.h"
+#include "SimRng.h"
+#include "Tsch.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static TschSchedule schedule;
+static SimQueue queues[TSCH_SIM_MAX_NODES];
+
+// ============================================================================
+// SIMULATION
+// ============================================================================
+
+void TschSim_run(const TschSimConfig* config, TschSimResult* result) {
+  memset(result, 0, sizeof(*result));
+  memset(queues, 0, sizeof(queues));
+
+  uint8_t nodes = config->nodes <= TSCH_SIM_MAX_NODES ? config->nodes : TSCH_SIM_MAX_NODES;
+  SimRng rng;
+  SimRng_seed(&rng, config->seed);
+
+  // One outgoing link per node, so the link index is the transmitter
+  TschSchedule_init(&schedule, TDMA_DATA_SLOTS, config->channels);
+  for (uint8_t tx = 0; tx < nodes; tx++) {
+    uint8_t rx = (tx + 1 + SimRng_uniform(&rng, nodes - 1)) % nodes;
+    result->cellsRequested += config->cellsPerLink;
+    result->cellsGranted += TschSchedule_assign(&schedule, tx, rx, config->cellsPerLink);
+  }
+
+  uint64_t delaySum = 0;
+
+  for (uint16_t sf = 0; sf < config->superframes; sf++) {
+    uint32_t sfStart = (uint32_t) sf * TDMA_SUPERFRAME_MS;
+
+    for (uint8_t link = 0; link < nodes; link++) {
+      uint8_t firstNew = queues[link].count;
+      for (uint8_t f = 0; f < config->framesPerLinkPerSuperframe; f++) {
+        result->framesOffered++;
+        if (!SimQueue_pushSorted(&queues[link], sfStart + SimRng_uniform(&rng, TDMA_SUPERFRAME_MS), firstNew)) {
+          result->framesDropped++;
+        }
+      }
+    }
+
+    for (uint8_t slot = 0; slot < schedule.slots; slot++) {
+      uint32_t slotStart = sfStart + TDMA_DATA_OFFSET_MS + slot * TDMA_DATA_SLOT_MS;
+
+      for (uint16_t i = 0; i < schedule.cellCount; i++) {
+        const TschCell& cell = schedule.cells[i];
+        if (cell.slot != slot || !SimQueue_ready(&queues[cell.tx], slotStart)) {
+          continue;
+        }
+
+        delaySum += slotStart + TDMA_DATA_SLOT_MS - SimQueue_pop(&queues[cell.tx]);
+        result->framesDelivered++;
+      }
+    }
+  }
+
+  for (uint8_t link = 0; link < nodes; link++) {
+    result->backlog += queues[link].count;
+  }
+  result->meanDelayMs = result->framesDelivered ? (uint32_t) (delaySum / result->framesDelivered) : 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// TSCH CAPACITY SIMULATION
+// ============================================================================
+//
+// Every node sends to one random peer. The cell scheduler builds the
+// schedule for the requested channel count, then frames arrive uniformly in
+// time and are served FIFO in the link's cells, superframe after superframe.
+//
+
+#define TSCH_SIM_MAX_NODES   64
+
+struct TschSimConfig {
+  uint8_t nodes;
+  uint8_t channels;
+  uint8_t cellsPerLink;
+  uint8_t framesPerLinkPerSuperframe;
+  uint16_t superframes;
+  uint32_t seed;
+};
+
+struct TschSimResult {
+  uint16_t cellsRequested;
+  uint16_t cellsGranted;
+  uint32_t framesOffered;
+  uint32_t framesDelivered;
+  uint32_t meanDelayMs;      // arrival to end of serving slot
+  uint32_t framesDropped;    // queue overflow
+  uint32_t backlog;          // frames still queued at the end
+};
+
+void TschSim_run(const TschSimConfig* config, TschSimResult* result);
@@ -0,0 +1,95 @@
+#include "SyncPreamble.h"
+#include <string.h>
+
+// ============================================================================
+// SYNC TRACKING
+// ============================================================================
+
+void SyncPreamble_init(SyncPreamble* sync) {
+  memset(sync, 0, sizeof(*sync));
+  sync->driftPpm = SYNC_PREAMBLE_DRIFT_PPM;
+}
+
+void SyncPreamble_onSync(SyncPreamble* sync, uint32_t nowMs, int32_t correctionUs) {
+  uint32_t magnitude = correctionUs < 0 ? (uint32_t) -correctionUs : (uint32_t) correctionUs;
+  uint32_t elapsedMs = nowMs - sync->lastSyncMs;
+
+  if (sync->synced && elapsedMs > 0) {
+    sync->intervalMs = elapsedMs / (sync->missed + 1);
+    // Both the old and the new beacon timestamp add their jitter
+    if (magnitude > SyncPreamble_uncertaintyUs(sync, nowMs) + SYNC_PREAMBLE_JITTER_US) {
+      sync->stats.surprises++;
+    }
+    // Drift seen over this interval: take a rise at once, let a fall decay
+    uint32_t excess = magnitude > 2 * SYNC_PREAMBLE_JITTER_US ? magnitude - 2 * SYNC_PREAMBLE_JITTER_US : 0;
+    uint32_t observedPpm = (uint32_t) ((uint64_t) excess * 1000 / elapsedMs);
+    if (observedPpm >= sync->driftPpm) {
+      sync->driftPpm = observedPpm > 0xFFFF ? 0xFFFF : (uint16_t) observedPpm;
+    } else {
+      sync->driftPpm -= (sync->driftPpm - observedPpm) / 8;
+    }
+    if (sync->driftPpm < SYNC_PREAMBLE_DRIFT_PPM) {
+      sync->driftPpm = SYNC_PREAMBLE_DRIFT_PPM;
+    }
+  }
+
+  sync->lastSyncMs = nowMs;
+  sync->missed = 0;
+  sync->synced = true;
+  sync->stats.syncs++;
+}
+
+void SyncPreamble_onSyncMissed(SyncPreamble* sync) {
+  sync->stats.missed++;
+  if (sync->missed < 0xFF) {
+    sync->missed++;
+  }
+  if (sync->synced && sync->missed == SYNC_PREAMBLE_MAX_MISSED) {
+    sync->stats.fallbacks++;
+  }
+}
+
+bool SyncPreamble_confident(const SyncPreamble* sync) {
+  return sync->synced && sync->missed < SYNC_PREAMBLE_MAX_MISSED;
+}
+
+static uint32_t uncertaintyAfter(const SyncPreamble* sync, uint32_t elapsedMs) {
+  uint64_t driftUs = (uint64_t) elapsedMs * sync->driftPpm / 1000;
+  return SYNC_PREAMBLE_JITTER_US + (driftUs > 0x3FFFFFFF ? 0x3FFFFFFF : (uint32_t) driftUs);
+}
+
+uint32_t SyncPreamble_uncertaintyUs(const SyncPreamble* sync, uint32_t nowMs) {
+  return uncertaintyAfter(sync, nowMs - sync->lastSyncMs);
+}
+
+uint32_t SyncPreamble_spreadUs(const SyncPreamble* sync, uint32_t nowMs) {
+  uint32_t elapsedMs = nowMs - sync->lastSyncMs;
+  uint32_t peerElapsedMs = elapsedMs + (SYNC_PREAMBLE_MAX_MISSED - 1) * sync->intervalMs;
+  return uncertaintyAfter(sync, elapsedMs) + uncertaintyAfter(sync, peerElapsedMs);
+}
+
+// ============================================================================
+// PREAMBLE AND LISTEN WINDOW
+// ============================================================================
+
+uint32_t SyncPreamble_symbolUs(const sx126x_mod_params_lora_t* mod) {
+  return (uint32_t) (((uint64_t) 1000000 << mod->sf) / sx126x_get_lora_bw_in_hz(mod->bw));
+}
+
+uint16_t SyncPreamble_symbols(const SyncPreamble* sync, uint32_t nowMs, const sx126x_mod_params_lora_t* mod,
+                              uint16_t longSymb) {
+  if (!SyncPreamble_confident(sync)) {
+    return longSymb;
+  }
+  uint32_t symbolUs = SyncPreamble_symbolUs(mod);
+  uint32_t spread = SyncPreamble_spreadUs(sync, nowMs);
+  uint32_t symbols = SYNC_PREAMBLE_MIN_SYMB + (spread + symbolUs - 1) / symbolUs;
+  return symbols < longSymb ? (uint16_t) symbols : longSymb;
+}
+
+uint32_t SyncPreamble_listenUs(const SyncPreamble* sync, uint32_t nowMs, const sx126x_mod_params_lora_t* mod) {
+  if (!SyncPreamble_confident(sync)) {
+    return 0;
+  }
+  return SyncPreamble_spreadUs(sync, nowMs) + SYNC_PREAMBLE_MIN_SYMB * SyncPreamble_symbolUs(mod);
+}
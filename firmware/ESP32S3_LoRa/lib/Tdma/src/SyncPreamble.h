@@ -0,0 +1,85 @@
+#pragma once
+#include <stdint.h>
+#include "sx126x.h"
+
+// ============================================================================
+// SYNCHRONIZED-WAKE PREAMBLE SIZING
+// ============================================================================
+//
+// Between Sync beacons a node's slot clock drifts from the master's. Its
+// uncertainty is the beacon timestamp jitter plus drift times the time since
+// its last beacon. The peer may have missed up to SYNC_PREAMBLE_MAX_MISSED - 1
+// more beacons and still count as synced, so the spread between the two is
+// bounded by this node's uncertainty plus that of such a peer. Transmitter
+// and receiver both start at their own slot start, so the preamble must
+// still hold SYNC_PREAMBLE_MIN_SYMB symbols after an early start of that
+// much, and the receiver must wait as long for a late one:
+//
+//   preamble = SYNC_PREAMBLE_MIN_SYMB + ceil(spread / Tsym)
+//   listen   = spread + SYNC_PREAMBLE_MIN_SYMB * Tsym
+//
+// with the RX timer stopped on preamble detection, so a transmitter still
+// on the long preamble is caught as well. The preamble is never more than
+// the long (unsynchronized) one. The drift bound is learned from the
+// correction applied at every beacon and never goes below
+// SYNC_PREAMBLE_DRIFT_PPM. With no beacon yet, or SYNC_PREAMBLE_MAX_MISSED
+// missed in a row, the long preamble is used and receivers listen the
+// whole slot.
+//
+
+#ifndef SYNC_PREAMBLE_MIN_SYMB
+#define SYNC_PREAMBLE_MIN_SYMB     6         // preamble detection lock
+#endif
+
+#ifndef SYNC_PREAMBLE_DRIFT_PPM
+#define SYNC_PREAMBLE_DRIFT_PPM    20        // crystal tolerance + temperature
+#endif
+
+#ifndef SYNC_PREAMBLE_JITTER_US
+#define SYNC_PREAMBLE_JITTER_US    200       // beacon timestamp + wake-up
+#endif
+
+#ifndef SYNC_PREAMBLE_MAX_MISSED
+#define SYNC_PREAMBLE_MAX_MISSED   2
+#endif
+
+struct SyncPreambleStats {
+  uint32_t syncs;
+  uint32_t missed;
+  uint32_t fallbacks;        // confidence lost (missed beacons)
+  uint32_t surprises;        // correction beyond the predicted uncertainty
+};
+
+struct SyncPreamble {
+  uint32_t lastSyncMs;
+  uint32_t intervalMs;       // between Sync beacons
+  uint16_t driftPpm;
+  uint8_t missed;            // consecutive
+  bool synced;
+  SyncPreambleStats stats;
+};
+
+void SyncPreamble_init(SyncPreamble* sync);
+
+// A Sync beacon at nowMs moved the local slot clock by correctionUs.
+void SyncPreamble_onSync(SyncPreamble* sync, uint32_t nowMs, int32_t correctionUs);
+void SyncPreamble_onSyncMissed(SyncPreamble* sync);
+
+bool SyncPreamble_confident(const SyncPreamble* sync);
+
+// This node's offset bound from the master at nowMs.
+uint32_t SyncPreamble_uncertaintyUs(const SyncPreamble* sync, uint32_t nowMs);
+
+// Offset bound between this node and a synced peer at nowMs.
+uint32_t SyncPreamble_spreadUs(const SyncPreamble* sync, uint32_t nowMs);
+
+// Preamble for a slot at nowMs, longSymb when not confident.
+uint16_t SyncPreamble_symbols(const SyncPreamble* sync, uint32_t nowMs, const sx126x_mod_params_lora_t* mod,
+                              uint16_t longSymb);
+
+// How long a receiver must listen from its slot start until the preamble
+// is detected (sx126x_stop_timer_on_preamble). 0 when not confident: listen
+// the whole slot.
+uint32_t SyncPreamble_listenUs(const SyncPreamble* sync, uint32_t nowMs, const sx126x_mod_params_lora_t* mod);
+
+uint32_t SyncPreamble_symbolUs(const sx126x_mod_params_lora_t* mod);
@@ -0,0 +1,21 @@
+#include "Tdma.h"
+
+TdmaPhase Tdma_phaseAt(uint32_t offsetMs) {
+  if (offsetMs < TDMA_SYNC_MS) {
+    return TDMA_PHASE_SYNC;
+  }
+  if (offsetMs < TDMA_DATA_OFFSET_MS) {
+    return TDMA_PHASE_CONTROL;
+  }
+  if (offsetMs < TDMA_DATA_OFFSET_MS + TDMA_DATA_MS) {
+    return TDMA_PHASE_DATA;
+  }
+  return TDMA_PHASE_EMERGENCY;
+}
+
+uint8_t Tdma_dataSlotAt(uint32_t offsetMs) {
+  if (Tdma_phaseAt(offsetMs) != TDMA_PHASE_DATA) {
+    return 0xFF;
+  }
+  return (offsetMs - TDMA_DATA_OFFSET_MS) / TDMA_DATA_SLOT_MS;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// TDMA SUPERFRAME LAYOUT
+// ============================================================================
+//
+//  ┌─────┬─────────┬─────────────────────────┬─────────┐
+//  │Sync │ Control │          Data           │Emergency│
+//  │100ms│  200ms  │         600ms           │  100ms  │
+//  └─────┴─────────┴─────────────────────────┴─────────┘
+//
+// The data phase is divided into fixed-length slots. Slots are numbered
+// globally by the absolute slot number (ASN): superframe * dataSlots + slot.
+//
+
+#define TDMA_SYNC_MS            100
+#define TDMA_CONTROL_MS         200
+#define TDMA_DATA_MS            600
+#define TDMA_EMERGENCY_MS       100
+#define TDMA_SUPERFRAME_MS      (TDMA_SYNC_MS + TDMA_CONTROL_MS + TDMA_DATA_MS + TDMA_EMERGENCY_MS)
+
+#define TDMA_DATA_SLOT_MS       10
+#define TDMA_DATA_SLOTS         (TDMA_DATA_MS / TDMA_DATA_SLOT_MS)
+
+enum TdmaPhase : uint8_t {
+  TDMA_PHASE_SYNC = 0,
+  TDMA_PHASE_CONTROL,
+  TDMA_PHASE_DATA,
+  TDMA_PHASE_EMERGENCY,
+};
+
+// Offset (ms) of the data phase from the start of the superframe.
+#define TDMA_DATA_OFFSET_MS     (TDMA_SYNC_MS + TDMA_CONTROL_MS)
+
+static inline uint32_t Tdma_asn(uint32_t superframe, uint8_t slot) {
+  return superframe * TDMA_DATA_SLOTS + slot;
+}
+
+TdmaPhase Tdma_phaseAt(uint32_t offsetMs);
+
+// Data slot index at offsetMs into the superframe, or 0xFF outside the
+// data phase.
+uint8_t Tdma_dataSlotAt(uint32_t offsetMs);
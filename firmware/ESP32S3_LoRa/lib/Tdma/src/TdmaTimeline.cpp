@@ -0,0 +1,196 @@
+#include "TdmaTimeline.h"
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static const uint16_t periodMs[] = { 500, 1000, 2000 };
+
+// Sync / Control / Data / Emergency, per mille of the period
+static const uint16_t splitPermille[][4] = {
+  { 100, 200, 600, 100 },
+  { 100, 380, 420, 100 },
+  { 100,  80, 720, 100 },
+};
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool setPending(TdmaTimeline* timeline, TdmaProfile profile, uint32_t effectiveSuperframe) {
+  if (effectiveSuperframe <= timeline->epochSuperframe || !Tdma_layoutFor(profile, &timeline->nextLayout)) {
+    return false;
+  }
+  timeline->next = profile;
+  timeline->effectiveSuperframe = effectiveSuperframe;
+  timeline->pending = true;
+  return true;
+}
+
+static uint8_t encodeProfile(TdmaProfile profile) {
+  return (profile.period & 0x0F) | (profile.split << 4);
+}
+
+static TdmaProfile decodeProfile(uint8_t b) {
+  return { (uint8_t) (b & 0x0F), (uint8_t) (b >> 4) };
+}
+
+static bool sameProfile(TdmaProfile a, TdmaProfile b) {
+  return a.period == b.period && a.split == b.split;
+}
+
+// ============================================================================
+// LAYOUT
+// ============================================================================
+
+bool Tdma_layoutFor(TdmaProfile profile, TdmaLayout* layout) {
+  if (profile.period > TDMA_PERIOD_SLOW || profile.split > TDMA_SPLIT_MOBILE_HEAVY) {
+    return false;
+  }
+
+  uint16_t total = periodMs[profile.period];
+  const uint16_t* share = splitPermille[profile.split];
+
+  layout->superframeMs = total;
+  layout->syncMs = (uint32_t) total * share[0] / 1000;
+  layout->emergencyMs = (uint32_t) total * share[3] / 1000;
+  layout->dataMs = (uint32_t) total * share[2] / 1000;
+  layout->dataMs -= layout->dataMs % TDMA_DATA_SLOTS;      // whole-ms slots
+  layout->controlMs = total - layout->syncMs - layout->dataMs - layout->emergencyMs;
+  layout->dataSlotMs = layout->dataMs / TDMA_DATA_SLOTS;
+  return true;
+}
+
+TdmaPhase TdmaLayout_phaseAt(const TdmaLayout* layout, uint32_t offsetMs) {
+  if (offsetMs < layout->syncMs) {
+    return TDMA_PHASE_SYNC;
+  }
+  if (offsetMs < (uint32_t) layout->syncMs + layout->controlMs) {
+    return TDMA_PHASE_CONTROL;
+  }
+  if (offsetMs < (uint32_t) layout->syncMs + layout->controlMs + layout->dataMs) {
+    return TDMA_PHASE_DATA;
+  }
+  return TDMA_PHASE_EMERGENCY;
+}
+
+uint8_t TdmaLayout_dataSlotAt(const TdmaLayout* layout, uint32_t offsetMs) {
+  if (TdmaLayout_phaseAt(layout, offsetMs) != TDMA_PHASE_DATA) {
+    return 0xFF;
+  }
+  return (offsetMs - layout->syncMs - layout->controlMs) / layout->dataSlotMs;
+}
+
+// ============================================================================
+// TIMELINE
+// ============================================================================
+
+bool TdmaTimeline_init(TdmaTimeline* timeline, TdmaProfile profile, uint32_t startMs, uint32_t superframe) {
+  if (!Tdma_layoutFor(profile, &timeline->layout)) {
+    return false;
+  }
+  timeline->profile = profile;
+  timeline->epochMs = startMs;
+  timeline->epochSuperframe = superframe;
+  timeline->pending = false;
+  return true;
+}
+
+bool TdmaTimeline_schedule(TdmaTimeline* timeline, TdmaProfile profile, uint32_t effectiveSuperframe,
+                           uint32_t currentSuperframe) {
+  if (effectiveSuperframe < currentSuperframe + TDMA_MIN_SWITCH_LEAD) {
+    return false;
+  }
+  return setPending(timeline, profile, effectiveSuperframe);
+}
+
+void TdmaTimeline_locate(TdmaTimeline* timeline, uint32_t nowMs, TdmaPosition* position) {
+  if (timeline->pending) {
+    uint32_t boundaryMs = TdmaTimeline_superframeStart(timeline, timeline->effectiveSuperframe);
+    if ((int32_t) (nowMs - boundaryMs) >= 0) {
+      timeline->profile = timeline->next;
+      timeline->layout = timeline->nextLayout;
+      timeline->epochMs = boundaryMs;
+      timeline->epochSuperframe = timeline->effectiveSuperframe;
+      timeline->pending = false;
+    }
+  }
+
+  uint32_t elapsed = nowMs - timeline->epochMs;
+  position->superframe = timeline->epochSuperframe + elapsed / timeline->layout.superframeMs;
+  position->offsetMs = elapsed % timeline->layout.superframeMs;
+  position->phase = TdmaLayout_phaseAt(&timeline->layout, position->offsetMs);
+  position->dataSlot = TdmaLayout_dataSlotAt(&timeline->layout, position->offsetMs);
+}
+
+uint32_t TdmaTimeline_superframeStart(const TdmaTimeline* timeline, uint32_t superframe) {
+  if (!timeline->pending || superframe <= timeline->effectiveSuperframe) {
+    return timeline->epochMs + (superframe - timeline->epochSuperframe) * timeline->layout.superframeMs;
+  }
+  uint32_t boundaryMs = TdmaTimeline_superframeStart(timeline, timeline->effectiveSuperframe);
+  return boundaryMs + (superframe - timeline->effectiveSuperframe) * timeline->nextLayout.superframeMs;
+}
+
+const TdmaLayout* TdmaTimeline_layoutOf(const TdmaTimeline* timeline, uint32_t superframe) {
+  if (timeline->pending && superframe >= timeline->effectiveSuperframe) {
+    return &timeline->nextLayout;
+  }
+  return &timeline->layout;
+}
+
+// ============================================================================
+// ANNOUNCEMENT
+// ============================================================================
+
+uint8_t TdmaTimeline_encodeAnnouncement(const TdmaTimeline* timeline, uint8_t* buf) {
+  buf[0] = encodeProfile(timeline->profile);
+  buf[1] = timeline->epochSuperframe & 0xFF;
+  buf[2] = (timeline->epochSuperframe >> 8) & 0xFF;
+  buf[3] = timeline->pending ? encodeProfile(timeline->next) : TDMA_NO_PROFILE;
+  buf[4] = timeline->pending ? timeline->effectiveSuperframe & 0xFF : 0;
+  buf[5] = timeline->pending ? (timeline->effectiveSuperframe >> 8) & 0xFF : 0;
+  return TDMA_ANNOUNCEMENT_LEN;
+}
+
+bool TdmaTimeline_applyAnnouncement(TdmaTimeline* timeline, const uint8_t* buf, uint8_t len,
+                                    uint32_t currentSuperframe, uint32_t beaconMs) {
+  if (len < TDMA_ANNOUNCEMENT_LEN) {
+    return false;
+  }
+
+  TdmaProfile active = decodeProfile(buf[0]);
+  TdmaLayout layout;
+  uint16_t age = (uint16_t) ((uint16_t) currentSuperframe - (buf[1] | (buf[2] << 8)));
+  if (!Tdma_layoutFor(active, &layout) || age > currentSuperframe) {
+    return false;
+  }
+
+  // Take any switch that is due, then compare with the master. Epochs are
+  // compared on their low 16 bits: an older epoch on the same profile
+  // describes the same timeline
+  TdmaPosition position;
+  TdmaTimeline_locate(timeline, beaconMs, &position);
+  if (!sameProfile(timeline->profile, active) ||
+      (uint16_t) timeline->epochSuperframe != (uint16_t) (currentSuperframe - age)) {
+    TdmaTimeline_init(timeline, active, beaconMs - (uint32_t) age * layout.superframeMs, currentSuperframe - age);
+  }
+
+  if (buf[3] == TDMA_NO_PROFILE) {
+    timeline->pending = false;
+    return true;
+  }
+
+  TdmaProfile next = decodeProfile(buf[3]);
+  uint16_t ahead = (uint16_t) ((buf[4] | (buf[5] << 8)) - (uint16_t) currentSuperframe);
+  if (ahead == 0 || ahead >= 0x8000) {
+    return false;          // boundary already passed
+  }
+
+  // Repeats of the same announcement are expected every superframe; a late
+  // first copy (less than TDMA_MIN_SWITCH_LEAD ahead) is still taken
+  uint32_t effective = currentSuperframe + ahead;
+  if (timeline->pending && timeline->effectiveSuperframe == effective && sameProfile(timeline->next, next)) {
+    return true;
+  }
+  return setPending(timeline, next, effective);
+}
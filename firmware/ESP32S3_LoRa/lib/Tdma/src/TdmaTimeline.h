@@ -0,0 +1,118 @@
+#pragma once
+#include <stdint.h>
+#include "Tdma.h"
+
+// ============================================================================
+// SUPERFRAME PROFILES AND TIMELINE
+// ============================================================================
+//
+// A profile is a superframe period plus a phase split:
+//
+//   period   Fast 500 ms | Standard 1000 ms | Slow 2000 ms
+//   split    Balanced 10/20/60/10 % (Sync/Control/Data/Emergency)
+//            Anchor-heavy 10/38/42/10 %, Mobile-heavy 10/8/72/10 %
+//
+// The data phase always holds TDMA_DATA_SLOTS slots; only the slot length
+// changes (3 ms for Fast anchor-heavy up to 24 ms for Slow mobile-heavy), so
+// schedules, slot maps and ASNs stay valid across a switch.
+//
+// The master announces a switch in every Sync beacon, at least
+// TDMA_MIN_SWITCH_LEAD superframes before it takes effect. Every node holds
+// the same timeline (epoch + profile), so each applies the new profile at
+// the same superframe boundary: the last old superframe ends exactly where
+// the first new one starts. Every beacon also carries the active profile
+// and its epoch, so a node that missed all the announcements (or joined
+// late) resyncs at the first beacon it hears after the boundary.
+//
+
+#ifndef TDMA_MIN_SWITCH_LEAD
+#define TDMA_MIN_SWITCH_LEAD  2       // superframes of announcements
+#endif
+
+enum TdmaPeriod : uint8_t {
+  TDMA_PERIOD_FAST = 0,
+  TDMA_PERIOD_STANDARD,
+  TDMA_PERIOD_SLOW,
+};
+
+enum TdmaSplit : uint8_t {
+  TDMA_SPLIT_BALANCED = 0,
+  TDMA_SPLIT_ANCHOR_HEAVY,
+  TDMA_SPLIT_MOBILE_HEAVY,
+};
+
+struct TdmaProfile {
+  uint8_t period;            // TdmaPeriod
+  uint8_t split;             // TdmaSplit
+};
+
+struct TdmaLayout {
+  uint16_t syncMs;
+  uint16_t controlMs;
+  uint16_t dataMs;
+  uint16_t emergencyMs;
+  uint16_t superframeMs;
+  uint8_t dataSlotMs;
+};
+
+struct TdmaPosition {
+  uint32_t superframe;
+  uint32_t offsetMs;         // into the superframe
+  TdmaPhase phase;
+  uint8_t dataSlot;          // 0xFF outside the data phase
+};
+
+struct TdmaTimeline {
+  TdmaProfile profile;
+  TdmaLayout layout;
+  uint32_t epochMs;          // start of epochSuperframe
+  uint32_t epochSuperframe;
+  bool pending;
+  TdmaProfile next;
+  TdmaLayout nextLayout;
+  uint32_t effectiveSuperframe;
+};
+
+// Announcement, profiles as period bits 0-3 | split bits 4-7, superframes
+// as their low 16 bits (little endian):
+//
+//  byte 0    active profile
+//  byte 1-2  epoch superframe of the active profile
+//  byte 3    pending profile, TDMA_NO_PROFILE if none
+//  byte 4-5  effective superframe of the pending profile
+//
+#define TDMA_ANNOUNCEMENT_LEN  6
+#define TDMA_NO_PROFILE        0xFF
+
+bool Tdma_layoutFor(TdmaProfile profile, TdmaLayout* layout);
+TdmaPhase TdmaLayout_phaseAt(const TdmaLayout* layout, uint32_t offsetMs);
+uint8_t TdmaLayout_dataSlotAt(const TdmaLayout* layout, uint32_t offsetMs);
+
+// Superframe `superframe` of `profile` starts at startMs (local clock).
+bool TdmaTimeline_init(TdmaTimeline* timeline, TdmaProfile profile, uint32_t startMs, uint32_t superframe);
+
+// Switches to profile at the start of effectiveSuperframe. Returns false if
+// the profile is invalid or the boundary is less than TDMA_MIN_SWITCH_LEAD
+// superframes after currentSuperframe (the one in progress): a boundary too
+// close leaves too few beacons to announce it, and one that has already
+// passed would be applied at different times by different nodes.
+bool TdmaTimeline_schedule(TdmaTimeline* timeline, TdmaProfile profile, uint32_t effectiveSuperframe,
+                           uint32_t currentSuperframe);
+
+// Position at nowMs. Applies a pending switch once nowMs reaches it, so
+// calls must come in time order.
+void TdmaTimeline_locate(TdmaTimeline* timeline, uint32_t nowMs, TdmaPosition* position);
+
+// Start time and layout of a superframe at or after the current epoch,
+// accounting for a pending switch.
+uint32_t TdmaTimeline_superframeStart(const TdmaTimeline* timeline, uint32_t superframe);
+const TdmaLayout* TdmaTimeline_layoutOf(const TdmaTimeline* timeline, uint32_t superframe);
+
+// Sync beacon field, always TDMA_ANNOUNCEMENT_LEN bytes. apply takes the
+// superframe the beacon opens and its start on the local clock: it
+// re-anchors the timeline on the master's active profile and epoch if they
+// differ from the node's, then takes (or clears) the pending switch, late
+// announcements included. Returns false for a malformed field.
+uint8_t TdmaTimeline_encodeAnnouncement(const TdmaTimeline* timeline, uint8_t* buf);
+bool TdmaTimeline_applyAnnouncement(TdmaTimeline* timeline, const uint8_t* buf, uint8_t len,
+                                    uint32_t currentSuperframe, uint32_t beaconMs);
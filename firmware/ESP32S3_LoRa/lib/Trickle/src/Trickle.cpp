@@ -0,0 +1,68 @@
+#include "Trickle.h"
+
+#define TRICKLE_IMAX_MS  ((uint32_t) TRICKLE_IMIN_MS << TRICKLE_DOUBLINGS)
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static uint32_t nextRandom(TrickleTimer* timer) {
+  timer->rng ^= timer->rng << 13;
+  timer->rng ^= timer->rng >> 17;
+  timer->rng ^= timer->rng << 5;
+  return timer->rng;
+}
+
+static void startInterval(TrickleTimer* timer, uint32_t nowMs) {
+  uint32_t half = timer->intervalMs / 2;
+  timer->intervalStartMs = nowMs;
+  timer->fireAtMs = nowMs + half + (uint32_t) (((uint64_t) nextRandom(timer) * half) >> 32);
+  timer->counter = 0;
+  timer->pending = true;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void TrickleTimer_init(TrickleTimer* timer, uint32_t seed, uint32_t nowMs) {
+  timer->rng = seed != 0 ? seed : 0x9E3779B9;
+  timer->intervalMs = TRICKLE_IMIN_MS;
+  startInterval(timer, nowMs);
+}
+
+void TrickleTimer_reset(TrickleTimer* timer, uint32_t nowMs) {
+  if (timer->intervalMs != TRICKLE_IMIN_MS) {
+    timer->intervalMs = TRICKLE_IMIN_MS;
+    startInterval(timer, nowMs);
+  }
+}
+
+void TrickleTimer_consistent(TrickleTimer* timer) {
+  if (timer->counter < 0xFF) {
+    timer->counter++;
+  }
+}
+
+bool TrickleTimer_poll(TrickleTimer* timer, uint32_t nowMs) {
+  bool send = false;
+  if (timer->pending && (int32_t) (nowMs - timer->fireAtMs) >= 0) {
+    timer->pending = false;
+    send = timer->counter < TRICKLE_K;
+  }
+
+  while ((int32_t) (nowMs - (timer->intervalStartMs + timer->intervalMs)) >= 0) {
+    uint32_t end = timer->intervalStartMs + timer->intervalMs;
+    if (timer->intervalMs < TRICKLE_IMAX_MS) {
+      timer->intervalMs *= 2;
+    }
+    startInterval(timer, end);
+  }
+  return send;
+}
+
+uint32_t TrickleTimer_dueInMs(const TrickleTimer* timer, uint32_t nowMs) {
+  uint32_t due = timer->pending ? timer->fireAtMs : timer->intervalStartMs + timer->intervalMs;
+  int32_t left = (int32_t) (due - nowMs);
+  return left > 0 ? (uint32_t) left : 0;
+}
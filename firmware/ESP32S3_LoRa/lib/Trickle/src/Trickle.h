@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// ============================================================================
+// TRICKLE TIMER (RFC 6206)
+// ============================================================================
+//
+// One timer per piece of shared state. Each interval I starts at
+// TRICKLE_IMIN_MS and doubles up to TRICKLE_DOUBLINGS times. A node
+// transmits once per interval, at a random point t in [I/2, I), unless it
+// has already heard TRICKLE_K consistent copies in that interval. Hearing
+// an inconsistent copy (another version) shrinks I back to Imin, so news
+// spreads at the Imin pace while a settled network only chatters at
+// roughly k transmissions per neighborhood per Imax.
+//
+
+#ifndef TRICKLE_IMIN_MS
+#define TRICKLE_IMIN_MS      2000
+#endif
+
+#ifndef TRICKLE_DOUBLINGS
+#define TRICKLE_DOUBLINGS    6         // Imax = 128 s
+#endif
+
+#ifndef TRICKLE_K
+#define TRICKLE_K            1
+#endif
+
+struct TrickleTimer {
+  uint32_t intervalMs;
+  uint32_t intervalStartMs;
+  uint32_t fireAtMs;
+  uint32_t rng;              // per-timer jitter source
+  uint8_t counter;
+  bool pending;              // t not reached yet in this interval
+};
+
+void TrickleTimer_init(TrickleTimer* timer, uint32_t seed, uint32_t nowMs);
+
+// An inconsistent copy was heard, or the local state changed.
+void TrickleTimer_reset(TrickleTimer* timer, uint32_t nowMs);
+
+// A consistent copy was heard.
+void TrickleTimer_consistent(TrickleTimer* timer);
+
+// Advances the timer; true once per interval when this node should send.
+bool TrickleTimer_poll(TrickleTimer* timer, uint32_t nowMs);
+
+// Milliseconds until the timer next needs polling.
+uint32_t TrickleTimer_dueInMs(const TrickleTimer* timer, uint32_t nowMs);
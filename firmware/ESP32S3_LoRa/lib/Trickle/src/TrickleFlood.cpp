@@ -0,0 +1,178 @@
+#include "TrickleFlood.h"
+#include "ChannelAccess.h"
+#include "EntropyPool.h"
+#include "SnipsFrame.h"
+#include <string.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+struct TrickleItem {
+  TrickleTimer timer;
+  uint8_t id;
+  uint8_t version;
+  uint8_t len;
+  uint8_t data[TRICKLE_FLOOD_MAX_DATA];
+  bool used;
+};
+
+static TrickleItem items[TRICKLE_FLOOD_MAX_ITEMS];
+static TrickleFloodStats stats;
+static uint8_t self = 0;
+static uint8_t seq = 0;
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static TrickleItem* findItem(uint8_t id, bool create, uint32_t nowMs) {
+  for (uint8_t i = 0; i < TRICKLE_FLOOD_MAX_ITEMS; i++) {
+    if (items[i].used && items[i].id == id) {
+      return &items[i];
+    }
+  }
+  if (!create) {
+    return nullptr;
+  }
+  for (uint8_t i = 0; i < TRICKLE_FLOOD_MAX_ITEMS; i++) {
+    if (!items[i].used) {
+      memset(&items[i], 0, sizeof(items[i]));
+      items[i].used = true;
+      items[i].id = id;
+      TrickleTimer_init(&items[i].timer, EntropyPool_next(), nowMs);
+      return &items[i];
+    }
+  }
+  return nullptr;
+}
+
+static uint8_t buildFrame(const TrickleItem* item, uint8_t* out) {
+  SnipsFrameHeader header = {};
+  header.netId = SNIPS_NETWORK_ID;
+  header.type = SNIPS_FRAME_ANNOUNCE;
+  header.trafficClass = SNIPS_CLASS_MANAGEMENT;
+  header.src = self;
+  header.dst = SNIPS_ADDR_BROADCAST;
+  header.prevHop = self;
+  header.nextHop = SNIPS_ADDR_BROADCAST;
+  header.seq = seq++;
+  SnipsFrame_encodeHeader(&header, out);
+
+  uint8_t* p = out + SNIPS_FRAME_HEADER_LEN;
+  p[0] = item->id;
+  p[1] = item->version;
+  memcpy(p + TRICKLE_FLOOD_HEADER_LEN, item->data, item->len);
+  return SNIPS_FRAME_HEADER_LEN + TRICKLE_FLOOD_HEADER_LEN + item->len;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void TrickleFlood_begin(uint8_t selfAddress) {
+  memset(items, 0, sizeof(items));
+  memset(&stats, 0, sizeof(stats));
+  self = selfAddress;
+}
+
+bool TrickleFlood_publish(uint8_t id, const uint8_t* data, uint8_t len, uint32_t nowMs) {
+  if (len > TRICKLE_FLOOD_MAX_DATA) {
+    return false;
+  }
+  TrickleItem* item = findItem(id, true, nowMs);
+  if (item == nullptr) {
+    return false;
+  }
+  item->version++;
+  item->len = len;
+  memcpy(item->data, data, len);
+  TrickleTimer_reset(&item->timer, nowMs);
+  return true;
+}
+
+int16_t TrickleFlood_get(uint8_t id, uint8_t* data, uint8_t* version) {
+  TrickleItem* item = findItem(id, false, 0);
+  if (item == nullptr) {
+    return -1;
+  }
+  memcpy(data, item->data, item->len);
+  *version = item->version;
+  return item->len;
+}
+
+bool TrickleFlood_onFrame(const uint8_t* frame, uint8_t len, uint32_t nowMs) {
+  if (len < SNIPS_FRAME_HEADER_LEN + TRICKLE_FLOOD_HEADER_LEN || frame[0] != SNIPS_NETWORK_ID ||
+      SnipsFrame_type(frame) != SNIPS_FRAME_ANNOUNCE) {
+    return false;
+  }
+  const uint8_t* p = frame + SNIPS_FRAME_HEADER_LEN;
+  uint8_t dataLen = len - SNIPS_FRAME_HEADER_LEN - TRICKLE_FLOOD_HEADER_LEN;
+  if (dataLen > TRICKLE_FLOOD_MAX_DATA) {
+    return true;
+  }
+
+  TrickleItem* item = findItem(p[0], false, nowMs);
+  int8_t age = item != nullptr ? (int8_t) (p[1] - item->version) : 1;
+  if (age == 0) {
+    stats.consistent++;
+    TrickleTimer_consistent(&item->timer);
+    return true;
+  }
+
+  stats.inconsistent++;
+  if (age > 0) {
+    if (item == nullptr && (item = findItem(p[0], true, nowMs)) == nullptr) {
+      return true;
+    }
+    item->version = p[1];
+    item->len = dataLen;
+    memcpy(item->data, p + TRICKLE_FLOOD_HEADER_LEN, dataLen);
+    stats.adopted++;
+  }
+  TrickleTimer_reset(&item->timer, nowMs);
+  return true;
+}
+
+uint8_t TrickleFlood_poll(uint32_t nowMs, uint32_t windowEndMs) {
+  static uint8_t frame[SNIPS_FRAME_MAX_LEN];
+  uint8_t sent = 0;
+
+  for (uint8_t i = 0; i < TRICKLE_FLOOD_MAX_ITEMS; i++) {
+    TrickleItem& item = items[i];
+    if (!item.used) {
+      continue;
+    }
+    bool wasPending = item.timer.pending;
+    if (!TrickleTimer_poll(&item.timer, nowMs)) {
+      if (wasPending && !item.timer.pending) {
+        stats.suppressed++;
+      }
+      continue;
+    }
+
+    uint8_t len = buildFrame(&item, frame);
+    if (ChannelAccess_transmit(frame, len, windowEndMs) == CHANNEL_ACCESS_SENT) {
+      stats.sent++;
+      sent++;
+    } else {
+      stats.busy++;   // the next interval tries again
+    }
+  }
+  return sent;
+}
+
+uint32_t TrickleFlood_dueInMs(uint32_t nowMs) {
+  uint32_t due = 0xFFFFFFFF;
+  for (uint8_t i = 0; i < TRICKLE_FLOOD_MAX_ITEMS; i++) {
+    if (items[i].used) {
+      uint32_t d = TrickleTimer_dueInMs(&items[i].timer, nowMs);
+      due = d < due ? d : due;
+    }
+  }
+  return due;
+}
+
+void TrickleFlood_getStats(TrickleFloodStats* out) {
+  *out = stats;
+}
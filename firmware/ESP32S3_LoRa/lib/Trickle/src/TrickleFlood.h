@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include "Trickle.h"
+
+// ============================================================================
+// TRICKLE FLOODING (ANY -> ALL ANNOUNCEMENTS)
+// ============================================================================
+//
+// Network-wide announcements (configuration, schedule epochs, ...) are kept
+// as a small table of versioned items instead of being flooded frame by
+// frame. Every item has its own Trickle timer; when it fires the node
+// broadcasts the item through the CAD channel-access path:
+//
+//  SNIPS header (type ANNOUNCE, dst/nextHop broadcast)
+//  byte 0   item id
+//  byte 1   version (serial-number arithmetic, newer wins)
+//  byte 2+  item data
+//
+// A copy with the same version counts towards suppression; a newer one is
+// adopted and an older one answered, and both reset the timer. Call
+// TrickleFlood_onFrame() and TrickleFlood_poll() from the same task.
+//
+
+#ifndef TRICKLE_FLOOD_MAX_ITEMS
+#define TRICKLE_FLOOD_MAX_ITEMS   4
+#endif
+
+#ifndef TRICKLE_FLOOD_MAX_DATA
+#define TRICKLE_FLOOD_MAX_DATA    32
+#endif
+
+#define TRICKLE_FLOOD_HEADER_LEN  2
+
+struct TrickleFloodStats {
+  uint32_t sent;
+  uint32_t suppressed;       // timer fired with k consistent copies heard
+  uint32_t busy;             // channel access gave up
+  uint32_t consistent;
+  uint32_t inconsistent;
+  uint32_t adopted;          // newer versions taken over
+};
+
+void TrickleFlood_begin(uint8_t selfAddress);
+
+// Originates a new version of item id.
+bool TrickleFlood_publish(uint8_t id, const uint8_t* data, uint8_t len, uint32_t nowMs);
+
+// Latest data of item id; returns its length, or -1 if unknown.
+int16_t TrickleFlood_get(uint8_t id, uint8_t* data, uint8_t* version);
+
+// Feeds a received frame. Returns true if it was an announcement.
+bool TrickleFlood_onFrame(const uint8_t* frame, uint8_t len, uint32_t nowMs);
+
+// Sends every item whose timer fires, each before windowEndMs (millis()).
+// Returns the number sent.
+uint8_t TrickleFlood_poll(uint32_t nowMs, uint32_t windowEndMs);
+
+uint32_t TrickleFlood_dueInMs(uint32_t nowMs);
+
+void TrickleFlood_getStats(TrickleFloodStats* stats);
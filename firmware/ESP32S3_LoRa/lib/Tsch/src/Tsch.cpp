@@ -0,0 +1,90 @@
+#include "Tsch.h"
+#include <string.h>
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+static bool nodeBusy(const TschSchedule* schedule, uint8_t slot, uint8_t node) {
+  return TschSchedule_cellFor(schedule, slot, node) != TSCH_NO_CELL;
+}
+
+static int8_t freeChannelOffset(const TschSchedule* schedule, uint8_t slot) {
+  for (uint8_t offset = 0; offset < schedule->channels; offset++) {
+    if (!(schedule->channelUse[slot] & (1 << offset))) {
+      return offset;
+    }
+  }
+  return -1;
+}
+
+// ============================================================================
+// CELL SCHEDULER
+// ============================================================================
+
+void TschSchedule_init(TschSchedule* schedule, uint8_t slots, uint8_t channels) {
+  memset(schedule, 0, sizeof(*schedule));
+  schedule->slots = slots <= TDMA_DATA_SLOTS ? slots : TDMA_DATA_SLOTS;
+  schedule->channels = channels <= TSCH_MAX_CHANNELS ? channels : TSCH_MAX_CHANNELS;
+}
+
+uint8_t TschSchedule_assign(TschSchedule* schedule, uint8_t tx, uint8_t rx, uint8_t cellsWanted) {
+  uint8_t granted = 0;
+
+  for (uint8_t c = 0; c < cellsWanted && schedule->cellCount < TSCH_MAX_CELLS; c++) {
+    // Aim for an even spread so the link's cells are not bunched in one
+    // part of the data phase, then probe forward for the first legal slot.
+    uint8_t preferred = (uint16_t) c * schedule->slots / cellsWanted;
+
+    for (uint8_t probe = 0; probe < schedule->slots; probe++) {
+      uint8_t slot = (preferred + probe) % schedule->slots;
+      int8_t offset = freeChannelOffset(schedule, slot);
+      if (offset < 0 || nodeBusy(schedule, slot, tx) || nodeBusy(schedule, slot, rx)) {
+        continue;
+      }
+
+      TschCell& cell = schedule->cells[schedule->cellCount++];
+      cell.slot = slot;
+      cell.channelOffset = offset;
+      cell.tx = tx;
+      cell.rx = rx;
+      cell.sf = TSCH_SF_DEFAULT;
+      schedule->channelUse[slot] |= 1 << offset;
+      granted++;
+      break;
+    }
+  }
+
+  return granted;
+}
+
+void TschSchedule_release(TschSchedule* schedule, uint8_t tx, uint8_t rx) {
+  uint16_t kept = 0;
+  for (uint16_t i = 0; i < schedule->cellCount; i++) {
+    const TschCell& cell = schedule->cells[i];
+    if (cell.tx != tx || cell.rx != rx) {
+      schedule->cells[kept++] = cell;
+    }
+  }
+  schedule->cellCount = kept;
+
+  // Cells of other links may share a channel offset (SF division)
+  memset(schedule->channelUse, 0, sizeof(schedule->channelUse));
+  for (uint16_t i = 0; i < kept; i++) {
+    schedule->channelUse[schedule->cells[i].slot] |= 1 << schedule->cells[i].channelOffset;
+  }
+}
+
+uint16_t TschSchedule_cellFor(const TschSchedule* schedule, uint8_t slot, uint8_t node) {
+  for (uint16_t i = 0; i < schedule->cellCount; i++) {
+    const TschCell& cell = schedule->cells[i];
+    if (cell.slot == slot && (cell.tx == node || cell.rx == node)) {
+      return i;
+    }
+  }
+  return TSCH_NO_CELL;
+}
+
+uint8_t Tsch_channelFor(uint32_t asn, uint8_t channelOffset, uint8_t numChannels) {
+  return (asn + channelOffset) % numChannels;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include "Tdma.h"
+
+// ============================================================================
+// TIME-SLOTTED CHANNEL HOPPING (SLOT x CHANNEL CELLS)
+// ============================================================================
+//
+// Each data slot carries up to numChannels concurrent links, one per channel
+// offset. A cell's physical channel hops every slot:
+//
+//   channel = (asn + channelOffset) % numChannels
+//
+// so a link does not sit on one (possibly faded or jammed) channel and
+// concurrent cells of a slot always land on distinct channels. The cell
+// scheduler runs on the TDMA master and never puts a node in two cells of
+// the same slot (single half-duplex radio) or two links on one channel
+// offset of a slot.
+//
+
+#ifndef TSCH_MAX_CHANNELS
+#define TSCH_MAX_CHANNELS  8
+#endif
+
+// channelUse keeps one bit per channel offset in a uint8_t
+#if TSCH_MAX_CHANNELS > 8
+#error "TSCH_MAX_CHANNELS above 8 does not fit the per-slot channel mask"
+#endif
+
+#ifndef TSCH_MAX_CELLS
+#define TSCH_MAX_CELLS     240
+#endif
+
+#define TSCH_NO_CELL       0xFFFF
+#define TSCH_SF_DEFAULT    0         // cell uses the configured modulation
+
+struct TschCell {
+  uint8_t slot;
+  uint8_t channelOffset;
+  uint8_t tx;
+  uint8_t rx;
+  uint8_t sf;                // sx126x_lora_sf_t, or TSCH_SF_DEFAULT
+};
+
+struct TschSchedule {
+  TschCell cells[TSCH_MAX_CELLS];
+  uint16_t cellCount;
+  uint8_t slots;
+  uint8_t channels;
+  uint8_t channelUse[TDMA_DATA_SLOTS];   // bitmask of used channel offsets
+};
+
+void TschSchedule_init(TschSchedule* schedule, uint8_t slots, uint8_t channels);
+
+// Allocates up to cellsWanted cells for the tx -> rx link, spread across the
+// data phase. Returns the number of cells granted.
+uint8_t TschSchedule_assign(TschSchedule* schedule, uint8_t tx, uint8_t rx, uint8_t cellsWanted);
+
+// Frees every cell of the tx -> rx link.
+void TschSchedule_release(TschSchedule* schedule, uint8_t tx, uint8_t rx);
+
+// Index of the cell node takes part in during slot, or TSCH_NO_CELL.
+uint16_t TschSchedule_cellFor(const TschSchedule* schedule, uint8_t slot, uint8_t node);
+
+// Physical channel index (into the FreqPlan) for a cell at asn.
+uint8_t Tsch_channelFor(uint32_t asn, uint8_t channelOffset, uint8_t numChannels);
@@ -0,0 +1,114 @@
+#include "TschRadio.h"
+#include "FreqPlan.h"
+#include "SfDivision.h"
+#include "SnipsRadio.h"
+#include "SnipsHcRadio.h"
+
+static uint8_t activeSf = TSCH_SF_DEFAULT;
+static bool syncedWake = false;
+static SyncPreamble syncState;
+static uint16_t slotPreamble = 0;
+static uint32_t slotListenUs = 0;
+
+static void modFor(uint8_t sf, sx126x_mod_params_lora_t* mod) {
+  const sx126x_mod_params_lora_t* base = &SnipsRadio_loraConfig()->mod;
+  SfDivision_modParams(base, sf == TSCH_SF_DEFAULT ? (uint8_t) base->sf : sf, mod);
+}
+
+static bool applySf(uint8_t sf) {
+  sx126x_mod_params_lora_t mod;
+  modFor(sf, &mod);
+
+  SnipsRadio_lock();
+  bool ok = sx126x_set_lora_mod_params(SnipsRadio_context(), &mod) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+
+  if (ok) {
+    activeSf = sf;
+  }
+  return ok;
+}
+
+// Sizes the preamble and listen window of a slot at the cell's SF.
+static void applyPreamble(uint8_t sf) {
+  uint16_t longSymb = SnipsRadio_loraConfig()->pkt.preamble_len_in_symb;
+  uint16_t preamble = longSymb;
+  slotListenUs = 0;
+
+  if (syncedWake) {
+    sx126x_mod_params_lora_t mod;
+    modFor(sf, &mod);
+    uint32_t nowMs = millis();
+    preamble = SyncPreamble_symbols(&syncState, nowMs, &mod, longSymb);
+    slotListenUs = SyncPreamble_listenUs(&syncState, nowMs, &mod);
+  }
+  if (preamble != slotPreamble) {
+    SnipsRadio_setTxPreamble(preamble == longSymb ? 0 : preamble);
+    slotPreamble = preamble;
+  }
+}
+
+bool TschRadio_enterCell(uint32_t asn, const TschCell* cell) {
+  SnipsHcRadio_setCell(cell->tx, cell->rx);
+  applyPreamble(cell->sf);
+
+  if (cell->sf != activeSf && !applySf(cell->sf)) {
+    return false;
+  }
+
+  uint8_t channel = Tsch_channelFor(asn, cell->channelOffset, FreqPlan_channelCount());
+  if (channel == FreqPlan_currentChannel()) {
+    return true;
+  }
+  return FreqPlan_switchTo(channel);
+}
+
+bool TschRadio_leaveCell() {
+  SnipsHcRadio_clearCell();
+  SnipsRadio_setTxPreamble(0);
+  slotPreamble = 0;
+  slotListenUs = 0;
+
+  if (activeSf != TSCH_SF_DEFAULT) {
+    return applySf(TSCH_SF_DEFAULT);
+  }
+  return true;
+}
+
+bool TschRadio_setSyncedWake(bool enabled) {
+  if (enabled && !syncedWake) {
+    SyncPreamble_init(&syncState);
+  }
+
+  // The listen window ends at preamble detection, not at the header
+  SnipsRadio_lock();
+  bool ok = sx126x_stop_timer_on_preamble(SnipsRadio_context(), enabled) == SX126X_STATUS_OK;
+  SnipsRadio_unlock();
+
+  syncedWake = enabled && ok;
+  return ok;
+}
+
+void TschRadio_onSync(uint32_t nowMs, int32_t correctionUs) {
+  if (syncedWake) {
+    SyncPreamble_onSync(&syncState, nowMs, correctionUs);
+  }
+}
+
+void TschRadio_onSyncMissed() {
+  if (syncedWake) {
+    SyncPreamble_onSyncMissed(&syncState);
+  }
+}
+
+uint32_t TschRadio_rxTimeoutMs() {
+  return (slotListenUs + 999) / 1000;
+}
+
+uint16_t TschRadio_preambleSymbols() {
+  return slotPreamble;
+}
+
+void TschRadio_getSyncStats(SyncPreambleStats* out) {
+  *out = syncState.stats;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Tsch.h"
+#include "SyncPreamble.h"
+
+// ============================================================================
+// TSCH RADIO BINDING
+// ============================================================================
+//
+// Retunes the radio for a cell at the start of its slot. The channel's PLL
+// steps come precomputed from the FreqPlan, so the hop is a single
+// SetRfFrequency (sx126x_set_rf_freq_in_pll_steps) unless it crosses an
+// image-calibration band. A cell with its own SF (SF division) also gets
+// its modulation parameters rewritten. The cell also becomes the header
+// compression context (SnipsHcRadio).
+//
+// With synchronized wake on, the TX preamble of each slot is sized from the
+// Sync-phase clock uncertainty (SyncPreamble.h) at the cell's SF, and
+// TschRadio_rxTimeoutMs gives the matching listen window (the RX timer
+// then stops on preamble detection). The Sync phase reports every beacon,
+// or its absence, through TschRadio_onSync / TschRadio_onSyncMissed; until
+// the first one, and after missed beacons, slots use the configured long
+// preamble.
+//
+// The short preamble and a cell's own SF only suit the slot-synchronized
+// peer of the cell. TschRadio_leaveCell must end every cell, before the
+// node sends anything else (Sync, Control, Emergency, Trickle, CAD
+// traffic), so that goes out on the configured preamble and SF.
+//
+
+// Hops to the cell's channel for this asn. The FreqPlan must hold the TSCH
+// channel list in channel-index order.
+bool TschRadio_enterCell(uint32_t asn, const TschCell* cell);
+
+// Ends the cell entered last: restores the configured preamble and SF and
+// clears the header compression cell. The channel is left as it is.
+bool TschRadio_leaveCell();
+
+// Enabling starts unsynchronized, on the long preamble.
+bool TschRadio_setSyncedWake(bool enabled);
+
+// Sync beacon at nowMs moved the slot clock by correctionUs.
+void TschRadio_onSync(uint32_t nowMs, int32_t correctionUs);
+void TschRadio_onSyncMissed();
+
+// RX timeout for the slot entered last, 0 to listen the whole slot.
+uint32_t TschRadio_rxTimeoutMs();
+
+// Preamble of the slot entered last.
+uint16_t TschRadio_preambleSymbols();
+
+void TschRadio_getSyncStats(SyncPreambleStats* stats);